@@ -17,6 +17,7 @@
 #include "zylib_allocator_def.h"
 #include "zylib_def.h"
 #include <stddef.h>
+#include <stdint.h>
 
 /**
  * Allocator Data Structure
@@ -37,6 +38,20 @@ ZYLIB_NONNULL
 _Bool zylib_private_allocator_construct(zylib_private_allocator_t **obj, zylib_allocator_malloc_t malloc,
                                         zylib_allocator_realloc_t realloc, zylib_allocator_free_t free);
 
+/**
+ * Construct an allocator object that dispatches to a function table operating on a context
+ * @param obj The object to construct
+ * @param parent The allocator object from which obj is allocated; if null, obj is allocated from vtable
+ * @param vtable The function table; must outlive obj
+ * @param context The context passed to every function in vtable
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL_N(1)
+ZYLIB_NONNULL_N(3)
+_Bool zylib_private_allocator_construct_context(zylib_private_allocator_t **obj,
+                                                const zylib_private_allocator_t *parent,
+                                                const zylib_allocator_vtable_t *vtable, void *context);
+
 /**
  * Deconstruct an allocator object
  * @param obj The object to deconstruct
@@ -54,6 +69,16 @@ void zylib_private_allocator_destruct(zylib_private_allocator_t **obj);
 ZYLIB_NONNULL
 _Bool zylib_private_allocator_malloc(const zylib_private_allocator_t *obj, size_t size, void **ptr);
 
+/**
+ * Allocate a zero-filled memory region
+ * @param obj The allocator object
+ * @param size The size of the region to allocate
+ * @param ptr The pointer to the address of the memory region
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_allocator_calloc(const zylib_private_allocator_t *obj, size_t size, void **ptr);
+
 /**
  * Resize an allocated memory region
  * @param obj The allocator object
@@ -64,6 +89,18 @@ _Bool zylib_private_allocator_malloc(const zylib_private_allocator_t *obj, size_
 ZYLIB_NONNULL
 _Bool zylib_private_allocator_realloc(const zylib_private_allocator_t *obj, size_t size, void **ptr);
 
+/**
+ * Resize an allocated memory region whose size is known
+ * @param obj The allocator object
+ * @param old_size The current size of the memory region
+ * @param size The new size of the memory region
+ * @param ptr The pointer to the address of the memory region
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_allocator_realloc_sized(const zylib_private_allocator_t *obj, size_t old_size, size_t size,
+                                            void **ptr);
+
 /**
  * Deallocate a memory region
  * @param obj The allocator object
@@ -72,4 +109,68 @@ _Bool zylib_private_allocator_realloc(const zylib_private_allocator_t *obj, size
 ZYLIB_NONNULL
 void zylib_private_allocator_free(const zylib_private_allocator_t *obj, void **ptr);
 
+/**
+ * Deallocate a memory region whose size is known
+ * @param obj The allocator object
+ * @param size The size of the memory region
+ * @param ptr The pointer to the memory region
+ */
+ZYLIB_NONNULL
+void zylib_private_allocator_free_sized(const zylib_private_allocator_t *obj, size_t size, void **ptr);
+
+/**
+ * Allocate a memory region whose address is a multiple of alignment
+ * @param obj The allocator object
+ * @param alignment The alignment of the region; a power of two
+ * @param size The size of the region to allocate
+ * @param ptr The pointer to the address of the memory region
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_allocator_aligned_malloc(const zylib_private_allocator_t *obj, size_t alignment, size_t size,
+                                             void **ptr);
+
+/**
+ * Deallocate a memory region allocated by zylib_private_allocator_aligned_malloc()
+ * @param obj The allocator object
+ * @param alignment The alignment of the memory region
+ * @param size The size of the memory region, or zero if unknown
+ * @param ptr The pointer to the memory region
+ */
+ZYLIB_NONNULL
+void zylib_private_allocator_aligned_free(const zylib_private_allocator_t *obj, size_t alignment, size_t size,
+                                          void **ptr);
+
+/**
+ * Retrieve the function table of an allocator object
+ * @param obj The allocator object
+ * @return The function table
+ */
+ZYLIB_NONNULL
+const zylib_allocator_vtable_t *zylib_private_allocator_peek_vtable(const zylib_private_allocator_t *obj);
+
+/**
+ * Retrieve the context of an allocator object
+ * @param obj The allocator object
+ * @return The context
+ */
+ZYLIB_NONNULL
+void *zylib_private_allocator_peek_context(const zylib_private_allocator_t *obj);
+
+/**
+ * Return the whole pages spanned by a memory region to the operating system; the region remains usable, but the
+ * contents of those pages are lost. Without operating system support, this is a no-op.
+ * @param ptr The memory region
+ * @param size The size of the memory region
+ * @return The number of bytes returned
+ */
+ZYLIB_NONNULL
+size_t zylib_private_allocator_discard(void *ptr, size_t size);
+
+/**
+ * Read a clock for decay purposes
+ * @return The time in milliseconds
+ */
+uint64_t zylib_private_allocator_clock(void);
+
 ZYLIB_END_DECLS
@@ -0,0 +1,70 @@
+/*
+ * Copyright 2023 Alexandre Fernandez <alex@fernandezfamily.email>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#include "zylib_private_allocator.h"
+
+ZYLIB_BEGIN_DECLS
+
+/**
+ * Construct an arena allocator object.
+ * Memory is handed out from blocks of block_size bytes by advancing a cursor; free is a no-op unless it targets the
+ * most recent allocation, and every allocation is reclaimed at once by zylib_private_arena_reset().
+ * @param obj The object to construct
+ * @param block_size The size of each block
+ * @param parent The allocator object from which obj and its blocks are allocated
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_arena_construct(zylib_private_allocator_t **obj, size_t block_size,
+                                    const zylib_private_allocator_t *parent);
+
+/**
+ * Reclaim every memory region allocated from an arena allocator object; blocks are retained for reuse
+ * @param obj The arena allocator object
+ * @return True if and only if obj is an arena allocator object
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_arena_reset(zylib_private_allocator_t *obj);
+
+/**
+ * Return the blocks past the current one to the parent allocator object, and the unused pages of the current one to
+ * the operating system
+ * @param obj The arena allocator object
+ * @return True if and only if obj is an arena allocator object
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_arena_trim(zylib_private_allocator_t *obj);
+
+/**
+ * Set the decay period of an arena allocator object: on reset, blocks that went unused for a whole period are
+ * returned to the parent allocator object
+ * @param obj The arena allocator object
+ * @param decay The decay period in milliseconds, or 0 to retain every block
+ * @return True if and only if obj is an arena allocator object
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_arena_set_decay(zylib_private_allocator_t *obj, uint64_t decay);
+
+/**
+ * Retrieve the decay period of an arena allocator object
+ * @param obj The arena allocator object
+ * @param decay The pointer to the decay period in milliseconds, or 0 if every block is retained
+ * @return True if and only if obj is an arena allocator object
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_arena_peek_decay(const zylib_private_allocator_t *obj, uint64_t *decay);
+
+ZYLIB_END_DECLS
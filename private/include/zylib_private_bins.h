@@ -0,0 +1,139 @@
+/*
+ * Copyright 2023 Alexandre Fernandez <alex@fernandezfamily.email>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#include "zylib_private_allocator.h"
+#include <threads.h>
+
+/* Size classes are the powers of two from 16 through 1024 bytes */
+#define ZYLIB_PRIVATE_BINS_MIN_SHIFT (4U)
+#define ZYLIB_PRIVATE_BINS_CLASS_N (7U)
+#define ZYLIB_PRIVATE_BINS_MAX_SIZE ((size_t)1 << (ZYLIB_PRIVATE_BINS_MIN_SHIFT + 6U))
+
+/* Blocks move between bins and the parent allocator object this many at a time */
+#define ZYLIB_PRIVATE_BINS_BATCH (16U)
+
+/**
+ * Block Data Structure
+ * The header of every memory region served by an allocator object that caches blocks in bins.
+ */
+typedef struct zylib_private_bins_block_s
+{
+    union {
+        /* While allocated: the owner of the block, for allocator objects that track one */
+        void *owner;
+        /* While cached: the next block in the same free list */
+        struct zylib_private_bins_block_s *next;
+    };
+    /* The size of the size class, or the requested size of a block larger than every size class */
+    size_t size;
+    max_align_t data[];
+} zylib_private_bins_block_t;
+
+/**
+ * Bins Data Structure
+ * One free list of cached blocks per size class. Bins are embedded in the objects that own them, which pop from and
+ * push to the free lists directly.
+ */
+typedef struct zylib_private_bins_s
+{
+    zylib_private_bins_block_t *heads[ZYLIB_PRIVATE_BINS_CLASS_N];
+    size_t count[ZYLIB_PRIVATE_BINS_CLASS_N];
+} zylib_private_bins_t;
+
+ZYLIB_BEGIN_DECLS
+
+/**
+ * Retrieve the size class of a size of up to ZYLIB_PRIVATE_BINS_MAX_SIZE bytes
+ * @param size The size
+ * @return The size class
+ */
+size_t zylib_private_bins_class(size_t size);
+
+/**
+ * Retrieve the block of a memory region
+ * @param ptr The memory region
+ * @return The block
+ */
+ZYLIB_NONNULL
+zylib_private_bins_block_t *zylib_private_bins_header(void *ptr);
+
+/**
+ * Allocate a batch of blocks of a size class from the parent allocator object into a bin
+ * @param obj The bins object
+ * @param parent The parent allocator object
+ * @param lock The lock that serializes calls into the parent allocator object
+ * @param c The size class
+ * @return True if and only if the bin is not empty
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_bins_refill(zylib_private_bins_t *obj, const zylib_private_allocator_t *parent, mtx_t *lock,
+                               size_t c);
+
+/**
+ * Return up to n blocks of a bin to the parent allocator object
+ * @param obj The bins object
+ * @param parent The parent allocator object
+ * @param lock The lock that serializes calls into the parent allocator object
+ * @param c The size class
+ * @param n The number of blocks
+ */
+ZYLIB_NONNULL
+void zylib_private_bins_flush(zylib_private_bins_t *obj, const zylib_private_allocator_t *parent, mtx_t *lock,
+                              size_t c, size_t n);
+
+/**
+ * Return every block of every bin to the parent allocator object; the caller serializes calls into it
+ * @param obj The bins object
+ * @param parent The parent allocator object
+ */
+ZYLIB_NONNULL
+void zylib_private_bins_empty(zylib_private_bins_t *obj, const zylib_private_allocator_t *parent);
+
+/**
+ * Return a block to the parent allocator object; the caller serializes calls into it
+ * @param parent The parent allocator object
+ * @param block The block
+ */
+ZYLIB_NONNULL
+void zylib_private_bins_release(const zylib_private_allocator_t *parent, zylib_private_bins_block_t *block);
+
+/**
+ * Allocate a block larger than every size class from the parent allocator object
+ * @param parent The parent allocator object
+ * @param lock The lock that serializes calls into the parent allocator object
+ * @param size The size of the memory region
+ * @return The memory region, or NULL if the operation failed
+ */
+ZYLIB_NONNULL
+void *zylib_private_bins_malloc_large(const zylib_private_allocator_t *parent, mtx_t *lock, size_t size);
+
+/**
+ * Reallocate a memory region served by an allocator object that caches blocks in bins: it is kept if its size class
+ * still fits, resized by the parent allocator object if it stays larger than every size class, and moved through the
+ * function table of the allocator object otherwise
+ * @param vtable The function table of the allocator object
+ * @param context The context of the allocator object
+ * @param parent The parent allocator object
+ * @param lock The lock that serializes calls into the parent allocator object
+ * @param ptr The memory region
+ * @param size The new size of the memory region
+ * @return The memory region, or NULL if the operation failed
+ */
+ZYLIB_NONNULL
+void *zylib_private_bins_realloc(const zylib_allocator_vtable_t *vtable, void *context,
+                                 const zylib_private_allocator_t *parent, mtx_t *lock, void *ptr, size_t size);
+
+ZYLIB_END_DECLS
@@ -15,13 +15,28 @@
  */
 #pragma once
 #include "zylib_private_allocator.h"
+#include "zylib_private_pool.h"
 #include <stdint.h>
 
 /**
- * Box Data Structure
+ * Box Data Structure.
+ * The header and the memory region share a single allocation.
  */
 typedef struct zylib_private_box_s zylib_private_box_t;
 
+/**
+ * The size of the largest memory region that a pooled box stores in a pool object
+ */
+#define ZYLIB_PRIVATE_BOX_POOL_CAPACITY (64U)
+
+/**
+ * The size of the largest memory region that a container stores inline, next to its links, instead of in a box;
+ * it can be overridden when building the library and must be positive
+ */
+#if !defined(ZYLIB_BOX_INLINE_CAPACITY)
+#define ZYLIB_BOX_INLINE_CAPACITY (32U)
+#endif
+
 ZYLIB_BEGIN_DECLS
 
 /**
@@ -36,6 +51,41 @@ ZYLIB_NONNULL
 _Bool zylib_private_box_construct(zylib_private_box_t **obj, const zylib_private_allocator_t *allocator, uint64_t size,
                                   const void *ptr);
 
+/**
+ * Construct a box object that takes ownership of a memory region instead of copying it
+ * @param obj The object to construct
+ * @param allocator The allocator object from which the memory region was allocated
+ * @param size The size of the memory region
+ * @param ptr The pointer to the address of the memory region; set to NULL on success
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_box_adopt(zylib_private_box_t **obj, const zylib_private_allocator_t *allocator, uint64_t size,
+                              void **ptr);
+
+/**
+ * Construct a box object that is allocated from a pool object when its memory region is no larger than
+ * ZYLIB_PRIVATE_BOX_POOL_CAPACITY, and from allocator otherwise
+ * @param obj The object to construct
+ * @param pool The pool object; see zylib_private_box_construct_pool()
+ * @param allocator The allocator object from which larger boxes are allocated
+ * @param size The size of the memory region
+ * @param ptr The address of the memory region to copy
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_box_construct_pooled(zylib_private_box_t **obj, zylib_private_pool_t *pool,
+                                         const zylib_private_allocator_t *allocator, uint64_t size, const void *ptr);
+
+/**
+ * Construct a pool object whose objects can hold boxes of up to ZYLIB_PRIVATE_BOX_POOL_CAPACITY bytes
+ * @param pool The pool object to construct
+ * @param allocator The allocator object
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_box_construct_pool(zylib_private_pool_t **pool, const zylib_private_allocator_t *allocator);
+
 /**
  * Deconstruct a box object
  * @param obj The object to deconstruct
@@ -44,14 +94,26 @@ ZYLIB_NONNULL
 void zylib_private_box_destruct(zylib_private_box_t **obj);
 
 /**
- * Append a memory region to a box object
- * @param obj The box object
+ * Deconstruct a box object, handing its memory region back to the caller instead of deallocating it.
+ * An adopted memory region is handed back as is; otherwise it is copied into a region allocated from the allocator
+ * object of obj, and obj is left untouched on failure.
+ * @param obj The object to deconstruct
+ * @param size The pointer to the size of the memory region
+ * @param ptr The pointer to the address of the memory region, to be deallocated by the caller
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_box_release(zylib_private_box_t **obj, uint64_t *size, void **ptr);
+
+/**
+ * Append a memory region to a box object; the box object may move
+ * @param obj The pointer to the box object
  * @param size The size of the memory region
  * @param ptr The address of the memory region to copy
  * @return True if and only if the operation was successful
  */
 ZYLIB_NONNULL
-_Bool zylib_private_box_append(zylib_private_box_t *obj, uint64_t size, const void *ptr);
+_Bool zylib_private_box_append(zylib_private_box_t **obj, uint64_t size, const void *ptr);
 
 /**
  * Retrieve the memory region denoted that begins at index
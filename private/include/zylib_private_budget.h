@@ -0,0 +1,40 @@
+/*
+ * Copyright 2023 Alexandre Fernandez <alex@fernandezfamily.email>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#include "zylib_private_allocator.h"
+
+ZYLIB_BEGIN_DECLS
+
+/**
+ * Construct a budget allocator object.
+ * Every request is forwarded to the parent allocator object, provided the bytes allocated through obj stay within
+ * hard_limit. Threads reserve budget in batches of up to 1/64th of hard_limit, so the shared usage counter is only
+ * updated once per batch.
+ * @param obj The object to construct
+ * @param soft_limit The usage at which pressure is invoked
+ * @param hard_limit The usage beyond which allocations fail
+ * @param pressure The function invoked when the usage reaches soft_limit, or NULL
+ * @param context The argument passed to pressure
+ * @param parent The allocator object from which obj and every memory region are allocated
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL_N(1)
+ZYLIB_NONNULL_N(6)
+_Bool zylib_private_budget_construct(zylib_private_allocator_t **obj, size_t soft_limit, size_t hard_limit,
+                                     zylib_allocator_pressure_t pressure, void *context,
+                                     const zylib_private_allocator_t *parent);
+
+ZYLIB_END_DECLS
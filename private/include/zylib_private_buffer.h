@@ -0,0 +1,126 @@
+/*
+ * Copyright 2023 Alexandre Fernandez <alex@fernandezfamily.email>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#include "zylib_private_allocator.h"
+#include <stdarg.h>
+#include <stddef.h>
+
+/**
+ * Buffer Data Structure
+ */
+typedef struct zylib_private_buffer_s zylib_private_buffer_t;
+
+ZYLIB_BEGIN_DECLS
+
+/**
+ * Construct a buffer object.
+ * The memory region grows geometrically, so appending is amortized constant time.
+ * @param obj The object to construct
+ * @param allocator The allocator object
+ * @param capacity The initial capacity, which may be 0
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_buffer_construct(zylib_private_buffer_t **obj, const zylib_private_allocator_t *allocator,
+                                     size_t capacity);
+
+/**
+ * Deconstruct a buffer object
+ * @param obj The object to deconstruct
+ */
+ZYLIB_NONNULL
+void zylib_private_buffer_destruct(zylib_private_buffer_t **obj);
+
+/**
+ * Grow the capacity of a buffer object to at least capacity bytes
+ * @param obj The buffer object
+ * @param capacity The capacity
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_buffer_reserve(zylib_private_buffer_t *obj, size_t capacity);
+
+/**
+ * Shrink the capacity of a buffer object to its size
+ * @param obj The buffer object
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_buffer_shrink_to_fit(zylib_private_buffer_t *obj);
+
+/**
+ * Append a memory region to a buffer object
+ * @param obj The buffer object
+ * @param size The size of the memory region
+ * @param ptr The address of the memory region to copy
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_buffer_append(zylib_private_buffer_t *obj, size_t size, const void *ptr);
+
+/**
+ * Append formatted text to a buffer object; the terminating null character is written past the size of obj
+ * @param obj The buffer object
+ * @param format The format string
+ * @param args The arguments of the format string
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_buffer_append_vformat(zylib_private_buffer_t *obj, const char *format, va_list args);
+
+/**
+ * Empty a buffer object, retaining its capacity
+ * @param obj The buffer object
+ */
+ZYLIB_NONNULL
+void zylib_private_buffer_clear(zylib_private_buffer_t *obj);
+
+/**
+ * Hand the memory region of a non-empty buffer object back to the caller, leaving obj empty.
+ * The memory region is shrunk to its size first, so it can be adopted by a dequeue object.
+ * @param obj The buffer object
+ * @param size The pointer to the size of the memory region
+ * @param ptr The pointer to the address of the memory region, to be deallocated by the caller
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_buffer_detach(zylib_private_buffer_t *obj, size_t *size, void **ptr);
+
+/**
+ * Retrieve the size of a buffer object
+ * @param obj The buffer object
+ * @return The size of the memory region
+ */
+ZYLIB_NONNULL
+size_t zylib_private_buffer_peek_size(const zylib_private_buffer_t *obj);
+
+/**
+ * Retrieve the capacity of a buffer object
+ * @param obj The buffer object
+ * @return The capacity of the memory region
+ */
+ZYLIB_NONNULL
+size_t zylib_private_buffer_peek_capacity(const zylib_private_buffer_t *obj);
+
+/**
+ * Retrieve the memory region of a buffer object; it is invalidated by any operation that grows or shrinks obj
+ * @param obj The buffer object
+ * @return The address of the memory region, or NULL if obj has no capacity
+ */
+ZYLIB_NONNULL
+void *zylib_private_buffer_peek_data(const zylib_private_buffer_t *obj);
+
+ZYLIB_END_DECLS
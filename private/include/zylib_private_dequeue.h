@@ -14,7 +14,10 @@
  * limitations under the License.
  */
 #pragma once
+#include "zylib_dequeue_def.h"
 #include "zylib_private_allocator.h"
+#include "zylib_private_rope.h"
+#include "zylib_private_shared_box.h"
 #include <stdint.h>
 
 /**
@@ -33,6 +36,45 @@ ZYLIB_BEGIN_DECLS
 ZYLIB_NONNULL
 _Bool zylib_private_dequeue_construct(zylib_private_dequeue_t **obj, const zylib_private_allocator_t *allocator);
 
+/**
+ * Construct a dequeue object whose nodes are allocated from pool objects
+ * @param obj The object to construct
+ * @param allocator The allocator object
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_dequeue_construct_pooled(zylib_private_dequeue_t **obj, const zylib_private_allocator_t *allocator);
+
+/**
+ * Construct a dequeue object whose nodes are stored in a ring of fixed-size blocks
+ * @param obj The object to construct
+ * @param allocator The allocator object
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_dequeue_construct_blocked(zylib_private_dequeue_t **obj,
+                                              const zylib_private_allocator_t *allocator);
+
+/**
+ * Construct a dequeue object whose memory regions are copied back-to-back into chunks
+ * @param obj The object to construct
+ * @param allocator The allocator object
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_dequeue_construct_packed(zylib_private_dequeue_t **obj, const zylib_private_allocator_t *allocator);
+
+/**
+ * Construct a dequeue object whose memory regions all have the same size, copied into a ring buffer
+ * @param obj The object to construct
+ * @param allocator The allocator object
+ * @param element_size The size of every memory region
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_dequeue_construct_fixed(zylib_private_dequeue_t **obj, const zylib_private_allocator_t *allocator,
+                                            uint64_t element_size);
+
 /**
  * Deconstruct a dequeue object
  * @param obj The object to deconstruct
@@ -67,6 +109,108 @@ _Bool zylib_private_dequeue_push_first(zylib_private_dequeue_t *obj, uint64_t si
 ZYLIB_NONNULL
 _Bool zylib_private_dequeue_push_last(zylib_private_dequeue_t *obj, uint64_t size, const void *data);
 
+/**
+ * Insert n nodes at the beginning of a fixed-size dequeue
+ * @param obj The dequeue object
+ * @param n The number of nodes
+ * @param data The memory regions
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_dequeue_push_n_first(zylib_private_dequeue_t *obj, uint64_t n, const void *data);
+
+/**
+ * Insert n nodes at the end of a fixed-size dequeue
+ * @param obj The dequeue object
+ * @param n The number of nodes
+ * @param data The memory regions
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_dequeue_push_n_last(zylib_private_dequeue_t *obj, uint64_t n, const void *data);
+
+/**
+ * Insert a node at the beginning of a dequeue that takes ownership of a memory region instead of copying it
+ * @param obj The dequeue object
+ * @param size The size of the memory region
+ * @param data The pointer to the memory region, which must have been allocated from the allocator object of obj; set
+ * to NULL on success
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_dequeue_adopt_first(zylib_private_dequeue_t *obj, uint64_t size, void **data);
+
+/**
+ * Insert a node at the end of a dequeue that takes ownership of a memory region instead of copying it
+ * @param obj The dequeue object
+ * @param size The size of the memory region
+ * @param data The pointer to the memory region, which must have been allocated from the allocator object of obj; set
+ * to NULL on success
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_dequeue_adopt_last(zylib_private_dequeue_t *obj, uint64_t size, void **data);
+
+/**
+ * Insert a node at the beginning of a dequeue that acquires a reference to a shared box instead of copying its
+ * memory region; the reference is released when the node is deconstructed
+ * @param obj The dequeue object
+ * @param box The shared box object
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_dequeue_push_shared_first(zylib_private_dequeue_t *obj, zylib_private_shared_box_t *box);
+
+/**
+ * Insert a node at the end of a dequeue that acquires a reference to a shared box instead of copying its memory
+ * region; the reference is released when the node is deconstructed
+ * @param obj The dequeue object
+ * @param box The shared box object
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_dequeue_push_shared_last(zylib_private_dequeue_t *obj, zylib_private_shared_box_t *box);
+
+/**
+ * Insert a node at the beginning of a dequeue that takes ownership of a non-empty rope instead of copying it; the rope
+ * is flattened into a single segment on insertion, so that retrieving its node never modifies nor allocates
+ * @param obj The dequeue object
+ * @param rope The pointer to the rope object, which must share the allocator object of obj; set to NULL on success
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_dequeue_push_rope_first(zylib_private_dequeue_t *obj, zylib_private_rope_t **rope);
+
+/**
+ * Insert a node at the end of a dequeue that takes ownership of a non-empty rope instead of copying it; the rope is
+ * flattened into a single segment on insertion, so that retrieving its node never modifies nor allocates
+ * @param obj The dequeue object
+ * @param rope The pointer to the rope object, which must share the allocator object of obj; set to NULL on success
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_dequeue_push_rope_last(zylib_private_dequeue_t *obj, zylib_private_rope_t **rope);
+
+/**
+ * Copy the memory regions of the n nodes at the beginning of a fixed-size dequeue, then remove them
+ * @param obj The dequeue object
+ * @param n The number of nodes
+ * @param data The memory region receiving the memory regions of the nodes
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_dequeue_pop_n_first(zylib_private_dequeue_t *obj, uint64_t n, void *data);
+
+/**
+ * Copy the memory regions of the n nodes at the end of a fixed-size dequeue, then remove them
+ * @param obj The dequeue object
+ * @param n The number of nodes
+ * @param data The memory region receiving the memory regions of the nodes
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_dequeue_pop_n_last(zylib_private_dequeue_t *obj, uint64_t n, void *data);
+
 /**
  * Deconstruct the node at the beginning of a dequeue
  * @param obj The dequeue object
@@ -81,6 +225,46 @@ void zylib_private_dequeue_discard_first(zylib_private_dequeue_t *obj);
 ZYLIB_NONNULL
 void zylib_private_dequeue_discard_last(zylib_private_dequeue_t *obj);
 
+/**
+ * Deconstruct the node at the beginning of a dequeue, handing its memory region back to the caller.
+ * An adopted memory region is handed back without being copied; the memory region of a shared box is copied.
+ * @param obj The dequeue object
+ * @param size The pointer to the size of the memory region
+ * @param data The pointer to the memory region, to be deallocated with the allocator object of obj
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_dequeue_release_first(zylib_private_dequeue_t *obj, uint64_t *size, void **data);
+
+/**
+ * Deconstruct the node at the end of a dequeue, handing its memory region back to the caller.
+ * An adopted memory region is handed back without being copied; the memory region of a shared box is copied.
+ * @param obj The dequeue object
+ * @param size The pointer to the size of the memory region
+ * @param data The pointer to the memory region, to be deallocated with the allocator object of obj
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_dequeue_release_last(zylib_private_dequeue_t *obj, uint64_t *size, void **data);
+
+/**
+ * Retrieve the rope stored by the node at the beginning of a dequeue, which remains owned by the dequeue
+ * @param obj The dequeue object
+ * @param rope The pointer to the rope object
+ * @return True if and only if the node exists and stores a rope
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_dequeue_peek_rope_first(const zylib_private_dequeue_t *obj, const zylib_private_rope_t **rope);
+
+/**
+ * Retrieve the rope stored by the node at the end of a dequeue, which remains owned by the dequeue
+ * @param obj The dequeue object
+ * @param rope The pointer to the rope object
+ * @return True if and only if the node exists and stores a rope
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_dequeue_peek_rope_last(const zylib_private_dequeue_t *obj, const zylib_private_rope_t **rope);
+
 /**
  * Retrieve the node at the beginning of a dequeue
  * @param obj The dequeue object
@@ -101,6 +285,61 @@ _Bool zylib_private_dequeue_peek_first(const zylib_private_dequeue_t *obj, uint6
 ZYLIB_NONNULL
 _Bool zylib_private_dequeue_peek_last(const zylib_private_dequeue_t *obj, uint64_t *size, const void **data);
 
+/**
+ * Retrieve the node at an index of a dequeue
+ * @param obj The dequeue object
+ * @param index The index of the node
+ * @param size The pointer to the size of the memory region
+ * @param data The pointer to the memory region
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_dequeue_at(const zylib_private_dequeue_t *obj, uint64_t index, uint64_t *size, const void **data);
+
+/**
+ * Position a cursor at the first node of a dequeue
+ * @param obj The dequeue object
+ * @param cursor The cursor
+ * @return True if and only if the dequeue is not empty
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_dequeue_cursor_first(const zylib_private_dequeue_t *obj, zylib_dequeue_cursor_t *cursor);
+
+/**
+ * Position a cursor at the last node of a dequeue
+ * @param obj The dequeue object
+ * @param cursor The cursor
+ * @return True if and only if the dequeue is not empty
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_dequeue_cursor_last(const zylib_private_dequeue_t *obj, zylib_dequeue_cursor_t *cursor);
+
+/**
+ * Move a cursor to the next node of its dequeue
+ * @param cursor The cursor
+ * @return True if and only if there was a next node
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_dequeue_cursor_next(zylib_dequeue_cursor_t *cursor);
+
+/**
+ * Move a cursor to the previous node of its dequeue
+ * @param cursor The cursor
+ * @return True if and only if there was a previous node
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_dequeue_cursor_prev(zylib_dequeue_cursor_t *cursor);
+
+/**
+ * Retrieve the node at the position of a cursor
+ * @param cursor The cursor
+ * @param size The pointer to the size of the memory region
+ * @param data The pointer to the memory region
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_dequeue_cursor_get(const zylib_dequeue_cursor_t *cursor, uint64_t *size, const void **data);
+
 /**
  * Retrieve the number of nodes stored within a dequeue
  * @param obj The dequeue object
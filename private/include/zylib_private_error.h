@@ -15,6 +15,7 @@
  */
 #pragma once
 #include "zylib_private_allocator.h"
+#include "zylib_private_rope.h"
 #include <stdint.h>
 
 /**
@@ -88,6 +89,40 @@ _Bool zylib_private_error_push_last(zylib_private_error_t *obj, int64_t error_co
                                     uint64_t line_number, const char *function_name, uint64_t auxiliary_size,
                                     const void *auxiliary_data);
 
+/**
+ * Insert an error container at the beginning of an error dequeue whose auxiliary data is a rope.
+ * The rope is moved into the error container and flattened once, when it is inserted.
+ * @param obj The error dequeue object
+ * @param error_code The error code
+ * @param file_name The file name string literal
+ * @param line_number The line number
+ * @param function_name The function name string literal
+ * @param auxiliary The pointer to the rope object, which must share the allocator object of obj; it is deconstructed
+ * and set to NULL whether or not the operation is successful
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_error_push_rope_first(zylib_private_error_t *obj, int64_t error_code, const char *file_name,
+                                          uint64_t line_number, const char *function_name,
+                                          zylib_private_rope_t **auxiliary);
+
+/**
+ * Insert an error container at the end of an error dequeue whose auxiliary data is a rope.
+ * The rope is moved into the error container and flattened once, when it is inserted.
+ * @param obj The error dequeue object
+ * @param error_code The error code
+ * @param file_name The file name string literal
+ * @param line_number The line number
+ * @param function_name The function name string literal
+ * @param auxiliary The pointer to the rope object, which must share the allocator object of obj; it is deconstructed
+ * and set to NULL whether or not the operation is successful
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_error_push_rope_last(zylib_private_error_t *obj, int64_t error_code, const char *file_name,
+                                         uint64_t line_number, const char *function_name,
+                                         zylib_private_rope_t **auxiliary);
+
 /**
  * Deconstruct the error container at the beginning of an error dequeue
  * @param obj The error dequeue object
@@ -0,0 +1,36 @@
+/*
+ * Copyright 2023 Alexandre Fernandez <alex@fernandezfamily.email>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#include "zylib_private_allocator.h"
+
+ZYLIB_BEGIN_DECLS
+
+/**
+ * Construct a memory mapping allocator object.
+ * Memory regions of at least threshold bytes are mapped directly from the operating system; smaller ones are
+ * allocated from the parent allocator object. Without memory mapping support, every region is allocated from the
+ * parent allocator object.
+ * @param obj The object to construct
+ * @param threshold The size from which memory regions are mapped
+ * @param flags A combination of zylib_allocator_mmap_flags_t
+ * @param parent The allocator object from which obj and every smaller memory region are allocated
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_mmap_construct(zylib_private_allocator_t **obj, size_t threshold, unsigned flags,
+                                   const zylib_private_allocator_t *parent);
+
+ZYLIB_END_DECLS
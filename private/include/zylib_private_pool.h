@@ -0,0 +1,97 @@
+/*
+ * Copyright 2023 Alexandre Fernandez <alex@fernandezfamily.email>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#include "zylib_private_allocator.h"
+
+/**
+ * Pool Data Structure
+ */
+typedef struct zylib_private_pool_s zylib_private_pool_t;
+
+ZYLIB_BEGIN_DECLS
+
+/**
+ * Construct a pool object.
+ * Objects of a fixed size are served from page-sized slabs, which count their allocated objects; freed objects are
+ * kept on an intrusive free list.
+ * @param obj The object to construct
+ * @param allocator The allocator object from which obj and its slabs are allocated
+ * @param size The size of each object
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_pool_construct(zylib_private_pool_t **obj, const zylib_private_allocator_t *allocator,
+                                   size_t size);
+
+/**
+ * Deconstruct a pool object, along with every object allocated from it
+ * @param obj The object to deconstruct
+ */
+ZYLIB_NONNULL
+void zylib_private_pool_destruct(zylib_private_pool_t **obj);
+
+/**
+ * Allocate an object
+ * @param obj The pool object
+ * @param ptr The pointer to the address of the object
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_pool_malloc(zylib_private_pool_t *obj, void **ptr);
+
+/**
+ * Deallocate an object
+ * @param obj The pool object
+ * @param ptr The pointer to the object
+ */
+ZYLIB_NONNULL
+void zylib_private_pool_free(zylib_private_pool_t *obj, void **ptr);
+
+/**
+ * Deallocate an object from a thread other than the one that owns the pool object.
+ * The object is pushed onto a lock-free list, and reclaimed by the owner on a later allocation.
+ * @param obj The pool object
+ * @param ptr The pointer to the object
+ */
+ZYLIB_NONNULL
+void zylib_private_pool_free_remote(zylib_private_pool_t *obj, void **ptr);
+
+/**
+ * Retrieve the size of the objects served by a pool object
+ * @param obj The pool object
+ * @return The object size
+ */
+ZYLIB_NONNULL
+size_t zylib_private_pool_peek_size(const zylib_private_pool_t *obj);
+
+/**
+ * Return every empty slab of a pool object to its allocator object; objects freed remotely are reclaimed first
+ * @param obj The pool object
+ * @return True if and only if no object was allocated
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_pool_trim(zylib_private_pool_t *obj);
+
+/**
+ * Set the decay period of a pool object: slabs that stay empty for a whole period are returned to its allocator
+ * object. Until set, the decay period is that of the allocator object if it is an arena or size-class allocator object.
+ * @param obj The pool object
+ * @param decay The decay period in milliseconds, or 0 to retain every slab
+ */
+ZYLIB_NONNULL
+void zylib_private_pool_set_decay(zylib_private_pool_t *obj, uint64_t decay);
+
+ZYLIB_END_DECLS
@@ -0,0 +1,44 @@
+/*
+ * Copyright 2023 Alexandre Fernandez <alex@fernandezfamily.email>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#include "zylib_private_allocator.h"
+#include <stdio.h>
+
+ZYLIB_BEGIN_DECLS
+
+/**
+ * Construct a sampling heap profiler allocator object.
+ * Every request is forwarded to the parent allocator object; on average one allocation per sample_rate bytes records
+ * the call stack that made it, until the memory region is freed.
+ * @param obj The object to construct
+ * @param sample_rate The mean number of bytes allocated between two samples, or 0 to sample every allocation
+ * @param parent The allocator object from which obj and every memory region are allocated
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_profiler_construct(zylib_private_allocator_t **obj, size_t sample_rate,
+                                       const zylib_private_allocator_t *parent);
+
+/**
+ * Write the live samples of a sampling heap profiler allocator object in folded stack format.
+ * @param obj The sampling heap profiler allocator object
+ * @param stream The stream
+ * @return True if and only if obj is a sampling heap profiler allocator object and the stream was written
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_profiler_dump(const zylib_private_allocator_t *obj, FILE *stream);
+
+ZYLIB_END_DECLS
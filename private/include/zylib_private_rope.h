@@ -0,0 +1,111 @@
+/*
+ * Copyright 2023 Alexandre Fernandez <alex@fernandezfamily.email>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#include "zylib_private_allocator.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Rope Data Structure.
+ * A memory region stored as a chain of chunks, so that appending never copies what is already stored.
+ */
+typedef struct zylib_private_rope_s zylib_private_rope_t;
+
+/**
+ * The default size of a chunk
+ */
+#define ZYLIB_PRIVATE_ROPE_CHUNK_SIZE ((size_t)64 * 1024)
+
+ZYLIB_BEGIN_DECLS
+
+/**
+ * Construct an empty rope object
+ * @param obj The object to construct
+ * @param allocator The allocator object from which obj and its chunks are allocated
+ * @param chunk_size The size of each chunk, or 0 for ZYLIB_PRIVATE_ROPE_CHUNK_SIZE
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_rope_construct(zylib_private_rope_t **obj, const zylib_private_allocator_t *allocator,
+                                   size_t chunk_size);
+
+/**
+ * Deconstruct a rope object
+ * @param obj The object to deconstruct
+ */
+ZYLIB_NONNULL
+void zylib_private_rope_destruct(zylib_private_rope_t **obj);
+
+/**
+ * Append a memory region to a rope object; the spare space of the last chunk is filled before new chunks are allocated
+ * @param obj The rope object
+ * @param size The size of the memory region
+ * @param ptr The address of the memory region to copy
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_rope_append(zylib_private_rope_t *obj, uint64_t size, const void *ptr);
+
+/**
+ * Move every chunk of a rope object to the end of another one, without copying them
+ * @param obj The rope object
+ * @param rope The rope object to move, which must share the allocator object of obj; deconstructed on success
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_rope_concat(zylib_private_rope_t *obj, zylib_private_rope_t **rope);
+
+/**
+ * Retrieve the next contiguous segment of a rope object
+ * @param obj The rope object
+ * @param iterator The pointer to the iterator, which must be NULL to retrieve the first segment
+ * @param size The pointer to the size of the segment
+ * @param ptr The pointer to the address of the segment
+ * @return True if and only if a segment was retrieved
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_rope_next(const zylib_private_rope_t *obj, const void **iterator, uint64_t *size,
+                              const void **ptr);
+
+/**
+ * Copy the chunks of a non-empty rope object into a single one, unless it already has a single chunk
+ * @param obj The rope object
+ * @param ptr The pointer to the address of the memory region
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_rope_flatten(zylib_private_rope_t *obj, const void **ptr);
+
+/**
+ * Deconstruct a non-empty rope object, handing its memory region back to the caller as a single region allocated from
+ * its allocator object; obj is left untouched on failure
+ * @param obj The object to deconstruct
+ * @param size The pointer to the size of the memory region
+ * @param ptr The pointer to the address of the memory region, to be deallocated by the caller
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_rope_release(zylib_private_rope_t **obj, uint64_t *size, void **ptr);
+
+/**
+ * Retrieve the size of the memory region that is stored at obj
+ * @param obj The rope object
+ * @return The size of the memory region
+ */
+ZYLIB_NONNULL
+uint64_t zylib_private_rope_peek_size(const zylib_private_rope_t *obj);
+
+ZYLIB_END_DECLS
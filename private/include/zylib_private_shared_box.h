@@ -0,0 +1,85 @@
+/*
+ * Copyright 2023 Alexandre Fernandez <alex@fernandezfamily.email>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#include "zylib_private_allocator.h"
+#include <stdint.h>
+
+/**
+ * Shared Box Data Structure.
+ * An immutable, reference-counted memory region; a slice is a shared box that views part of the memory region of
+ * another one without copying it.
+ */
+typedef struct zylib_private_shared_box_s zylib_private_shared_box_t;
+
+ZYLIB_BEGIN_DECLS
+
+/**
+ * Construct a shared box object, holding one reference
+ * @param obj The object to construct
+ * @param allocator The allocator object
+ * @param size The size of the memory region
+ * @param ptr The address of the memory region to copy
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_shared_box_construct(zylib_private_shared_box_t **obj, const zylib_private_allocator_t *allocator,
+                                         uint64_t size, const void *ptr);
+
+/**
+ * Construct a shared box object, holding one reference, that views part of the memory region of another one.
+ * The memory region is not copied; it is kept alive until every shared box object that views it is deconstructed.
+ * @param obj The object to construct
+ * @param box The shared box object to view
+ * @param offset The offset of the view within the memory region of box
+ * @param size The size of the view
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_shared_box_slice(zylib_private_shared_box_t **obj, zylib_private_shared_box_t *box,
+                                     uint64_t offset, uint64_t size);
+
+/**
+ * Acquire a reference to a shared box object; it may be called concurrently from any number of threads
+ * @param obj The shared box object
+ */
+ZYLIB_NONNULL
+void zylib_private_shared_box_acquire(zylib_private_shared_box_t *obj);
+
+/**
+ * Release a reference to a shared box object, deconstructing it with its last reference; it may be called
+ * concurrently from any number of threads
+ * @param obj The object to deconstruct; set to NULL
+ */
+ZYLIB_NONNULL
+void zylib_private_shared_box_destruct(zylib_private_shared_box_t **obj);
+
+/**
+ * Retrieve the size of the memory region that is viewed by obj
+ * @param obj The shared box object
+ * @return The size of the memory region
+ */
+ZYLIB_NONNULL
+uint64_t zylib_private_shared_box_peek_size(const zylib_private_shared_box_t *obj);
+
+/**
+ * Retrieve the address of the memory region that is viewed by obj
+ * @param obj The shared box object
+ * @return The address of the memory region
+ */
+ZYLIB_NONNULL
+const void *zylib_private_shared_box_peek_data(const zylib_private_shared_box_t *obj);
+
+ZYLIB_END_DECLS
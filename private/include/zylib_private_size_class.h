@@ -0,0 +1,61 @@
+/*
+ * Copyright 2023 Alexandre Fernandez <alex@fernandezfamily.email>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#include "zylib_private_allocator.h"
+
+ZYLIB_BEGIN_DECLS
+
+/**
+ * Construct a size-class allocator object.
+ * Small memory regions are carved from pages dedicated to a single size class and located from their address on
+ * deallocation, so they carry no header; larger ones are allocated from the parent allocator object behind a size
+ * header. Pages are allocated from the parent allocator object in chunks and only returned to it on destruction.
+ * @param obj The object to construct
+ * @param parent The allocator object from which obj and every page are allocated
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_size_class_construct(zylib_private_allocator_t **obj, const zylib_private_allocator_t *parent);
+
+/**
+ * Return the memory of every empty page of a size-class allocator object to the operating system; the pages are kept
+ * for reuse
+ * @param obj The size-class allocator object
+ * @return True if and only if obj is a size-class allocator object
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_size_class_trim(zylib_private_allocator_t *obj);
+
+/**
+ * Set the decay period of a size-class allocator object: the memory of pages that stay empty for a whole period is
+ * returned to the operating system
+ * @param obj The size-class allocator object
+ * @param decay The decay period in milliseconds, or 0 to retain every page
+ * @return True if and only if obj is a size-class allocator object
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_size_class_set_decay(zylib_private_allocator_t *obj, uint64_t decay);
+
+/**
+ * Retrieve the decay period of a size-class allocator object
+ * @param obj The size-class allocator object
+ * @param decay The pointer to the decay period in milliseconds, or 0 if every page is retained
+ * @return True if and only if obj is a size-class allocator object
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_size_class_peek_decay(const zylib_private_allocator_t *obj, uint64_t *decay);
+
+ZYLIB_END_DECLS
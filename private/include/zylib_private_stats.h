@@ -0,0 +1,41 @@
+/*
+ * Copyright 2023 Alexandre Fernandez <alex@fernandezfamily.email>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#include "zylib_private_allocator.h"
+
+ZYLIB_BEGIN_DECLS
+
+/**
+ * Construct a statistics allocator object.
+ * Every request is forwarded to the parent allocator object and accounted in per-thread counters, which are only
+ * aggregated by zylib_private_stats_query().
+ * @param obj The object to construct
+ * @param parent The allocator object from which obj and every memory region are allocated
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_stats_construct(zylib_private_allocator_t **obj, const zylib_private_allocator_t *parent);
+
+/**
+ * Take a snapshot of the statistics of a statistics allocator object.
+ * @param obj The statistics allocator object
+ * @param stats The snapshot
+ * @return True if and only if obj is a statistics allocator object
+ */
+ZYLIB_NONNULL
+_Bool zylib_private_stats_query(const zylib_private_allocator_t *obj, zylib_allocator_stats_t *stats);
+
+ZYLIB_END_DECLS
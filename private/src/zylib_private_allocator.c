@@ -13,7 +13,18 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#if !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
 #include "zylib_private_allocator.h"
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 /*
  * Types
@@ -21,11 +32,53 @@
 
 struct zylib_private_allocator_s
 {
+    const zylib_allocator_vtable_t *vtable;
+    void *context;
+    const zylib_private_allocator_t *parent;
     zylib_allocator_malloc_t malloc;
     zylib_allocator_realloc_t realloc;
     zylib_allocator_free_t free;
 };
 
+/*
+ * Static Function Definitions
+ */
+
+static void *zylib_private_allocator_std_malloc(void *context, size_t size)
+{
+    return ((const zylib_private_allocator_t *)context)->malloc(size);
+}
+
+static void *zylib_private_allocator_std_realloc(void *context, void *ptr, size_t old_size, size_t size)
+{
+    (void)(old_size);
+    return ((const zylib_private_allocator_t *)context)->realloc(ptr, size);
+}
+
+static void zylib_private_allocator_std_free(void *context, void *ptr, size_t size)
+{
+    (void)(size);
+    ((const zylib_private_allocator_t *)context)->free(ptr);
+}
+
+static const zylib_allocator_vtable_t zylib_private_allocator_std_vtable = {
+    .malloc = zylib_private_allocator_std_malloc,
+    .calloc = NULL,
+    .realloc = zylib_private_allocator_std_realloc,
+    .free = zylib_private_allocator_std_free,
+    .aligned_malloc = NULL,
+    .aligned_free = NULL,
+    .destruct = NULL};
+
+/*
+ * The fallback over-allocates by alignment bytes plus a pointer, and stores the address returned by malloc
+ * immediately before the aligned address.
+ */
+static inline size_t zylib_private_allocator_aligned_size(size_t alignment, size_t size)
+{
+    return size + alignment - 1 + sizeof(void *);
+}
+
 /*
  * Functions
  */
@@ -41,6 +94,9 @@ _Bool zylib_private_allocator_construct(zylib_private_allocator_t **obj, zylib_a
         goto error;
     }
 
+    (*obj)->vtable = &zylib_private_allocator_std_vtable;
+    (*obj)->context = *obj;
+    (*obj)->parent = NULL;
     (*obj)->malloc = malloc;
     (*obj)->realloc = realloc;
     (*obj)->free = free;
@@ -49,15 +105,65 @@ error:
     return r;
 }
 
+_Bool zylib_private_allocator_construct_context(zylib_private_allocator_t **obj,
+                                                const zylib_private_allocator_t *parent,
+                                                const zylib_allocator_vtable_t *vtable, void *context)
+{
+    _Bool r = 0;
+
+    *obj = NULL;
+    if (parent != NULL)
+    {
+        r = zylib_private_allocator_malloc(parent, sizeof(zylib_private_allocator_t), (void **)obj);
+    }
+    else
+    {
+        *obj = vtable->malloc(context, sizeof(zylib_private_allocator_t));
+        r = *obj != NULL;
+    }
+    if (!r)
+    {
+        goto error;
+    }
+
+    (*obj)->vtable = vtable;
+    (*obj)->context = context;
+    (*obj)->parent = parent;
+    (*obj)->malloc = NULL;
+    (*obj)->realloc = NULL;
+    (*obj)->free = NULL;
+
+error:
+    return r;
+}
+
 void zylib_private_allocator_destruct(zylib_private_allocator_t **obj)
 {
+    const zylib_allocator_vtable_t *vtable;
+    void *context;
+
     if (*obj == NULL)
     {
         return;
     }
 
-    (*obj)->free((void *)*obj);
-    *obj = NULL;
+    vtable = (*obj)->vtable;
+    context = (*obj)->context;
+
+    if ((*obj)->parent != NULL)
+    {
+        zylib_private_allocator_free_sized((*obj)->parent, sizeof(zylib_private_allocator_t), (void **)obj);
+    }
+    else
+    {
+        vtable->free(context, (void *)*obj, sizeof(zylib_private_allocator_t));
+        *obj = NULL;
+    }
+
+    if (vtable->destruct != NULL)
+    {
+        vtable->destruct(context);
+    }
 }
 
 _Bool zylib_private_allocator_malloc(const zylib_private_allocator_t *obj, size_t size, void **ptr)
@@ -69,7 +175,7 @@ _Bool zylib_private_allocator_malloc(const zylib_private_allocator_t *obj, size_
         return 0;
     }
 
-    *ptr = obj->malloc(size);
+    *ptr = obj->vtable->malloc(obj->context, size);
     if (*ptr == NULL)
     {
         goto error;
@@ -80,7 +186,45 @@ error:
     return r;
 }
 
+_Bool zylib_private_allocator_calloc(const zylib_private_allocator_t *obj, size_t size, void **ptr)
+{
+    _Bool r = 0;
+
+    if (size <= 0)
+    {
+        return 0;
+    }
+
+    if (obj->vtable->calloc != NULL)
+    {
+        *ptr = obj->vtable->calloc(obj->context, size);
+        if (*ptr == NULL)
+        {
+            goto error;
+        }
+    }
+    else
+    {
+        *ptr = obj->vtable->malloc(obj->context, size);
+        if (*ptr == NULL)
+        {
+            goto error;
+        }
+        memset(*ptr, 0, size);
+    }
+
+    r = 1;
+error:
+    return r;
+}
+
 _Bool zylib_private_allocator_realloc(const zylib_private_allocator_t *obj, size_t size, void **ptr)
+{
+    return zylib_private_allocator_realloc_sized(obj, 0, size, ptr);
+}
+
+_Bool zylib_private_allocator_realloc_sized(const zylib_private_allocator_t *obj, size_t old_size, size_t size,
+                                            void **ptr)
 {
     _Bool r = 0;
     void *x_ptr = NULL;
@@ -90,7 +234,7 @@ _Bool zylib_private_allocator_realloc(const zylib_private_allocator_t *obj, size
         return 0;
     }
 
-    x_ptr = obj->realloc(*ptr, size);
+    x_ptr = obj->vtable->realloc(obj->context, *ptr, old_size, size);
     if (x_ptr == NULL)
     {
         goto error;
@@ -103,10 +247,131 @@ error:
 }
 
 void zylib_private_allocator_free(const zylib_private_allocator_t *obj, void **ptr)
+{
+    zylib_private_allocator_free_sized(obj, 0, ptr);
+}
+
+void zylib_private_allocator_free_sized(const zylib_private_allocator_t *obj, size_t size, void **ptr)
 {
     if (*ptr != NULL)
     {
-        obj->free(*ptr);
+        obj->vtable->free(obj->context, *ptr, size);
+        *ptr = NULL;
+    }
+}
+
+_Bool zylib_private_allocator_aligned_malloc(const zylib_private_allocator_t *obj, size_t alignment, size_t size,
+                                             void **ptr)
+{
+    _Bool r = 0;
+    unsigned char *x_ptr = NULL;
+    uintptr_t address;
+
+    if (size <= 0 || alignment <= 0 || (alignment & (alignment - 1)) != 0)
+    {
+        return 0;
+    }
+
+    if (obj->vtable->aligned_malloc != NULL)
+    {
+        *ptr = obj->vtable->aligned_malloc(obj->context, alignment, size);
+        return *ptr != NULL;
+    }
+
+    if (alignment < sizeof(void *))
+    {
+        alignment = sizeof(void *);
+    }
+    if (size > SIZE_MAX - alignment - sizeof(void *))
+    {
+        return 0;
+    }
+
+    r = zylib_private_allocator_malloc(obj, zylib_private_allocator_aligned_size(alignment, size), (void **)&x_ptr);
+    if (!r)
+    {
+        goto error;
+    }
+
+    address = ((uintptr_t)(x_ptr + sizeof(void *)) + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    *ptr = x_ptr + (address - (uintptr_t)x_ptr);
+    memcpy((unsigned char *)*ptr - sizeof(void *), &x_ptr, sizeof(void *));
+
+error:
+    return r;
+}
+
+void zylib_private_allocator_aligned_free(const zylib_private_allocator_t *obj, size_t alignment, size_t size,
+                                          void **ptr)
+{
+    void *x_ptr;
+
+    if (*ptr == NULL)
+    {
+        return;
+    }
+
+    if (obj->vtable->aligned_free != NULL)
+    {
+        obj->vtable->aligned_free(obj->context, *ptr, alignment, size);
         *ptr = NULL;
+        return;
+    }
+
+    if (alignment < sizeof(void *))
+    {
+        alignment = sizeof(void *);
+    }
+
+    memcpy(&x_ptr, (unsigned char *)*ptr - sizeof(void *), sizeof(void *));
+    zylib_private_allocator_free_sized(obj, size > 0 ? zylib_private_allocator_aligned_size(alignment, size) : 0,
+                                       &x_ptr);
+    *ptr = NULL;
+}
+
+const zylib_allocator_vtable_t *zylib_private_allocator_peek_vtable(const zylib_private_allocator_t *obj)
+{
+    return obj->vtable;
+}
+
+void *zylib_private_allocator_peek_context(const zylib_private_allocator_t *obj)
+{
+    return obj->context;
+}
+
+size_t zylib_private_allocator_discard(void *ptr, size_t size)
+{
+#if (defined(__unix__) || defined(__APPLE__)) && defined(MADV_DONTNEED)
+    const long page_size = sysconf(_SC_PAGESIZE);
+    uintptr_t begin;
+    uintptr_t end;
+
+    if (page_size <= 0)
+    {
+        return 0;
+    }
+
+    begin = ((uintptr_t)ptr + (uintptr_t)page_size - 1) & ~(uintptr_t)(page_size - 1);
+    end = ((uintptr_t)ptr + size) & ~(uintptr_t)(page_size - 1);
+    if (begin >= end || madvise((void *)begin, end - begin, MADV_DONTNEED) != 0)
+    {
+        return 0;
+    }
+    return end - begin;
+#else
+    (void)(ptr);
+    (void)(size);
+    return 0;
+#endif
+}
+
+uint64_t zylib_private_allocator_clock(void)
+{
+    struct timespec ts;
+
+    if (timespec_get(&ts, TIME_UTC) != TIME_UTC)
+    {
+        return 0;
     }
+    return (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
 }
@@ -0,0 +1,423 @@
+/*
+ * Copyright 2023 Alexandre Fernandez <alex@fernandezfamily.email>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "zylib_private_arena.h"
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * Macros
+ */
+
+#define ZYLIB_PRIVATE_ARENA_ALIGNMENT (_Alignof(max_align_t))
+
+/*
+ * Type Definitions
+ */
+
+typedef struct zylib_private_arena_block_s
+{
+    struct zylib_private_arena_block_s *next;
+    size_t size;
+    max_align_t data[];
+} zylib_private_arena_block_t;
+
+typedef struct zylib_private_arena_s
+{
+    const zylib_private_allocator_t *parent;
+    size_t block_size;
+    zylib_private_arena_block_t *first, *current;
+    size_t offset;
+    unsigned char *last;
+    /* The index of the current block, and the highest one reached since the decay period started */
+    size_t depth, peak;
+    /* The decay period in milliseconds, or 0, and the time it started */
+    uint64_t decay;
+    uint64_t epoch;
+} zylib_private_arena_t;
+
+/*
+ * Static Function Declarations
+ */
+
+static void *zylib_private_arena_malloc(void *context, size_t size);
+
+static void *zylib_private_arena_realloc(void *context, void *ptr, size_t old_size, size_t size);
+
+static void zylib_private_arena_free(void *context, void *ptr, size_t size);
+
+static void *zylib_private_arena_aligned_malloc(void *context, size_t alignment, size_t size);
+
+static void zylib_private_arena_aligned_free(void *context, void *ptr, size_t alignment, size_t size);
+
+static void zylib_private_arena_destruct(void *context);
+
+/*
+ * Static Variables
+ */
+
+static const zylib_allocator_vtable_t zylib_private_arena_vtable = {
+    .malloc = zylib_private_arena_malloc,
+    .calloc = NULL,
+    .realloc = zylib_private_arena_realloc,
+    .free = zylib_private_arena_free,
+    .aligned_malloc = zylib_private_arena_aligned_malloc,
+    .aligned_free = zylib_private_arena_aligned_free,
+    .destruct = zylib_private_arena_destruct};
+
+/*
+ * Static Function Definitions
+ */
+
+ZYLIB_NONNULL
+static inline unsigned char *zylib_private_arena_block_data(const zylib_private_arena_block_t *block)
+{
+    return (unsigned char *)block->data;
+}
+
+/*
+ * Round the offset from data up so that data + offset is a multiple of alignment
+ */
+ZYLIB_NONNULL
+static inline size_t zylib_private_arena_align(const unsigned char *data, size_t offset, size_t alignment)
+{
+    return (size_t)((((uintptr_t)data + offset + alignment - 1) & ~(uintptr_t)(alignment - 1)) - (uintptr_t)data);
+}
+
+/*
+ * Make a block of at least size bytes current; blocks left behind by a reset are reused before new ones are allocated
+ */
+ZYLIB_NONNULL
+static _Bool zylib_private_arena_next_block(zylib_private_arena_t *arena, size_t size)
+{
+    _Bool r;
+    size_t capacity;
+    zylib_private_arena_block_t *block = arena->current != NULL ? arena->current->next : arena->first;
+
+    if (block != NULL && block->size >= size)
+    {
+        r = 1;
+        goto done;
+    }
+
+    capacity = size > arena->block_size ? size : arena->block_size;
+    if (capacity > SIZE_MAX - sizeof(zylib_private_arena_block_t))
+    {
+        return 0;
+    }
+
+    block = NULL;
+    r = zylib_private_allocator_malloc(arena->parent, sizeof(zylib_private_arena_block_t) + capacity,
+                                       (void **)&block);
+    if (!r)
+    {
+        goto error;
+    }
+
+    block->size = capacity;
+    if (arena->current != NULL)
+    {
+        block->next = arena->current->next;
+        arena->current->next = block;
+    }
+    else
+    {
+        block->next = arena->first;
+        arena->first = block;
+    }
+
+done:
+    if (arena->current != NULL && ++arena->depth > arena->peak)
+    {
+        arena->peak = arena->depth;
+    }
+    arena->current = block;
+    arena->offset = 0;
+error:
+    return r;
+}
+
+/*
+ * Return the blocks past the index-th one to the parent allocator object
+ */
+ZYLIB_NONNULL
+static void zylib_private_arena_release(zylib_private_arena_t *arena, size_t index)
+{
+    zylib_private_arena_block_t *block = arena->first;
+
+    for (size_t i = 0; block != NULL && i < index; ++i)
+    {
+        block = block->next;
+    }
+
+    if (block != NULL)
+    {
+        zylib_private_arena_block_t *next = block->next;
+        block->next = NULL;
+        while (next != NULL)
+        {
+            zylib_private_arena_block_t *x_next = next->next;
+            zylib_private_allocator_free_sized(arena->parent, sizeof(zylib_private_arena_block_t) + next->size,
+                                               (void **)&next);
+            next = x_next;
+        }
+    }
+}
+
+void *zylib_private_arena_malloc(void *context, size_t size)
+{
+    return zylib_private_arena_aligned_malloc(context, ZYLIB_PRIVATE_ARENA_ALIGNMENT, size);
+}
+
+void *zylib_private_arena_aligned_malloc(void *context, size_t alignment, size_t size)
+{
+    zylib_private_arena_t *arena = context;
+    unsigned char *data;
+    unsigned char *ptr;
+    size_t offset;
+
+    if (alignment < ZYLIB_PRIVATE_ARENA_ALIGNMENT)
+    {
+        alignment = ZYLIB_PRIVATE_ARENA_ALIGNMENT;
+    }
+
+    if (arena->current != NULL)
+    {
+        data = zylib_private_arena_block_data(arena->current);
+        offset = zylib_private_arena_align(data, arena->offset, alignment);
+        if (offset <= arena->current->size && size <= arena->current->size - offset)
+        {
+            goto done;
+        }
+    }
+
+    /* Block data is only aligned to ZYLIB_PRIVATE_ARENA_ALIGNMENT */
+    if (size > SIZE_MAX - alignment ||
+        !zylib_private_arena_next_block(arena, size + alignment - ZYLIB_PRIVATE_ARENA_ALIGNMENT))
+    {
+        return NULL;
+    }
+    data = zylib_private_arena_block_data(arena->current);
+    offset = zylib_private_arena_align(data, 0, alignment);
+
+done:
+    ptr = data + offset;
+    arena->offset = offset + size;
+    arena->last = ptr;
+    return ptr;
+}
+
+void *zylib_private_arena_realloc(void *context, void *ptr, size_t old_size, size_t size)
+{
+    zylib_private_arena_t *arena = context;
+    const zylib_private_arena_block_t *block;
+    unsigned char *x_ptr;
+    size_t offset;
+    size_t available = old_size;
+
+    /* The most recent allocation grows in place */
+    if (ptr == arena->last)
+    {
+        offset = (size_t)(arena->last - zylib_private_arena_block_data(arena->current));
+        if (size <= arena->current->size - offset)
+        {
+            arena->offset = offset + size;
+            return ptr;
+        }
+    }
+
+    /*
+     * If the old size is unknown, every byte up to the end of its block may belong to ptr, but no further than the bump
+     * offset in the current block, past which the new memory region is allocated
+     */
+    for (block = old_size <= 0 ? arena->first : NULL; block != NULL; block = block->next)
+    {
+        const unsigned char *data = zylib_private_arena_block_data(block);
+        const size_t end = block == arena->current ? arena->offset : block->size;
+        if ((uintptr_t)ptr >= (uintptr_t)data && (uintptr_t)ptr < (uintptr_t)data + end)
+        {
+            available = end - (size_t)((const unsigned char *)ptr - data);
+            break;
+        }
+    }
+
+    x_ptr = zylib_private_arena_malloc(context, size);
+    if (x_ptr != NULL)
+    {
+        /* The new memory region may be carved from the same block */
+        memmove(x_ptr, ptr, size < available ? size : available);
+    }
+    return x_ptr;
+}
+
+void zylib_private_arena_free(void *context, void *ptr, size_t size)
+{
+    zylib_private_arena_t *arena = context;
+
+    (void)(size);
+
+    /* Only the most recent allocation can be given back before a reset */
+    if (ptr == arena->last)
+    {
+        arena->offset = (size_t)(arena->last - zylib_private_arena_block_data(arena->current));
+        arena->last = NULL;
+    }
+}
+
+void zylib_private_arena_aligned_free(void *context, void *ptr, size_t alignment, size_t size)
+{
+    (void)(alignment);
+    zylib_private_arena_free(context, ptr, size);
+}
+
+void zylib_private_arena_destruct(void *context)
+{
+    zylib_private_arena_t *arena = context;
+    zylib_private_arena_block_t *block = arena->first;
+
+    while (block != NULL)
+    {
+        zylib_private_arena_block_t *const next = block->next;
+        zylib_private_allocator_free_sized(arena->parent, sizeof(zylib_private_arena_block_t) + block->size,
+                                           (void **)&block);
+        block = next;
+    }
+    zylib_private_allocator_free_sized(arena->parent, sizeof(zylib_private_arena_t), (void **)&arena);
+}
+
+/*
+ * Function Definitions
+ */
+
+_Bool zylib_private_arena_construct(zylib_private_allocator_t **obj, size_t block_size,
+                                    const zylib_private_allocator_t *parent)
+{
+    _Bool r;
+    zylib_private_arena_t *arena = NULL;
+
+    *obj = NULL;
+    if (block_size <= 0)
+    {
+        return 0;
+    }
+
+    r = zylib_private_allocator_malloc(parent, sizeof(zylib_private_arena_t), (void **)&arena);
+    if (!r)
+    {
+        goto error;
+    }
+
+    arena->parent = parent;
+    arena->block_size = block_size;
+    arena->first = NULL;
+    arena->current = NULL;
+    arena->offset = 0;
+    arena->last = NULL;
+    arena->depth = 0;
+    arena->peak = 0;
+    arena->decay = 0;
+    arena->epoch = 0;
+
+    r = zylib_private_allocator_construct_context(obj, parent, &zylib_private_arena_vtable, arena);
+    if (!r)
+    {
+        goto error;
+    }
+
+    goto done;
+error:
+    if (arena != NULL)
+    {
+        zylib_private_allocator_free_sized(parent, sizeof(zylib_private_arena_t), (void **)&arena);
+    }
+done:
+    return r;
+}
+
+_Bool zylib_private_arena_reset(zylib_private_allocator_t *obj)
+{
+    zylib_private_arena_t *arena;
+
+    if (zylib_private_allocator_peek_vtable(obj) != &zylib_private_arena_vtable)
+    {
+        return 0;
+    }
+
+    arena = zylib_private_allocator_peek_context(obj);
+    arena->current = arena->first;
+    arena->offset = 0;
+    arena->last = NULL;
+    arena->depth = 0;
+
+    /* Blocks that went unused for a whole decay period are returned */
+    if (arena->decay != 0)
+    {
+        const uint64_t now = zylib_private_allocator_clock();
+        if (now - arena->epoch >= arena->decay)
+        {
+            zylib_private_arena_release(arena, arena->peak);
+            arena->peak = 0;
+            arena->epoch = now;
+        }
+    }
+    return 1;
+}
+
+_Bool zylib_private_arena_trim(zylib_private_allocator_t *obj)
+{
+    zylib_private_arena_t *arena;
+
+    if (zylib_private_allocator_peek_vtable(obj) != &zylib_private_arena_vtable)
+    {
+        return 0;
+    }
+
+    arena = zylib_private_allocator_peek_context(obj);
+    if (arena->current != NULL)
+    {
+        zylib_private_arena_release(arena, arena->depth);
+        zylib_private_allocator_discard(zylib_private_arena_block_data(arena->current) + arena->offset,
+                                        arena->current->size - arena->offset);
+    }
+    arena->peak = arena->depth;
+    return 1;
+}
+
+_Bool zylib_private_arena_set_decay(zylib_private_allocator_t *obj, uint64_t decay)
+{
+    zylib_private_arena_t *arena;
+
+    if (zylib_private_allocator_peek_vtable(obj) != &zylib_private_arena_vtable)
+    {
+        return 0;
+    }
+
+    arena = zylib_private_allocator_peek_context(obj);
+    arena->decay = decay;
+    arena->epoch = zylib_private_allocator_clock();
+    arena->peak = arena->depth;
+    return 1;
+}
+
+_Bool zylib_private_arena_peek_decay(const zylib_private_allocator_t *obj, uint64_t *decay)
+{
+    if (zylib_private_allocator_peek_vtable(obj) != &zylib_private_arena_vtable)
+    {
+        return 0;
+    }
+
+    *decay = ((const zylib_private_arena_t *)zylib_private_allocator_peek_context(obj))->decay;
+    return 1;
+}
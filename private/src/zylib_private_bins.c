@@ -0,0 +1,155 @@
+/*
+ * Copyright 2023 Alexandre Fernandez <alex@fernandezfamily.email>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "zylib_private_bins.h"
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * Function Definitions
+ */
+
+size_t zylib_private_bins_class(size_t size)
+{
+    size_t c = 0;
+    while (((size_t)1 << (c + ZYLIB_PRIVATE_BINS_MIN_SHIFT)) < size)
+    {
+        ++c;
+    }
+    return c;
+}
+
+zylib_private_bins_block_t *zylib_private_bins_header(void *ptr)
+{
+    return (zylib_private_bins_block_t *)((unsigned char *)ptr - sizeof(zylib_private_bins_block_t));
+}
+
+_Bool zylib_private_bins_refill(zylib_private_bins_t *obj, const zylib_private_allocator_t *parent, mtx_t *lock,
+                               size_t c)
+{
+    const size_t size = (size_t)1 << (c + ZYLIB_PRIVATE_BINS_MIN_SHIFT);
+
+    mtx_lock(lock);
+    for (size_t i = 0; i < ZYLIB_PRIVATE_BINS_BATCH; ++i)
+    {
+        zylib_private_bins_block_t *block = NULL;
+        if (!zylib_private_allocator_malloc(parent, sizeof(zylib_private_bins_block_t) + size, (void **)&block))
+        {
+            break;
+        }
+        block->size = size;
+        block->next = obj->heads[c];
+        obj->heads[c] = block;
+        ++obj->count[c];
+    }
+    mtx_unlock(lock);
+
+    return obj->heads[c] != NULL;
+}
+
+void zylib_private_bins_flush(zylib_private_bins_t *obj, const zylib_private_allocator_t *parent, mtx_t *lock,
+                              size_t c, size_t n)
+{
+    mtx_lock(lock);
+    while (n-- > 0 && obj->heads[c] != NULL)
+    {
+        zylib_private_bins_block_t *const block = obj->heads[c];
+        obj->heads[c] = block->next;
+        --obj->count[c];
+        zylib_private_bins_release(parent, block);
+    }
+    mtx_unlock(lock);
+}
+
+void zylib_private_bins_empty(zylib_private_bins_t *obj, const zylib_private_allocator_t *parent)
+{
+    for (size_t c = 0; c < ZYLIB_PRIVATE_BINS_CLASS_N; ++c)
+    {
+        while (obj->heads[c] != NULL)
+        {
+            zylib_private_bins_block_t *const block = obj->heads[c];
+            obj->heads[c] = block->next;
+            zylib_private_bins_release(parent, block);
+        }
+        obj->count[c] = 0;
+    }
+}
+
+void zylib_private_bins_release(const zylib_private_allocator_t *parent, zylib_private_bins_block_t *block)
+{
+    zylib_private_allocator_free_sized(parent, sizeof(zylib_private_bins_block_t) + block->size, (void **)&block);
+}
+
+void *zylib_private_bins_malloc_large(const zylib_private_allocator_t *parent, mtx_t *lock, size_t size)
+{
+    zylib_private_bins_block_t *block = NULL;
+
+    if (size > SIZE_MAX - sizeof(zylib_private_bins_block_t))
+    {
+        return NULL;
+    }
+
+    mtx_lock(lock);
+    zylib_private_allocator_malloc(parent, sizeof(zylib_private_bins_block_t) + size, (void **)&block);
+    mtx_unlock(lock);
+    if (block == NULL)
+    {
+        return NULL;
+    }
+    block->owner = NULL;
+    block->size = size;
+    return block->data;
+}
+
+void *zylib_private_bins_realloc(const zylib_allocator_vtable_t *vtable, void *context,
+                                 const zylib_private_allocator_t *parent, mtx_t *lock, void *ptr, size_t size)
+{
+    zylib_private_bins_block_t *block = zylib_private_bins_header(ptr);
+    void *x_ptr;
+
+    if (block->size <= ZYLIB_PRIVATE_BINS_MAX_SIZE && size <= block->size)
+    {
+        return ptr;
+    }
+
+    if (block->size > ZYLIB_PRIVATE_BINS_MAX_SIZE && size > ZYLIB_PRIVATE_BINS_MAX_SIZE)
+    {
+        _Bool r;
+
+        if (size > SIZE_MAX - sizeof(zylib_private_bins_block_t))
+        {
+            return NULL;
+        }
+
+        mtx_lock(lock);
+        r = zylib_private_allocator_realloc_sized(parent, sizeof(zylib_private_bins_block_t) + block->size,
+                                                  sizeof(zylib_private_bins_block_t) + size, (void **)&block);
+        mtx_unlock(lock);
+        if (!r)
+        {
+            return NULL;
+        }
+        block->size = size;
+        return block->data;
+    }
+
+    x_ptr = vtable->malloc(context, size);
+    if (x_ptr != NULL)
+    {
+        memcpy(x_ptr, ptr, block->size < size ? block->size : size);
+        vtable->free(context, ptr, 0);
+    }
+    return x_ptr;
+}
@@ -14,13 +14,18 @@
  * limitations under the License.
  */
 #include "zylib_private_box.h"
+#include <stddef.h>
 #include <string.h>
 
 struct zylib_private_box_s
 {
     const zylib_private_allocator_t *allocator;
+    /* The pool object that obj was allocated from, or NULL if it was allocated from allocator */
+    zylib_private_pool_t *pool;
     uint64_t size;
-    void *data;
+    /* The adopted memory region, or NULL if the memory region is stored in data */
+    void *region;
+    max_align_t data[];
 };
 
 ZYLIB_NONNULL
@@ -31,71 +36,209 @@ ZYLIB_NONNULL
 static inline _Bool zylib_box_get_address_by_index(const zylib_private_box_t *box, uint64_t index, uint64_t *size,
                                                    void **ptr);
 
+/*
+ * Compute the size of the allocation that holds a box of size bytes; fails if it is not representable
+ */
+ZYLIB_NONNULL
+static inline _Bool zylib_box_get_allocation_size(uint64_t size, size_t *allocation_size)
+{
+    if (size > SIZE_MAX - offsetof(zylib_private_box_t, data))
+    {
+        return 0;
+    }
+
+    *allocation_size = offsetof(zylib_private_box_t, data) + (size_t)size;
+    return 1;
+}
+
 _Bool zylib_private_box_construct(zylib_private_box_t **obj, const zylib_private_allocator_t *allocator, uint64_t size,
                                   const void *ptr)
 {
     _Bool r;
+    size_t allocation_size;
 
-    if (size <= 0)
+    if (size <= 0 || !zylib_box_get_allocation_size(size, &allocation_size))
     {
         return 0;
     }
 
     *obj = NULL;
-    r = zylib_private_allocator_malloc(allocator, sizeof(zylib_private_box_t), (void **)obj);
+    r = zylib_private_allocator_malloc(allocator, allocation_size, (void **)obj);
     if (!r)
     {
-        goto error;
+        return 0;
     }
 
     (*obj)->allocator = allocator;
-    (*obj)->data = NULL;
-    r = zylib_private_allocator_malloc(allocator, size, &(*obj)->data);
+    (*obj)->pool = NULL;
+    (*obj)->size = size;
+    (*obj)->region = NULL;
+    memcpy((*obj)->data, ptr, size);
+
+    return 1;
+}
+
+_Bool zylib_private_box_adopt(zylib_private_box_t **obj, const zylib_private_allocator_t *allocator, uint64_t size,
+                              void **ptr)
+{
+    _Bool r;
+
+    if (size <= 0 || *ptr == NULL)
+    {
+        return 0;
+    }
+
+    *obj = NULL;
+    r = zylib_private_allocator_malloc(allocator, offsetof(zylib_private_box_t, data), (void **)obj);
     if (!r)
     {
-        goto error;
+        return 0;
     }
 
+    (*obj)->allocator = allocator;
+    (*obj)->pool = NULL;
     (*obj)->size = size;
+    (*obj)->region = *ptr;
+    *ptr = NULL;
+
+    return 1;
+}
+
+_Bool zylib_private_box_construct_pooled(zylib_private_box_t **obj, zylib_private_pool_t *pool,
+                                         const zylib_private_allocator_t *allocator, uint64_t size, const void *ptr)
+{
+    _Bool r;
+    size_t allocation_size;
+
+    if (size <= 0 || !zylib_box_get_allocation_size(size, &allocation_size) ||
+        zylib_private_pool_peek_size(pool) < allocation_size)
+    {
+        return zylib_private_box_construct(obj, allocator, size, ptr);
+    }
+
+    *obj = NULL;
+    r = zylib_private_pool_malloc(pool, (void **)obj);
+    if (!r)
+    {
+        return 0;
+    }
+
+    (*obj)->allocator = allocator;
+    (*obj)->pool = pool;
+    (*obj)->size = size;
+    (*obj)->region = NULL;
     memcpy((*obj)->data, ptr, size);
 
-    goto done;
-error:
-    zylib_private_box_destruct(obj);
-done:
-    return r;
+    return 1;
+}
+
+_Bool zylib_private_box_construct_pool(zylib_private_pool_t **pool, const zylib_private_allocator_t *allocator)
+{
+    return zylib_private_pool_construct(pool, allocator,
+                                        offsetof(zylib_private_box_t, data) + ZYLIB_PRIVATE_BOX_POOL_CAPACITY);
 }
 
 void zylib_private_box_destruct(zylib_private_box_t **obj)
 {
     if (*obj != NULL)
     {
-        if ((*obj)->data != NULL)
+        if ((*obj)->region != NULL)
+        {
+            zylib_private_allocator_free_sized((*obj)->allocator, (*obj)->size, &(*obj)->region);
+            zylib_private_allocator_free_sized((*obj)->allocator, offsetof(zylib_private_box_t, data), (void **)obj);
+        }
+        else if ((*obj)->pool != NULL)
+        {
+            zylib_private_pool_free((*obj)->pool, (void **)obj);
+        }
+        else
         {
-            zylib_private_allocator_free((*obj)->allocator, &(*obj)->data);
+            zylib_private_allocator_free_sized((*obj)->allocator, offsetof(zylib_private_box_t, data) + (*obj)->size,
+                                               (void **)obj);
         }
-        zylib_private_allocator_free((*obj)->allocator, (void **)obj);
     }
 }
 
-_Bool zylib_private_box_append(zylib_private_box_t *obj, uint64_t size, const void *ptr)
+_Bool zylib_private_box_release(zylib_private_box_t **obj, uint64_t *size, void **ptr)
+{
+    _Bool r;
+
+    if ((*obj)->region != NULL)
+    {
+        *size = (*obj)->size;
+        *ptr = (*obj)->region;
+        (*obj)->region = NULL;
+        zylib_private_allocator_free_sized((*obj)->allocator, offsetof(zylib_private_box_t, data), (void **)obj);
+        return 1;
+    }
+
+    *ptr = NULL;
+    r = zylib_private_allocator_malloc((*obj)->allocator, (*obj)->size, ptr);
+    if (!r)
+    {
+        return 0;
+    }
+
+    *size = (*obj)->size;
+    memcpy(*ptr, (*obj)->data, (*obj)->size);
+    zylib_private_box_destruct(obj);
+
+    return 1;
+}
+
+_Bool zylib_private_box_append(zylib_private_box_t **obj, uint64_t size, const void *ptr)
 {
     _Bool r;
 
     uint64_t offset;
     uint64_t index;
+    size_t allocation_size;
     void *address = NULL;
+    zylib_private_box_t *box = NULL;
 
-    r = zylib_private_allocator_realloc(obj->allocator, sizeof(zylib_private_box_t) + obj->size + size, &obj->data);
+    r = size <= UINT64_MAX - (*obj)->size && zylib_box_get_allocation_size((*obj)->size + size, &allocation_size);
     if (!r)
     {
         goto error;
     }
 
-    index = obj->size;
-    obj->size += size;
+    if ((*obj)->region != NULL)
+    {
+        r = zylib_private_allocator_realloc_sized((*obj)->allocator, (*obj)->size, (*obj)->size + size,
+                                                  &(*obj)->region);
+        if (!r)
+        {
+            goto error;
+        }
+    }
+    else if ((*obj)->pool == NULL)
+    {
+        r = zylib_private_allocator_realloc_sized((*obj)->allocator, offsetof(zylib_private_box_t, data) + (*obj)->size,
+                                                  allocation_size, (void **)obj);
+        if (!r)
+        {
+            goto error;
+        }
+    }
+    else if (zylib_private_pool_peek_size((*obj)->pool) < allocation_size)
+    {
+        /* The box outgrows its pool object, so it moves to the allocator object */
+        r = zylib_private_allocator_malloc((*obj)->allocator, allocation_size, (void **)&box);
+        if (!r)
+        {
+            goto error;
+        }
+
+        memcpy(box, *obj, offsetof(zylib_private_box_t, data) + (*obj)->size);
+        box->pool = NULL;
+        zylib_private_pool_free((*obj)->pool, (void **)obj);
+        *obj = box;
+    }
+
+    index = (*obj)->size;
+    (*obj)->size += size;
 
-    r = zylib_box_get_address_by_index(obj, index, &offset, &address);
+    r = zylib_box_get_address_by_index(*obj, index, &offset, &address);
     if (!r)
     {
         goto error;
@@ -119,7 +262,7 @@ uint64_t zylib_private_box_peek_size(const zylib_private_box_t *obj)
 
 const void *zylib_private_box_peek_data(const zylib_private_box_t *obj)
 {
-    return obj->data;
+    return obj->region != NULL ? obj->region : obj->data;
 }
 
 _Bool zylib_box_get_address_by_index(const zylib_private_box_t *box, uint64_t index, uint64_t *size, void **ptr)
@@ -136,7 +279,7 @@ _Bool zylib_box_get_address_by_index_const(const zylib_private_box_t *box, uint6
     }
 
     *size = box->size - index;
-    *ptr = &((const unsigned char *)box->data)[index];
+    *ptr = &((const unsigned char *)zylib_private_box_peek_data(box))[index];
 
     return 1;
 }
@@ -0,0 +1,474 @@
+/*
+ * Copyright 2023 Alexandre Fernandez <alex@fernandezfamily.email>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "zylib_private_budget.h"
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+#include <threads.h>
+
+/*
+ * Macros
+ */
+
+/* Threads reserve up to this many bytes at a time, and hand back what they hold beyond twice as much */
+#define ZYLIB_PRIVATE_BUDGET_MAX_BATCH ((size_t)64 * 1024)
+
+/*
+ * The batch is a small fraction of the hard limit; once the budget runs out, an allocation takes back the reservations
+ * held by every thread before it fails
+ */
+#define ZYLIB_PRIVATE_BUDGET_BATCH_SHIFT (6U)
+
+/*
+ * Type Definitions
+ */
+
+typedef struct zylib_private_budget_block_s
+{
+    /* The requested size */
+    size_t size;
+    max_align_t data[];
+} zylib_private_budget_block_t;
+
+typedef struct zylib_private_budget_local_s zylib_private_budget_local_t;
+
+typedef struct zylib_private_budget_s
+{
+    const zylib_private_allocator_t *parent;
+    size_t soft_limit;
+    size_t hard_limit;
+    size_t batch;
+    zylib_allocator_pressure_t pressure;
+    void *context;
+    /* Serializes reservations being topped up or taken back, and guards the list of threads */
+    mtx_t lock;
+    tss_t key;
+    zylib_private_budget_local_t *locals;
+    /* The bytes reserved by every thread, whether allocated or not */
+    _Atomic size_t usage;
+    /* Whether the bytes allocated were past the soft limit when last looked at; guarded by the lock */
+    _Bool pressured;
+} zylib_private_budget_t;
+
+struct zylib_private_budget_local_s
+{
+    zylib_private_budget_t *budget;
+    zylib_private_budget_local_t *next;
+    _Bool orphan;
+    /* The bytes reserved by the thread and not yet allocated; other threads only ever take them all back */
+    _Atomic size_t available;
+};
+
+/*
+ * Static Function Declarations
+ */
+
+static void *zylib_private_budget_malloc(void *context, size_t size);
+
+static void *zylib_private_budget_realloc(void *context, void *ptr, size_t old_size, size_t size);
+
+static void zylib_private_budget_free(void *context, void *ptr, size_t size);
+
+static void zylib_private_budget_destruct(void *context);
+
+/*
+ * Static Variables
+ */
+
+static const zylib_allocator_vtable_t zylib_private_budget_vtable = {.malloc = zylib_private_budget_malloc,
+                                                                     .calloc = NULL,
+                                                                     .realloc = zylib_private_budget_realloc,
+                                                                     .free = zylib_private_budget_free,
+                                                                     .aligned_malloc = NULL,
+                                                                     .aligned_free = NULL,
+                                                                     .destruct = zylib_private_budget_destruct};
+
+/*
+ * Static Function Definitions
+ */
+
+ZYLIB_NONNULL
+static inline zylib_private_budget_block_t *zylib_private_budget_header(void *ptr)
+{
+    return (zylib_private_budget_block_t *)((unsigned char *)ptr - sizeof(zylib_private_budget_block_t));
+}
+
+/*
+ * Reserve n bytes of the budget
+ */
+ZYLIB_NONNULL
+static _Bool zylib_private_budget_reserve(zylib_private_budget_t *budget, size_t n)
+{
+    size_t usage = atomic_load_explicit(&budget->usage, memory_order_relaxed);
+
+    do
+    {
+        if (n > budget->hard_limit - usage)
+        {
+            return 0;
+        }
+    } while (!atomic_compare_exchange_weak_explicit(&budget->usage, &usage, usage + n, memory_order_relaxed,
+                                                    memory_order_relaxed));
+    return 1;
+}
+
+/*
+ * Retrieve the bytes allocated through the budget, which are the bytes reserved but not held by any thread; the caller
+ * holds the lock
+ */
+ZYLIB_NONNULL
+static size_t zylib_private_budget_live(const zylib_private_budget_t *budget)
+{
+    size_t live = atomic_load_explicit(&budget->usage, memory_order_relaxed);
+
+    for (const zylib_private_budget_local_t *local = budget->locals; local != NULL; local = local->next)
+    {
+        const size_t available = atomic_load_explicit(&local->available, memory_order_relaxed);
+        live = available < live ? live - available : 0;
+    }
+    return live;
+}
+
+/*
+ * Take the reservations of every thread back into the budget; the caller holds the lock
+ */
+ZYLIB_NONNULL
+static void zylib_private_budget_drain(zylib_private_budget_t *budget)
+{
+    for (zylib_private_budget_local_t *local = budget->locals; local != NULL; local = local->next)
+    {
+        atomic_fetch_sub_explicit(&budget->usage, atomic_exchange_explicit(&local->available, 0, memory_order_relaxed),
+                                  memory_order_relaxed);
+    }
+}
+
+/*
+ * Take size bytes from the reservation of a thread, topping it up from the budget if need be, then taking back the
+ * reservations of every thread if the budget ran out. Whenever the reservation is topped up, crossed is set if the
+ * bytes allocated reached the soft limit since they were last seen below it, and live is set to them.
+ */
+ZYLIB_NONNULL
+static _Bool zylib_private_budget_acquire(zylib_private_budget_local_t *local, size_t size, _Bool *crossed,
+                                          size_t *live)
+{
+    zylib_private_budget_t *const budget = local->budget;
+    const size_t batch = budget->batch;
+    size_t available = atomic_load_explicit(&local->available, memory_order_relaxed);
+    size_t need;
+    _Bool r;
+
+    while (size <= available)
+    {
+        if (atomic_compare_exchange_weak_explicit(&local->available, &available, available - size,
+                                                  memory_order_relaxed, memory_order_relaxed))
+        {
+            return 1;
+        }
+    }
+
+    mtx_lock(&budget->lock);
+    available = atomic_exchange_explicit(&local->available, 0, memory_order_relaxed);
+    need = size > available ? size - available : 0;
+
+    r = need <= SIZE_MAX - batch && zylib_private_budget_reserve(budget, need + batch);
+    if (r)
+    {
+        atomic_fetch_add_explicit(&local->available, available + need + batch - size, memory_order_relaxed);
+    }
+    else
+    {
+        /* Close to the hard limit, reserve no more than necessary, then take back what other threads hold */
+        r = zylib_private_budget_reserve(budget, need);
+        if (!r)
+        {
+            zylib_private_budget_drain(budget);
+            r = zylib_private_budget_reserve(budget, need);
+        }
+        atomic_fetch_add_explicit(&local->available, r ? available + need - size : available, memory_order_relaxed);
+    }
+
+    if (r)
+    {
+        *live = zylib_private_budget_live(budget);
+        *crossed = *live >= budget->soft_limit && !budget->pressured;
+        budget->pressured = *live >= budget->soft_limit;
+    }
+    mtx_unlock(&budget->lock);
+    return r;
+}
+
+/*
+ * Give size bytes back to the reservation of a thread, handing the excess back to the budget
+ */
+ZYLIB_NONNULL
+static void zylib_private_budget_release(zylib_private_budget_local_t *local, size_t size)
+{
+    zylib_private_budget_t *const budget = local->budget;
+    const size_t batch = budget->batch;
+    size_t available;
+
+    if (atomic_fetch_add_explicit(&local->available, size, memory_order_relaxed) + size <= 2 * batch)
+    {
+        return;
+    }
+
+    mtx_lock(&budget->lock);
+    available = atomic_exchange_explicit(&local->available, 0, memory_order_relaxed);
+    if (available > batch)
+    {
+        atomic_fetch_sub_explicit(&budget->usage, available - batch, memory_order_relaxed);
+        available = batch;
+    }
+    atomic_fetch_add_explicit(&local->available, available, memory_order_relaxed);
+    if (zylib_private_budget_live(budget) < budget->soft_limit)
+    {
+        budget->pressured = 0;
+    }
+    mtx_unlock(&budget->lock);
+}
+
+ZYLIB_NONNULL
+static void zylib_private_budget_notify(const zylib_private_budget_t *budget, size_t live)
+{
+    if (budget->pressure != NULL)
+    {
+        budget->pressure(budget->context, live, budget->soft_limit);
+    }
+}
+
+/*
+ * Invoked when a thread that used the allocator exits; its reservation is handed back and the next thread adopts it
+ */
+static void zylib_private_budget_detach(void *value)
+{
+    zylib_private_budget_local_t *const local = value;
+
+    mtx_lock(&local->budget->lock);
+    atomic_fetch_sub_explicit(&local->budget->usage,
+                              atomic_exchange_explicit(&local->available, 0, memory_order_relaxed),
+                              memory_order_relaxed);
+    local->orphan = 1;
+    mtx_unlock(&local->budget->lock);
+}
+
+ZYLIB_NONNULL
+static zylib_private_budget_local_t *zylib_private_budget_attach(zylib_private_budget_t *budget)
+{
+    zylib_private_budget_local_t *local;
+
+    mtx_lock(&budget->lock);
+    for (local = budget->locals; local != NULL && !local->orphan; local = local->next)
+    {
+    }
+
+    if (local == NULL)
+    {
+        if (!zylib_private_allocator_malloc(budget->parent, sizeof(zylib_private_budget_local_t), (void **)&local))
+        {
+            local = NULL;
+            goto done;
+        }
+        local->budget = budget;
+        atomic_init(&local->available, 0);
+        local->next = budget->locals;
+        budget->locals = local;
+    }
+
+    local->orphan = 0;
+    if (tss_set(budget->key, local) != thrd_success)
+    {
+        local->orphan = 1;
+        local = NULL;
+    }
+
+done:
+    mtx_unlock(&budget->lock);
+    return local;
+}
+
+ZYLIB_NONNULL
+static inline zylib_private_budget_local_t *zylib_private_budget_local(zylib_private_budget_t *budget)
+{
+    zylib_private_budget_local_t *const local = tss_get(budget->key);
+    return local != NULL ? local : zylib_private_budget_attach(budget);
+}
+
+void *zylib_private_budget_malloc(void *context, size_t size)
+{
+    zylib_private_budget_t *const budget = context;
+    zylib_private_budget_local_t *const local = zylib_private_budget_local(budget);
+    zylib_private_budget_block_t *block = NULL;
+    _Bool crossed = 0;
+    size_t live = 0;
+
+    if (local == NULL || size > SIZE_MAX - sizeof(zylib_private_budget_block_t) ||
+        !zylib_private_budget_acquire(local, size, &crossed, &live))
+    {
+        return NULL;
+    }
+
+    if (!zylib_private_allocator_malloc(budget->parent, sizeof(zylib_private_budget_block_t) + size, (void **)&block))
+    {
+        zylib_private_budget_release(local, size);
+        return NULL;
+    }
+
+    block->size = size;
+    if (crossed)
+    {
+        zylib_private_budget_notify(budget, live);
+    }
+    return block->data;
+}
+
+void *zylib_private_budget_realloc(void *context, void *ptr, size_t old_size, size_t size)
+{
+    zylib_private_budget_t *const budget = context;
+    zylib_private_budget_local_t *const local = zylib_private_budget_local(budget);
+    zylib_private_budget_block_t *block = zylib_private_budget_header(ptr);
+    const size_t x_size = block->size;
+    _Bool crossed = 0;
+    size_t live = 0;
+
+    (void)(old_size);
+
+    if (local == NULL || size > SIZE_MAX - sizeof(zylib_private_budget_block_t) ||
+        (size > x_size && !zylib_private_budget_acquire(local, size - x_size, &crossed, &live)))
+    {
+        return NULL;
+    }
+
+    if (!zylib_private_allocator_realloc_sized(budget->parent, sizeof(zylib_private_budget_block_t) + x_size,
+                                               sizeof(zylib_private_budget_block_t) + size, (void **)&block))
+    {
+        if (size > x_size)
+        {
+            zylib_private_budget_release(local, size - x_size);
+        }
+        return NULL;
+    }
+
+    block->size = size;
+    if (size < x_size)
+    {
+        zylib_private_budget_release(local, x_size - size);
+    }
+    if (crossed)
+    {
+        zylib_private_budget_notify(budget, live);
+    }
+    return block->data;
+}
+
+void zylib_private_budget_free(void *context, void *ptr, size_t size)
+{
+    zylib_private_budget_t *const budget = context;
+    zylib_private_budget_local_t *const local = zylib_private_budget_local(budget);
+    zylib_private_budget_block_t *block = zylib_private_budget_header(ptr);
+    const size_t x_size = block->size;
+
+    (void)(size);
+
+    zylib_private_allocator_free_sized(budget->parent, sizeof(zylib_private_budget_block_t) + x_size,
+                                       (void **)&block);
+    if (local != NULL)
+    {
+        zylib_private_budget_release(local, x_size);
+    }
+    else
+    {
+        atomic_fetch_sub_explicit(&budget->usage, x_size, memory_order_relaxed);
+    }
+}
+
+void zylib_private_budget_destruct(void *context)
+{
+    zylib_private_budget_t *budget = context;
+    zylib_private_budget_local_t *local = budget->locals;
+
+    tss_delete(budget->key);
+    while (local != NULL)
+    {
+        zylib_private_budget_local_t *const next = local->next;
+        zylib_private_allocator_free_sized(budget->parent, sizeof(zylib_private_budget_local_t), (void **)&local);
+        local = next;
+    }
+    mtx_destroy(&budget->lock);
+    zylib_private_allocator_free_sized(budget->parent, sizeof(zylib_private_budget_t), (void **)&budget);
+}
+
+/*
+ * Function Definitions
+ */
+
+_Bool zylib_private_budget_construct(zylib_private_allocator_t **obj, size_t soft_limit, size_t hard_limit,
+                                     zylib_allocator_pressure_t pressure, void *context,
+                                     const zylib_private_allocator_t *parent)
+{
+    _Bool r;
+    zylib_private_budget_t *budget = NULL;
+
+    *obj = NULL;
+    r = zylib_private_allocator_malloc(parent, sizeof(zylib_private_budget_t), (void **)&budget);
+    if (!r)
+    {
+        goto error;
+    }
+
+    budget->parent = parent;
+    budget->soft_limit = soft_limit;
+    budget->hard_limit = hard_limit;
+    budget->batch = hard_limit >> ZYLIB_PRIVATE_BUDGET_BATCH_SHIFT;
+    if (budget->batch > ZYLIB_PRIVATE_BUDGET_MAX_BATCH)
+    {
+        budget->batch = ZYLIB_PRIVATE_BUDGET_MAX_BATCH;
+    }
+    budget->pressure = pressure;
+    budget->context = context;
+    budget->locals = NULL;
+    atomic_init(&budget->usage, 0);
+    budget->pressured = 0;
+
+    if (mtx_init(&budget->lock, mtx_plain) != thrd_success)
+    {
+        r = 0;
+        goto error;
+    }
+
+    if (tss_create(&budget->key, zylib_private_budget_detach) != thrd_success)
+    {
+        mtx_destroy(&budget->lock);
+        r = 0;
+        goto error;
+    }
+
+    r = zylib_private_allocator_construct_context(obj, parent, &zylib_private_budget_vtable, budget);
+    if (!r)
+    {
+        tss_delete(budget->key);
+        mtx_destroy(&budget->lock);
+        goto error;
+    }
+
+    goto done;
+error:
+    if (budget != NULL)
+    {
+        zylib_private_allocator_free_sized(parent, sizeof(zylib_private_budget_t), (void **)&budget);
+    }
+done:
+    return r;
+}
@@ -0,0 +1,263 @@
+/*
+ * Copyright 2023 Alexandre Fernandez <alex@fernandezfamily.email>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "zylib_private_buffer.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+/*
+ * Macros
+ */
+
+#define ZYLIB_PRIVATE_BUFFER_MIN_CAPACITY (64U)
+
+/*
+ * Type Definitions
+ */
+
+struct zylib_private_buffer_s
+{
+    const zylib_private_allocator_t *allocator;
+    size_t size;
+    size_t capacity;
+    unsigned char *data;
+};
+
+/*
+ * Static Function Definitions
+ */
+
+/*
+ * Resize the memory region of a buffer object to exactly capacity bytes
+ */
+ZYLIB_NONNULL
+static _Bool zylib_private_buffer_resize(zylib_private_buffer_t *obj, size_t capacity)
+{
+    _Bool r;
+
+    if (capacity == 0)
+    {
+        if (obj->data != NULL)
+        {
+            zylib_private_allocator_free_sized(obj->allocator, obj->capacity, (void **)&obj->data);
+        }
+        r = 1;
+    }
+    else if (obj->data == NULL)
+    {
+        r = zylib_private_allocator_malloc(obj->allocator, capacity, (void **)&obj->data);
+    }
+    else
+    {
+        r = zylib_private_allocator_realloc_sized(obj->allocator, obj->capacity, capacity, (void **)&obj->data);
+    }
+    if (!r)
+    {
+        return 0;
+    }
+
+    obj->capacity = capacity;
+    return 1;
+}
+
+/*
+ * Make room for size more bytes, doubling the capacity so that a sequence of appends is amortized constant time
+ */
+ZYLIB_NONNULL
+static _Bool zylib_private_buffer_grow(zylib_private_buffer_t *obj, size_t size)
+{
+    size_t capacity;
+
+    if (size > SIZE_MAX - obj->size)
+    {
+        return 0;
+    }
+    if (obj->size + size <= obj->capacity)
+    {
+        return 1;
+    }
+
+    capacity = obj->capacity < SIZE_MAX / 2 ? obj->capacity * 2 : SIZE_MAX;
+    if (capacity < ZYLIB_PRIVATE_BUFFER_MIN_CAPACITY)
+    {
+        capacity = ZYLIB_PRIVATE_BUFFER_MIN_CAPACITY;
+    }
+    if (capacity < obj->size + size)
+    {
+        capacity = obj->size + size;
+    }
+
+    return zylib_private_buffer_resize(obj, capacity);
+}
+
+/*
+ * Function Definitions
+ */
+
+_Bool zylib_private_buffer_construct(zylib_private_buffer_t **obj, const zylib_private_allocator_t *allocator,
+                                     size_t capacity)
+{
+    _Bool r;
+
+    *obj = NULL;
+    r = zylib_private_allocator_malloc(allocator, sizeof(zylib_private_buffer_t), (void **)obj);
+    if (!r)
+    {
+        goto error;
+    }
+
+    (*obj)->allocator = allocator;
+    (*obj)->size = 0;
+    (*obj)->capacity = 0;
+    (*obj)->data = NULL;
+
+    r = zylib_private_buffer_resize(*obj, capacity);
+    if (!r)
+    {
+        goto error;
+    }
+
+    goto done;
+error:
+    zylib_private_buffer_destruct(obj);
+done:
+    return r;
+}
+
+void zylib_private_buffer_destruct(zylib_private_buffer_t **obj)
+{
+    if (*obj != NULL)
+    {
+        if ((*obj)->data != NULL)
+        {
+            zylib_private_allocator_free_sized((*obj)->allocator, (*obj)->capacity, (void **)&(*obj)->data);
+        }
+        zylib_private_allocator_free_sized((*obj)->allocator, sizeof(zylib_private_buffer_t), (void **)obj);
+    }
+}
+
+_Bool zylib_private_buffer_reserve(zylib_private_buffer_t *obj, size_t capacity)
+{
+    if (capacity <= obj->capacity)
+    {
+        return 1;
+    }
+
+    return zylib_private_buffer_resize(obj, capacity);
+}
+
+_Bool zylib_private_buffer_shrink_to_fit(zylib_private_buffer_t *obj)
+{
+    if (obj->size == obj->capacity)
+    {
+        return 1;
+    }
+
+    return zylib_private_buffer_resize(obj, obj->size);
+}
+
+_Bool zylib_private_buffer_append(zylib_private_buffer_t *obj, size_t size, const void *ptr)
+{
+    _Bool r;
+
+    r = zylib_private_buffer_grow(obj, size);
+    if (!r)
+    {
+        return 0;
+    }
+
+    if (size > 0)
+    {
+        memcpy(&obj->data[obj->size], ptr, size);
+        obj->size += size;
+    }
+
+    return 1;
+}
+
+_Bool zylib_private_buffer_append_vformat(zylib_private_buffer_t *obj, const char *format, va_list args)
+{
+    _Bool r;
+    int n;
+    va_list copy;
+
+    /* The text is formatted straight into the spare capacity, and formatted again only if it does not fit */
+    va_copy(copy, args);
+    n = vsnprintf(obj->data != NULL ? (char *)&obj->data[obj->size] : NULL, obj->capacity - obj->size, format, copy);
+    va_end(copy);
+    if (n < 0)
+    {
+        return 0;
+    }
+
+    if ((size_t)n >= obj->capacity - obj->size)
+    {
+        r = zylib_private_buffer_grow(obj, (size_t)n + 1);
+        if (!r)
+        {
+            return 0;
+        }
+
+        vsnprintf((char *)&obj->data[obj->size], obj->capacity - obj->size, format, args);
+    }
+
+    obj->size += (size_t)n;
+    return 1;
+}
+
+void zylib_private_buffer_clear(zylib_private_buffer_t *obj)
+{
+    obj->size = 0;
+}
+
+_Bool zylib_private_buffer_detach(zylib_private_buffer_t *obj, size_t *size, void **ptr)
+{
+    _Bool r;
+
+    if (obj->size == 0)
+    {
+        return 0;
+    }
+
+    r = zylib_private_buffer_shrink_to_fit(obj);
+    if (!r)
+    {
+        return 0;
+    }
+
+    *size = obj->size;
+    *ptr = obj->data;
+    obj->size = 0;
+    obj->capacity = 0;
+    obj->data = NULL;
+
+    return 1;
+}
+
+size_t zylib_private_buffer_peek_size(const zylib_private_buffer_t *obj)
+{
+    return obj->size;
+}
+
+size_t zylib_private_buffer_peek_capacity(const zylib_private_buffer_t *obj)
+{
+    return obj->capacity;
+}
+
+void *zylib_private_buffer_peek_data(const zylib_private_buffer_t *obj)
+{
+    return obj->data;
+}
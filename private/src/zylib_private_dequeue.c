@@ -15,21 +15,129 @@
  */
 #include "zylib_private_dequeue.h"
 #include "zylib_private_box.h"
+#include <string.h>
+
+/*
+ * Macros
+ */
+
+/* The number of elements stored by each block of a blocked dequeue; a power of two */
+#define ZYLIB_PRIVATE_DEQUEUE_BLOCK_LENGTH ((size_t)64)
+
+/* The size of the chunks of a packed dequeue, including their header */
+#define ZYLIB_PRIVATE_DEQUEUE_CHUNK_SIZE ((size_t)4096)
+
+/* The number of bytes of a chunk of a packed dequeue that can hold records, unless it was sized for a larger one */
+#define ZYLIB_PRIVATE_DEQUEUE_CHUNK_CAPACITY \
+    (ZYLIB_PRIVATE_DEQUEUE_CHUNK_SIZE - offsetof(zylib_private_dequeue_chunk_t, data))
+
+/* The number of records a chunk of a packed dequeue can receive over its lifetime, as each takes at least 2 bytes */
+#define ZYLIB_PRIVATE_DEQUEUE_CHUNK_RECORD_MAX (ZYLIB_PRIVATE_DEQUEUE_CHUNK_CAPACITY / 2)
+
+/* The initial number of elements of the ring of a fixed-size dequeue; a power of two */
+#define ZYLIB_PRIVATE_DEQUEUE_RING_MIN_CAPACITY ((size_t)16)
 
 /*
  * Type Definitions
  */
 
+/*
+ * How the elements of a dequeue are stored
+ */
+typedef enum zylib_private_dequeue_mode_e
+{
+    /* Each element has its own node, linked to its neighbors */
+    ZYLIB_PRIVATE_DEQUEUE_MODE_LINKED,
+    /* Elements are stored in a ring of fixed-size blocks of slots */
+    ZYLIB_PRIVATE_DEQUEUE_MODE_BLOCKED,
+    /* Elements are copied back-to-back into chunks as records framed by their size */
+    ZYLIB_PRIVATE_DEQUEUE_MODE_PACKED,
+    /* Elements of a single size are copied into a ring */
+    ZYLIB_PRIVATE_DEQUEUE_MODE_FIXED
+} zylib_private_dequeue_mode_t;
+
+/*
+ * Where the memory region of an element is stored
+ */
+typedef enum zylib_private_dequeue_slot_kind_e
+{
+    ZYLIB_PRIVATE_DEQUEUE_SLOT_KIND_INLINE,
+    ZYLIB_PRIVATE_DEQUEUE_SLOT_KIND_BOX,
+    ZYLIB_PRIVATE_DEQUEUE_SLOT_KIND_SHARED,
+    ZYLIB_PRIVATE_DEQUEUE_SLOT_KIND_ROPE
+} zylib_private_dequeue_slot_kind_t;
+
+/*
+ * The memory region of an element; slots hold no pointers to themselves, so they can be moved with memcpy()
+ */
+typedef struct zylib_private_dequeue_slot_s
+{
+    /* The size of the memory region if it is stored inline */
+    uint64_t size;
+    zylib_private_dequeue_slot_kind_t kind;
+    union {
+        zylib_private_box_t *box;
+        zylib_private_shared_box_t *shared;
+        zylib_private_rope_t *rope;
+        max_align_t data[(ZYLIB_BOX_INLINE_CAPACITY + sizeof(max_align_t) - 1) / sizeof(max_align_t)];
+    };
+} zylib_private_dequeue_slot_t;
+
+/*
+ * The node of a linked dequeue, allocated together with its memory region: when it is stored inline, the region starts
+ * at slot.data and extends past the end of the node if it does not fit
+ */
 typedef struct zylib_private_dequeue_box_s
 {
     struct zylib_private_dequeue_box_s *previous, *next;
-    zylib_private_box_t *box;
+    zylib_private_dequeue_slot_t slot;
 } zylib_private_dequeue_box_t;
 
+/*
+ * A chunk of a packed dequeue, whose records are stored within [begin, end).
+ * A record is the size of its memory region as a varint followed by the memory region, so records can only be read
+ * from the beginning of a chunk; the dequeue indexes the records of its last chunk to pop them from the end.
+ */
+typedef struct zylib_private_dequeue_chunk_s
+{
+    struct zylib_private_dequeue_chunk_s *previous, *next;
+    size_t capacity;
+    size_t begin, end;
+    max_align_t data[];
+} zylib_private_dequeue_chunk_t;
+
+_Static_assert(ZYLIB_BOX_INLINE_CAPACITY > 0, "ZYLIB_BOX_INLINE_CAPACITY must be positive");
+_Static_assert(ZYLIB_PRIVATE_DEQUEUE_CHUNK_SIZE <= UINT16_MAX, "The records of a chunk must be indexed by uint16_t");
+
 struct zylib_private_dequeue_s
 {
     const zylib_private_allocator_t *allocator;
+    /* Pools of nodes holding up to ZYLIB_BOX_INLINE_CAPACITY and ZYLIB_PRIVATE_BOX_POOL_CAPACITY bytes inline */
+    zylib_private_pool_t *node_pool, *large_node_pool;
     zylib_private_dequeue_box_t *first, *last;
+    zylib_private_dequeue_chunk_t *first_chunk, *last_chunk;
+    /*
+     * The offsets of the records of the last chunk of a packed dequeue, stored in tail[tail_first, tail_end) out of
+     * 2 * ZYLIB_PRIVATE_DEQUEUE_CHUNK_RECORD_MAX; the index restarts from the middle whenever the last chunk changes,
+     * so records pushed to either end of it always fit, and it is rebuilt by walking a chunk when its successor is
+     * removed
+     */
+    uint16_t *tail;
+    size_t tail_first, tail_end;
+    /*
+     * The ring of blocks of a blocked dequeue, whose capacity is block_n * ZYLIB_PRIVATE_DEQUEUE_BLOCK_LENGTH elements;
+     * element i is stored at position (head + i) modulo the capacity, and blocks are allocated on first use
+     */
+    zylib_private_dequeue_slot_t **blocks;
+    size_t block_n;
+    /*
+     * The ring of a fixed-size dequeue, whose capacity is element_capacity elements, a power of two; element i is
+     * stored at position (head + i) modulo the capacity
+     */
+    unsigned char *elements;
+    size_t element_size, element_capacity;
+    size_t head;
+    zylib_private_dequeue_mode_t mode;
     size_t size;
 };
 
@@ -38,120 +146,266 @@ struct zylib_private_dequeue_s
  */
 
 ZYLIB_NONNULL
-static inline void zylib_private_dequeue_box_destruct(zylib_private_dequeue_box_t **const obj,
-                                                      const zylib_private_allocator_t *const allocator)
+static void zylib_private_dequeue_slot_destruct(zylib_private_dequeue_slot_t *const obj)
 {
-    if (*obj != NULL)
+    switch (obj->kind)
     {
-        if ((*obj)->box != NULL)
-        {
-            zylib_private_box_destruct(&(*obj)->box);
-        }
-        zylib_private_allocator_free(allocator, (void **)obj);
+    case ZYLIB_PRIVATE_DEQUEUE_SLOT_KIND_BOX:
+        zylib_private_box_destruct(&obj->box);
+        break;
+    case ZYLIB_PRIVATE_DEQUEUE_SLOT_KIND_SHARED:
+        zylib_private_shared_box_destruct(&obj->shared);
+        break;
+    case ZYLIB_PRIVATE_DEQUEUE_SLOT_KIND_ROPE:
+        zylib_private_rope_destruct(&obj->rope);
+        break;
+    case ZYLIB_PRIVATE_DEQUEUE_SLOT_KIND_INLINE:
+        break;
+    }
+    obj->size = 0;
+    obj->kind = ZYLIB_PRIVATE_DEQUEUE_SLOT_KIND_INLINE;
+}
+
+/*
+ * Retrieve the memory region of a slot; ropes are flattened when they are inserted, so this never modifies the slot
+ */
+ZYLIB_NONNULL
+static inline _Bool zylib_private_dequeue_slot_peek(const zylib_private_dequeue_slot_t *const obj, uint64_t *size,
+                                                    const void **data)
+{
+    switch (obj->kind)
+    {
+    case ZYLIB_PRIVATE_DEQUEUE_SLOT_KIND_INLINE:
+        *size = obj->size;
+        *data = obj->data;
+        return 1;
+    case ZYLIB_PRIVATE_DEQUEUE_SLOT_KIND_BOX:
+        *size = zylib_private_box_peek_size(obj->box);
+        *data = zylib_private_box_peek_data(obj->box);
+        return 1;
+    case ZYLIB_PRIVATE_DEQUEUE_SLOT_KIND_SHARED:
+        *size = zylib_private_shared_box_peek_size(obj->shared);
+        *data = zylib_private_shared_box_peek_data(obj->shared);
+        return 1;
+    case ZYLIB_PRIVATE_DEQUEUE_SLOT_KIND_ROPE: {
+        const void *iterator = NULL;
+        return zylib_private_rope_next(obj->rope, &iterator, size, data);
+    }
     }
+    return 0;
 }
 
 ZYLIB_NONNULL
-static _Bool zylib_private_dequeue_box_construct(zylib_private_dequeue_box_t **const obj,
-                                                 const zylib_private_allocator_t *const allocator, size_t size,
-                                                 const void *data)
+static _Bool zylib_private_dequeue_slot_construct(zylib_private_dequeue_slot_t *const obj,
+                                                  const zylib_private_dequeue_t *const dequeue, size_t size,
+                                                  const void *data)
 {
     _Bool r;
 
-    *obj = NULL;
-    r = zylib_private_allocator_malloc(allocator, sizeof(zylib_private_dequeue_box_t), (void **)obj);
-    if (!r)
+    /* The nodes of a linked dequeue are allocated with enough room for their memory region */
+    if (size <= ZYLIB_BOX_INLINE_CAPACITY || dequeue->mode == ZYLIB_PRIVATE_DEQUEUE_MODE_LINKED)
     {
-        goto error;
+        obj->size = size;
+        memcpy(obj->data, data, size);
+        return 1;
     }
 
-    (*obj)->box = NULL;
-    r = zylib_private_box_construct(&(*obj)->box, allocator, size, data);
+    r = zylib_private_box_construct(&obj->box, dequeue->allocator, size, data);
     if (!r)
     {
-        goto error;
+        return 0;
     }
 
-    (*obj)->previous = NULL;
-    (*obj)->next = NULL;
+    obj->kind = ZYLIB_PRIVATE_DEQUEUE_SLOT_KIND_BOX;
+    return 1;
+}
 
-    goto done;
-error:
-    zylib_private_dequeue_box_destruct(obj, allocator);
-done:
-    return r;
+ZYLIB_NONNULL
+static _Bool zylib_private_dequeue_slot_adopt(zylib_private_dequeue_slot_t *const obj,
+                                              const zylib_private_dequeue_t *const dequeue, size_t size, void **data)
+{
+    _Bool r;
+
+    r = zylib_private_box_adopt(&obj->box, dequeue->allocator, size, data);
+    if (!r)
+    {
+        return 0;
+    }
+
+    obj->kind = ZYLIB_PRIVATE_DEQUEUE_SLOT_KIND_BOX;
+    return 1;
 }
 
-/*
- * Function Definitions
- */
+ZYLIB_NONNULL
+static _Bool zylib_private_dequeue_slot_share(zylib_private_dequeue_slot_t *const obj, zylib_private_shared_box_t *box)
+{
+    zylib_private_shared_box_acquire(box);
+    obj->kind = ZYLIB_PRIVATE_DEQUEUE_SLOT_KIND_SHARED;
+    obj->shared = box;
 
-_Bool zylib_private_dequeue_construct(zylib_private_dequeue_t **obj, const zylib_private_allocator_t *allocator)
+    return 1;
+}
+
+ZYLIB_NONNULL
+static _Bool zylib_private_dequeue_slot_adopt_rope(zylib_private_dequeue_slot_t *const obj,
+                                                   zylib_private_rope_t **rope)
 {
     _Bool r;
+    const void *data;
 
-    *obj = NULL;
-    r = zylib_private_allocator_malloc(allocator, sizeof(zylib_private_dequeue_t), (void **)obj);
+    if (zylib_private_rope_peek_size(*rope) <= 0)
+    {
+        return 0;
+    }
+
+    /* Flattening up front lets const readers retrieve the rope as a single segment without modifying it */
+    r = zylib_private_rope_flatten(*rope, &data);
     if (!r)
     {
-        goto error;
+        return 0;
     }
 
-    (*obj)->allocator = allocator;
-    (*obj)->first = NULL;
-    (*obj)->last = NULL;
-    (*obj)->size = 0;
+    obj->kind = ZYLIB_PRIVATE_DEQUEUE_SLOT_KIND_ROPE;
+    obj->rope = *rope;
+    *rope = NULL;
 
-    goto done;
-error:
-    if (*obj != NULL)
+    return 1;
+}
+
+/*
+ * Hand the memory region of a slot back to the caller; the slot must be deconstructed afterwards
+ */
+ZYLIB_NONNULL
+static _Bool zylib_private_dequeue_slot_release(zylib_private_dequeue_slot_t *const obj,
+                                                const zylib_private_dequeue_t *const dequeue, uint64_t *size,
+                                                void **data)
+{
+    _Bool r;
+
+    uint64_t region_size;
+    const void *region;
+
+    if (obj->kind == ZYLIB_PRIVATE_DEQUEUE_SLOT_KIND_BOX)
     {
-        zylib_private_allocator_free(allocator, (void **)obj);
+        r = zylib_private_box_release(&obj->box, size, data);
+    }
+    else if (obj->kind == ZYLIB_PRIVATE_DEQUEUE_SLOT_KIND_ROPE)
+    {
+        r = zylib_private_rope_release(&obj->rope, size, data);
+    }
+    else
+    {
+        /* Inline memory regions are copied out, and so are shared ones since other elements may still view them */
+        r = zylib_private_dequeue_slot_peek(obj, &region_size, &region);
+        if (!r)
+        {
+            return 0;
+        }
+        *data = NULL;
+        r = zylib_private_allocator_malloc(dequeue->allocator, region_size, data);
+        if (r)
+        {
+            *size = region_size;
+            memcpy(*data, region, region_size);
+        }
     }
-done:
     return r;
 }
 
-void zylib_private_dequeue_destruct(zylib_private_dequeue_t **obj)
+static inline size_t zylib_private_dequeue_box_get_allocation_size(size_t size)
 {
-    if (*obj != NULL)
+    return size <= ZYLIB_BOX_INLINE_CAPACITY ? sizeof(zylib_private_dequeue_box_t)
+                                             : offsetof(zylib_private_dequeue_box_t, slot.data) + size;
+}
+
+/*
+ * Retrieve the pool object that a node holding a memory region of the given size inline is allocated from, if any
+ */
+ZYLIB_NONNULL
+static inline zylib_private_pool_t *zylib_private_dequeue_box_get_pool(const zylib_private_dequeue_t *const dequeue,
+                                                                       size_t size)
+{
+    if (size <= ZYLIB_BOX_INLINE_CAPACITY)
     {
-        zylib_private_dequeue_clear(*obj);
-        zylib_private_allocator_free((*obj)->allocator, (void **)obj);
+        return dequeue->node_pool;
+    }
+    if (size <= ZYLIB_PRIVATE_BOX_POOL_CAPACITY)
+    {
+        return dequeue->large_node_pool;
     }
+    return NULL;
 }
 
-void zylib_private_dequeue_clear(zylib_private_dequeue_t *obj)
+ZYLIB_NONNULL
+static inline void zylib_private_dequeue_box_destruct(zylib_private_dequeue_box_t **const obj,
+                                                      const zylib_private_dequeue_t *const dequeue)
 {
-
-    zylib_private_dequeue_box_t *box = obj->first;
-    while (box != NULL)
+    if (*obj != NULL)
     {
-        zylib_private_dequeue_box_t *const next = box->next;
-        zylib_private_dequeue_box_destruct(&box, obj->allocator);
-        box = next;
+        /* Only inline memory regions are sized, the node of any other kind has the default size */
+        const size_t size = (*obj)->slot.kind == ZYLIB_PRIVATE_DEQUEUE_SLOT_KIND_INLINE ? (*obj)->slot.size : 0;
+        zylib_private_pool_t *const pool = zylib_private_dequeue_box_get_pool(dequeue, size);
+
+        zylib_private_dequeue_slot_destruct(&(*obj)->slot);
+        if (pool != NULL)
+        {
+            zylib_private_pool_free(pool, (void **)obj);
+        }
+        else
+        {
+            zylib_private_allocator_free_sized(dequeue->allocator, zylib_private_dequeue_box_get_allocation_size(size),
+                                               (void **)obj);
+        }
     }
-    obj->first = NULL;
-    obj->last = NULL;
-    obj->size = 0;
 }
 
-_Bool zylib_private_dequeue_push_first(zylib_private_dequeue_t *obj, uint64_t size, const void *data)
+/*
+ * Allocate a node with room for a memory region of the given size inline, which is 0 for any other kind of node
+ */
+ZYLIB_NONNULL
+static _Bool zylib_private_dequeue_box_allocate(zylib_private_dequeue_box_t **const obj,
+                                                const zylib_private_dequeue_t *const dequeue, size_t size)
 {
     _Bool r;
-    zylib_private_dequeue_box_t *box = NULL;
+    zylib_private_pool_t *const pool = zylib_private_dequeue_box_get_pool(dequeue, size);
 
-    if (size <= 0)
+    *obj = NULL;
+    if (pool != NULL)
     {
-        return 0;
+        r = zylib_private_pool_malloc(pool, (void **)obj);
+    }
+    else if (size <= SIZE_MAX - offsetof(zylib_private_dequeue_box_t, slot.data))
+    {
+        r = zylib_private_allocator_malloc(dequeue->allocator, zylib_private_dequeue_box_get_allocation_size(size),
+                                           (void **)obj);
+    }
+    else
+    {
+        r = 0;
     }
-
-    r = zylib_private_dequeue_box_construct(&box, obj->allocator, size, data);
     if (!r)
     {
-        goto error;
+        return 0;
     }
 
+    (*obj)->previous = NULL;
+    (*obj)->next = NULL;
+    (*obj)->slot.size = 0;
+    (*obj)->slot.kind = ZYLIB_PRIVATE_DEQUEUE_SLOT_KIND_INLINE;
+
+    return 1;
+}
+
+ZYLIB_NONNULL
+static inline zylib_private_dequeue_box_t *zylib_private_dequeue_box_of(zylib_private_dequeue_slot_t *const slot)
+{
+    return (zylib_private_dequeue_box_t *)((unsigned char *)slot - offsetof(zylib_private_dequeue_box_t, slot));
+}
+
+ZYLIB_NONNULL
+static inline void zylib_private_dequeue_link_first(zylib_private_dequeue_t *const obj,
+                                                    zylib_private_dequeue_box_t *const box)
+{
     if (!zylib_private_dequeue_is_empty(obj))
     {
         box->next = obj->first;
@@ -164,27 +418,12 @@ _Bool zylib_private_dequeue_push_first(zylib_private_dequeue_t *obj, uint64_t si
         obj->last = box;
     }
     ++obj->size;
-
-error:
-    return r;
 }
 
-_Bool zylib_private_dequeue_push_last(zylib_private_dequeue_t *obj, uint64_t size, const void *data)
+ZYLIB_NONNULL
+static inline void zylib_private_dequeue_link_last(zylib_private_dequeue_t *const obj,
+                                                   zylib_private_dequeue_box_t *const box)
 {
-    _Bool r;
-    zylib_private_dequeue_box_t *box;
-
-    if (size <= 0)
-    {
-        return 0;
-    }
-
-    r = zylib_private_dequeue_box_construct(&box, obj->allocator, size, data);
-    if (!r)
-    {
-        goto error;
-    }
-
     if (!zylib_private_dequeue_is_empty(obj))
     {
         box->previous = obj->last;
@@ -197,75 +436,1524 @@ _Bool zylib_private_dequeue_push_last(zylib_private_dequeue_t *obj, uint64_t siz
         obj->last = box;
     }
     ++obj->size;
-
-error:
-    return r;
 }
 
-void zylib_private_dequeue_discard_first(zylib_private_dequeue_t *obj)
+/*
+ * Unlink and deconstruct the node at the beginning of a non-empty linked dequeue
+ */
+ZYLIB_NONNULL
+static inline void zylib_private_dequeue_unlink_first(zylib_private_dequeue_t *const obj)
 {
-    if (!zylib_private_dequeue_is_empty(obj))
+    zylib_private_dequeue_box_t *box = obj->first;
+    if (box->next != NULL)
     {
-        zylib_private_dequeue_box_t *box = obj->first;
-        if (box->next != NULL)
-        {
-            box->next->previous = NULL;
-            obj->first = box->next;
-        }
-        else
-        {
-            obj->first = NULL;
-            obj->last = NULL;
-        }
-        zylib_private_dequeue_box_destruct(&box, obj->allocator);
-        --obj->size;
+        box->next->previous = NULL;
+        obj->first = box->next;
     }
+    else
+    {
+        obj->first = NULL;
+        obj->last = NULL;
+    }
+    zylib_private_dequeue_box_destruct(&box, obj);
+    --obj->size;
 }
 
-void zylib_private_dequeue_discard_last(zylib_private_dequeue_t *obj)
+/*
+ * Unlink and deconstruct the node at the end of a non-empty linked dequeue
+ */
+ZYLIB_NONNULL
+static inline void zylib_private_dequeue_unlink_last(zylib_private_dequeue_t *const obj)
 {
-    if (!zylib_private_dequeue_is_empty(obj))
+    zylib_private_dequeue_box_t *box = obj->last;
+    if (box->previous != NULL)
     {
-        zylib_private_dequeue_box_t *box = obj->last;
-        if (box->previous != NULL)
-        {
-            box->previous->next = NULL;
-            obj->last = box->previous;
-        }
-        else
-        {
-            obj->first = NULL;
-            obj->last = NULL;
-        }
-        zylib_private_dequeue_box_destruct(&box, obj->allocator);
-        --obj->size;
+        box->previous->next = NULL;
+        obj->last = box->previous;
+    }
+    else
+    {
+        obj->first = NULL;
+        obj->last = NULL;
     }
+    zylib_private_dequeue_box_destruct(&box, obj);
+    --obj->size;
 }
 
-_Bool zylib_private_dequeue_peek_first(const zylib_private_dequeue_t *obj, uint64_t *size, const void **data)
+/*
+ * Retrieve whether the elements of a dequeue are stored in slots, as opposed to being copied into chunks or a ring
+ */
+ZYLIB_NONNULL
+static inline _Bool zylib_private_dequeue_has_slots(const zylib_private_dequeue_t *const obj)
 {
-    if (!zylib_private_dequeue_is_empty(obj))
-    {
-        *size = zylib_private_box_peek_size(obj->first->box);
-        *data = zylib_private_box_peek_data(obj->first->box);
-        return 1;
-    }
-    *size = 0;
-    *data = NULL;
-    return 0;
+    return obj->mode == ZYLIB_PRIVATE_DEQUEUE_MODE_LINKED || obj->mode == ZYLIB_PRIVATE_DEQUEUE_MODE_BLOCKED;
 }
 
-_Bool zylib_private_dequeue_peek_last(const zylib_private_dequeue_t *obj, uint64_t *size, const void **data)
+ZYLIB_NONNULL
+static inline size_t zylib_private_dequeue_capacity(const zylib_private_dequeue_t *const obj)
 {
-    if (!zylib_private_dequeue_is_empty(obj))
+    return obj->block_n * ZYLIB_PRIVATE_DEQUEUE_BLOCK_LENGTH;
+}
+
+/*
+ * Retrieve the slot at a position of the ring of blocks; its block must be allocated
+ */
+ZYLIB_NONNULL
+static inline zylib_private_dequeue_slot_t *zylib_private_dequeue_block_slot(const zylib_private_dequeue_t *const obj,
+                                                                            size_t position)
+{
+    return &obj->blocks[position / ZYLIB_PRIVATE_DEQUEUE_BLOCK_LENGTH][position % ZYLIB_PRIVATE_DEQUEUE_BLOCK_LENGTH];
+}
+
+/*
+ * Double the capacity of a full blocked dequeue.
+ * The blocks are rotated so that the block holding the first element comes first; if that block also holds the last
+ * elements, they are moved to a new block that follows the old ones.
+ */
+ZYLIB_NONNULL
+static _Bool zylib_private_dequeue_grow(zylib_private_dequeue_t *const obj)
+{
+    _Bool r;
+
+    const size_t block_n = obj->block_n > 0 ? obj->block_n * 2 : 1;
+    const size_t first_block = obj->head / ZYLIB_PRIVATE_DEQUEUE_BLOCK_LENGTH;
+    const size_t offset = obj->head % ZYLIB_PRIVATE_DEQUEUE_BLOCK_LENGTH;
+    zylib_private_dequeue_slot_t **blocks = NULL;
+
+    if (block_n > SIZE_MAX / (sizeof(zylib_private_dequeue_slot_t) * ZYLIB_PRIVATE_DEQUEUE_BLOCK_LENGTH))
     {
-        *size = zylib_private_box_peek_size(obj->last->box);
-        *data = zylib_private_box_peek_data(obj->last->box);
-        return 1;
+        return 0;
     }
-    *size = 0;
-    *data = NULL;
-    return 0;
+
+    r = zylib_private_allocator_malloc(obj->allocator, block_n * sizeof(zylib_private_dequeue_slot_t *),
+                                       (void **)&blocks);
+    if (!r)
+    {
+        return 0;
+    }
+
+    for (size_t i = 0; i < block_n; ++i)
+    {
+        blocks[i] = i < obj->block_n ? obj->blocks[(first_block + i) % obj->block_n] : NULL;
+    }
+
+    if (offset != 0)
+    {
+        r = zylib_private_allocator_malloc(obj->allocator,
+                                           ZYLIB_PRIVATE_DEQUEUE_BLOCK_LENGTH * sizeof(zylib_private_dequeue_slot_t),
+                                           (void **)&blocks[obj->block_n]);
+        if (!r)
+        {
+            zylib_private_allocator_free_sized(obj->allocator, block_n * sizeof(zylib_private_dequeue_slot_t *),
+                                               (void **)&blocks);
+            return 0;
+        }
+        memcpy(blocks[obj->block_n], blocks[0], offset * sizeof(zylib_private_dequeue_slot_t));
+    }
+
+    if (obj->blocks != NULL)
+    {
+        zylib_private_allocator_free_sized(obj->allocator, obj->block_n * sizeof(zylib_private_dequeue_slot_t *),
+                                           (void **)&obj->blocks);
+    }
+    obj->blocks = blocks;
+    obj->block_n = block_n;
+    obj->head = offset;
+
+    return 1;
+}
+
+/*
+ * Reserve an empty slot for a new element at the beginning or the end of a dequeue, with room for a memory region of
+ * the given size inline in a linked dequeue.
+ * The element is only inserted by zylib_private_dequeue_commit(), once its slot is filled.
+ */
+ZYLIB_NONNULL
+static zylib_private_dequeue_slot_t *zylib_private_dequeue_reserve(zylib_private_dequeue_t *const obj, _Bool first,
+                                                                   size_t size)
+{
+    _Bool r;
+    size_t position;
+    zylib_private_dequeue_slot_t **block;
+
+    /* Packed and fixed-size dequeues only hold copies of memory regions */
+    if (!zylib_private_dequeue_has_slots(obj))
+    {
+        return NULL;
+    }
+
+    if (obj->mode == ZYLIB_PRIVATE_DEQUEUE_MODE_LINKED)
+    {
+        zylib_private_dequeue_box_t *box = NULL;
+        r = zylib_private_dequeue_box_allocate(&box, obj, size);
+        return r ? &box->slot : NULL;
+    }
+
+    if (obj->size == zylib_private_dequeue_capacity(obj))
+    {
+        r = zylib_private_dequeue_grow(obj);
+        if (!r)
+        {
+            return NULL;
+        }
+    }
+
+    position = (first ? obj->head + zylib_private_dequeue_capacity(obj) - 1 : obj->head + obj->size) %
+               zylib_private_dequeue_capacity(obj);
+    block = &obj->blocks[position / ZYLIB_PRIVATE_DEQUEUE_BLOCK_LENGTH];
+    if (*block == NULL)
+    {
+        r = zylib_private_allocator_malloc(obj->allocator,
+                                           ZYLIB_PRIVATE_DEQUEUE_BLOCK_LENGTH * sizeof(zylib_private_dequeue_slot_t),
+                                           (void **)block);
+        if (!r)
+        {
+            return NULL;
+        }
+    }
+
+    (*block)[position % ZYLIB_PRIVATE_DEQUEUE_BLOCK_LENGTH].size = 0;
+    (*block)[position % ZYLIB_PRIVATE_DEQUEUE_BLOCK_LENGTH].kind = ZYLIB_PRIVATE_DEQUEUE_SLOT_KIND_INLINE;
+    return &(*block)[position % ZYLIB_PRIVATE_DEQUEUE_BLOCK_LENGTH];
+}
+
+/*
+ * Insert the element held by a slot from zylib_private_dequeue_reserve() if it was filled, or give the slot back
+ */
+ZYLIB_NONNULL
+static void zylib_private_dequeue_commit(zylib_private_dequeue_t *const obj, zylib_private_dequeue_slot_t *const slot,
+                                         _Bool first, _Bool filled)
+{
+    if (obj->mode == ZYLIB_PRIVATE_DEQUEUE_MODE_LINKED)
+    {
+        zylib_private_dequeue_box_t *box = zylib_private_dequeue_box_of(slot);
+        if (!filled)
+        {
+            zylib_private_dequeue_box_destruct(&box, obj);
+        }
+        else if (first)
+        {
+            zylib_private_dequeue_link_first(obj, box);
+        }
+        else
+        {
+            zylib_private_dequeue_link_last(obj, box);
+        }
+    }
+    else if (filled)
+    {
+        if (first)
+        {
+            obj->head = (obj->head + zylib_private_dequeue_capacity(obj) - 1) % zylib_private_dequeue_capacity(obj);
+        }
+        ++obj->size;
+    }
+}
+
+/*
+ * Retrieve the number of bytes of a size encoded as a varint
+ */
+static inline size_t zylib_private_dequeue_varint_get_size(size_t value)
+{
+    size_t n = 1;
+    while (value >= 0x80)
+    {
+        value >>= 7;
+        ++n;
+    }
+    return n;
+}
+
+ZYLIB_NONNULL
+static void zylib_private_dequeue_record_write(unsigned char *const record, size_t size, const void *data)
+{
+    const size_t varint_size = zylib_private_dequeue_varint_get_size(size);
+
+    for (size_t i = 0; i < varint_size; ++i)
+    {
+        record[i] = (unsigned char)(((size >> (7 * i)) & 0x7F) | (i + 1 < varint_size ? 0x80 : 0));
+    }
+    memcpy(record + varint_size, data, size);
+}
+
+/*
+ * Read the record starting at an offset of a chunk
+ * @return The size of the record
+ */
+ZYLIB_NONNULL
+static size_t zylib_private_dequeue_record_read_first(const zylib_private_dequeue_chunk_t *const chunk, size_t offset,
+                                                      uint64_t *size, const void **data)
+{
+    const unsigned char *const record = (const unsigned char *)chunk->data + offset;
+    size_t region_size = 0, varint_size = 0;
+
+    do
+    {
+        region_size |= (size_t)(record[varint_size] & 0x7F) << (7 * varint_size);
+    } while (record[varint_size++] & 0x80);
+
+    *size = region_size;
+    *data = record + varint_size;
+    return varint_size + region_size;
+}
+
+/*
+ * Retrieve the offset of the record ending at an offset of a chunk of a packed dequeue, looking it up in the index of
+ * the last chunk, or walking the chunk from its beginning otherwise
+ */
+ZYLIB_NONNULL
+static size_t zylib_private_dequeue_record_before(const zylib_private_dequeue_t *const obj,
+                                                  const zylib_private_dequeue_chunk_t *const chunk, size_t offset)
+{
+    uint64_t size;
+    const void *data;
+    size_t previous = chunk->begin;
+
+    if (chunk == obj->last_chunk)
+    {
+        size_t low = obj->tail_first, high = obj->tail_end;
+        while (low < high)
+        {
+            const size_t middle = low + (high - low) / 2;
+            if (obj->tail[middle] < offset)
+            {
+                low = middle + 1;
+            }
+            else
+            {
+                high = middle;
+            }
+        }
+        return obj->tail[low - 1];
+    }
+
+    for (size_t current = chunk->begin; current != offset;
+         current += zylib_private_dequeue_record_read_first(chunk, current, &size, &data))
+    {
+        previous = current;
+    }
+    return previous;
+}
+
+/*
+ * Index the records of the last chunk of a packed dequeue
+ */
+ZYLIB_NONNULL
+static void zylib_private_dequeue_tail_rebuild(zylib_private_dequeue_t *const obj)
+{
+    uint64_t size;
+    const void *data;
+    const zylib_private_dequeue_chunk_t *const chunk = obj->last_chunk;
+
+    obj->tail_first = ZYLIB_PRIVATE_DEQUEUE_CHUNK_RECORD_MAX;
+    obj->tail_end = obj->tail_first;
+    for (size_t offset = chunk->begin; offset != chunk->end;
+         offset += zylib_private_dequeue_record_read_first(chunk, offset, &size, &data))
+    {
+        obj->tail[obj->tail_end++] = (uint16_t)offset;
+    }
+}
+
+/*
+ * Construct an empty chunk that can hold at least a record of the given size, to be filled from its beginning or its
+ * end
+ */
+ZYLIB_NONNULL
+static _Bool zylib_private_dequeue_chunk_construct(zylib_private_dequeue_chunk_t **const obj,
+                                                   const zylib_private_dequeue_t *const dequeue, size_t record_size,
+                                                   _Bool first)
+{
+    _Bool r;
+
+    const size_t capacity =
+        record_size > ZYLIB_PRIVATE_DEQUEUE_CHUNK_CAPACITY ? record_size : ZYLIB_PRIVATE_DEQUEUE_CHUNK_CAPACITY;
+
+    if (record_size > SIZE_MAX - offsetof(zylib_private_dequeue_chunk_t, data))
+    {
+        return 0;
+    }
+
+    *obj = NULL;
+    r = zylib_private_allocator_malloc(dequeue->allocator, offsetof(zylib_private_dequeue_chunk_t, data) + capacity,
+                                       (void **)obj);
+    if (!r)
+    {
+        return 0;
+    }
+
+    (*obj)->previous = NULL;
+    (*obj)->next = NULL;
+    (*obj)->capacity = capacity;
+    (*obj)->begin = first ? capacity : 0;
+    (*obj)->end = (*obj)->begin;
+
+    return 1;
+}
+
+ZYLIB_NONNULL
+static inline void zylib_private_dequeue_chunk_destruct(zylib_private_dequeue_chunk_t **const obj,
+                                                        const zylib_private_dequeue_t *const dequeue)
+{
+    zylib_private_allocator_free_sized(dequeue->allocator,
+                                       offsetof(zylib_private_dequeue_chunk_t, data) + (*obj)->capacity, (void **)obj);
+}
+
+/*
+ * Prepare the chunk at one end of a packed dequeue to receive a record there, constructing one if needed
+ * @return The chunk, or NULL if the operation failed
+ */
+ZYLIB_NONNULL
+static zylib_private_dequeue_chunk_t *zylib_private_dequeue_chunk_reserve(zylib_private_dequeue_t *const obj,
+                                                                          _Bool first, size_t record_size)
+{
+    _Bool r;
+    zylib_private_dequeue_chunk_t *chunk = first ? obj->first_chunk : obj->last_chunk;
+
+    /* The only chunk of an empty dequeue is kept if it has the default capacity, and refilled from either end */
+    if (chunk != NULL && chunk->begin == chunk->end)
+    {
+        if (chunk->capacity < record_size)
+        {
+            zylib_private_dequeue_chunk_destruct(&chunk, obj);
+            obj->first_chunk = NULL;
+            obj->last_chunk = NULL;
+        }
+        else
+        {
+            chunk->begin = first ? chunk->capacity : 0;
+            chunk->end = chunk->begin;
+            obj->tail_first = ZYLIB_PRIVATE_DEQUEUE_CHUNK_RECORD_MAX;
+            obj->tail_end = obj->tail_first;
+        }
+    }
+
+    if (chunk != NULL && (first ? chunk->begin : chunk->capacity - chunk->end) >= record_size)
+    {
+        return chunk;
+    }
+
+    r = zylib_private_dequeue_chunk_construct(&chunk, obj, record_size, first);
+    if (!r)
+    {
+        return NULL;
+    }
+
+    if (first && obj->first_chunk != NULL)
+    {
+        chunk->next = obj->first_chunk;
+        obj->first_chunk->previous = chunk;
+        obj->first_chunk = chunk;
+        return chunk;
+    }
+
+    if (obj->first_chunk == NULL)
+    {
+        obj->first_chunk = chunk;
+    }
+    else
+    {
+        chunk->previous = obj->last_chunk;
+        obj->last_chunk->next = chunk;
+    }
+    obj->last_chunk = chunk;
+    obj->tail_first = ZYLIB_PRIVATE_DEQUEUE_CHUNK_RECORD_MAX;
+    obj->tail_end = obj->tail_first;
+    return chunk;
+}
+
+/*
+ * Copy a memory region into a record at the beginning or the end of a packed dequeue
+ */
+ZYLIB_NONNULL
+static _Bool zylib_private_dequeue_pack(zylib_private_dequeue_t *const obj, _Bool first, size_t size, const void *data)
+{
+    const size_t varint_size = zylib_private_dequeue_varint_get_size(size);
+    size_t record_size;
+    zylib_private_dequeue_chunk_t *chunk;
+
+    if (size > SIZE_MAX - varint_size)
+    {
+        return 0;
+    }
+    record_size = varint_size + size;
+
+    chunk = zylib_private_dequeue_chunk_reserve(obj, first, record_size);
+    if (chunk == NULL)
+    {
+        return 0;
+    }
+
+    if (first)
+    {
+        chunk->begin -= record_size;
+        zylib_private_dequeue_record_write((unsigned char *)chunk->data + chunk->begin, size, data);
+        if (chunk == obj->last_chunk)
+        {
+            obj->tail[--obj->tail_first] = (uint16_t)chunk->begin;
+        }
+    }
+    else
+    {
+        obj->tail[obj->tail_end++] = (uint16_t)chunk->end;
+        zylib_private_dequeue_record_write((unsigned char *)chunk->data + chunk->end, size, data);
+        chunk->end += record_size;
+    }
+    ++obj->size;
+
+    return 1;
+}
+
+/*
+ * Deconstruct a chunk at one end of a packed dequeue that became empty, unless it is the only one and has the default
+ * capacity, in which case it is kept to be refilled
+ */
+ZYLIB_NONNULL
+static void zylib_private_dequeue_chunk_release(zylib_private_dequeue_t *const obj,
+                                                zylib_private_dequeue_chunk_t *chunk)
+{
+    if (chunk->previous == NULL && chunk->next == NULL)
+    {
+        if (chunk->capacity == ZYLIB_PRIVATE_DEQUEUE_CHUNK_CAPACITY)
+        {
+            return;
+        }
+        obj->first_chunk = NULL;
+        obj->last_chunk = NULL;
+    }
+    else if (chunk->previous == NULL)
+    {
+        obj->first_chunk = chunk->next;
+        obj->first_chunk->previous = NULL;
+    }
+    else
+    {
+        obj->last_chunk = chunk->previous;
+        obj->last_chunk->next = NULL;
+        zylib_private_dequeue_tail_rebuild(obj);
+    }
+    zylib_private_dequeue_chunk_destruct(&chunk, obj);
+}
+
+/*
+ * Remove the record at the beginning of a non-empty packed dequeue
+ */
+ZYLIB_NONNULL
+static void zylib_private_dequeue_unpack_first(zylib_private_dequeue_t *const obj)
+{
+    uint64_t size;
+    const void *data;
+    zylib_private_dequeue_chunk_t *const chunk = obj->first_chunk;
+
+    chunk->begin += zylib_private_dequeue_record_read_first(chunk, chunk->begin, &size, &data);
+    if (chunk == obj->last_chunk)
+    {
+        ++obj->tail_first;
+    }
+    if (chunk->begin == chunk->end)
+    {
+        zylib_private_dequeue_chunk_release(obj, chunk);
+    }
+    --obj->size;
+}
+
+/*
+ * Remove the record at the end of a non-empty packed dequeue
+ */
+ZYLIB_NONNULL
+static void zylib_private_dequeue_unpack_last(zylib_private_dequeue_t *const obj)
+{
+    zylib_private_dequeue_chunk_t *const chunk = obj->last_chunk;
+
+    chunk->end = obj->tail[--obj->tail_end];
+    if (chunk->begin == chunk->end)
+    {
+        zylib_private_dequeue_chunk_release(obj, chunk);
+    }
+    --obj->size;
+}
+
+/*
+ * Read the record at an index of a non-empty packed dequeue; records are walked from the beginning, unless the last
+ * one is requested
+ */
+ZYLIB_NONNULL
+static void zylib_private_dequeue_record_at(const zylib_private_dequeue_t *const obj, size_t index, uint64_t *size,
+                                            const void **data)
+{
+    const zylib_private_dequeue_chunk_t *chunk = obj->first_chunk;
+    size_t offset = chunk->begin;
+
+    if (index == obj->size - 1)
+    {
+        (void)zylib_private_dequeue_record_read_first(obj->last_chunk, obj->tail[obj->tail_end - 1], size, data);
+        return;
+    }
+
+    offset += zylib_private_dequeue_record_read_first(chunk, offset, size, data);
+    for (size_t i = 0; i < index; ++i)
+    {
+        if (offset == chunk->end)
+        {
+            chunk = chunk->next;
+            offset = chunk->begin;
+        }
+        offset += zylib_private_dequeue_record_read_first(chunk, offset, size, data);
+    }
+}
+
+/*
+ * Copy elements into the ring of a fixed-size dequeue, starting at a position and wrapping around its end
+ */
+ZYLIB_NONNULL
+static void zylib_private_dequeue_ring_write(zylib_private_dequeue_t *const obj, size_t position, size_t n,
+                                             const void *data)
+{
+    const size_t before_end_n = n < obj->element_capacity - position ? n : obj->element_capacity - position;
+
+    memcpy(obj->elements + position * obj->element_size, data, before_end_n * obj->element_size);
+    memcpy(obj->elements, (const unsigned char *)data + before_end_n * obj->element_size,
+           (n - before_end_n) * obj->element_size);
+}
+
+/*
+ * Copy elements out of the ring of a fixed-size dequeue, starting at a position and wrapping around its end
+ */
+ZYLIB_NONNULL
+static void zylib_private_dequeue_ring_read(const zylib_private_dequeue_t *const obj, size_t position, size_t n,
+                                            void *data)
+{
+    const size_t before_end_n = n < obj->element_capacity - position ? n : obj->element_capacity - position;
+
+    memcpy(data, obj->elements + position * obj->element_size, before_end_n * obj->element_size);
+    memcpy((unsigned char *)data + before_end_n * obj->element_size, obj->elements,
+           (n - before_end_n) * obj->element_size);
+}
+
+/*
+ * Make room for n more elements in the ring of a fixed-size dequeue; when it grows, its elements are moved to its
+ * beginning
+ */
+ZYLIB_NONNULL
+static _Bool zylib_private_dequeue_ring_reserve(zylib_private_dequeue_t *const obj, size_t n)
+{
+    _Bool r;
+
+    size_t capacity = obj->element_capacity > 0 ? obj->element_capacity : ZYLIB_PRIVATE_DEQUEUE_RING_MIN_CAPACITY;
+    unsigned char *elements = NULL;
+
+    if (n > SIZE_MAX - obj->size)
+    {
+        return 0;
+    }
+    if (obj->size + n <= obj->element_capacity)
+    {
+        return 1;
+    }
+
+    while (capacity < obj->size + n)
+    {
+        if (capacity > SIZE_MAX / 2)
+        {
+            return 0;
+        }
+        capacity *= 2;
+    }
+    if (capacity > SIZE_MAX / obj->element_size)
+    {
+        return 0;
+    }
+
+    r = zylib_private_allocator_malloc(obj->allocator, capacity * obj->element_size, (void **)&elements);
+    if (!r)
+    {
+        return 0;
+    }
+
+    if (obj->elements != NULL)
+    {
+        zylib_private_dequeue_ring_read(obj, obj->head, obj->size, elements);
+        zylib_private_allocator_free_sized(obj->allocator, obj->element_capacity * obj->element_size,
+                                           (void **)&obj->elements);
+    }
+    obj->elements = elements;
+    obj->element_capacity = capacity;
+    obj->head = 0;
+
+    return 1;
+}
+
+/*
+ * Retrieve the slot of the element at an index of a non-empty dequeue whose elements are stored in slots; a linked
+ * dequeue is walked from its nearest end
+ */
+ZYLIB_NONNULL
+static zylib_private_dequeue_slot_t *zylib_private_dequeue_slot_at(const zylib_private_dequeue_t *const obj,
+                                                                   size_t index)
+{
+    zylib_private_dequeue_box_t *box;
+
+    if (obj->mode == ZYLIB_PRIVATE_DEQUEUE_MODE_BLOCKED)
+    {
+        return zylib_private_dequeue_block_slot(obj, (obj->head + index) % zylib_private_dequeue_capacity(obj));
+    }
+
+    if (index < obj->size / 2)
+    {
+        box = obj->first;
+        for (size_t i = 0; i < index; ++i)
+        {
+            box = box->next;
+        }
+    }
+    else
+    {
+        box = obj->last;
+        for (size_t i = obj->size - 1; i > index; --i)
+        {
+            box = box->previous;
+        }
+    }
+    return &box->slot;
+}
+
+/*
+ * Retrieve the memory region of the element at an index of a non-empty dequeue
+ */
+ZYLIB_NONNULL
+static _Bool zylib_private_dequeue_peek_at(const zylib_private_dequeue_t *const obj, size_t index, uint64_t *size,
+                                           const void **data)
+{
+    if (obj->mode == ZYLIB_PRIVATE_DEQUEUE_MODE_PACKED)
+    {
+        zylib_private_dequeue_record_at(obj, index, size, data);
+        return 1;
+    }
+    if (obj->mode == ZYLIB_PRIVATE_DEQUEUE_MODE_FIXED)
+    {
+        *size = obj->element_size;
+        *data = obj->elements + (obj->head + index) % obj->element_capacity * obj->element_size;
+        return 1;
+    }
+    return zylib_private_dequeue_slot_peek(zylib_private_dequeue_slot_at(obj, index), size, data);
+}
+
+/*
+ * Hand the memory region of the element at an index of a non-empty dequeue back to the caller; the element must be
+ * removed afterwards
+ */
+ZYLIB_NONNULL
+static _Bool zylib_private_dequeue_release_at(zylib_private_dequeue_t *const obj, size_t index, uint64_t *size,
+                                              void **data)
+{
+    _Bool r;
+
+    uint64_t region_size;
+    const void *region;
+
+    if (zylib_private_dequeue_has_slots(obj))
+    {
+        return zylib_private_dequeue_slot_release(zylib_private_dequeue_slot_at(obj, index), obj, size, data);
+    }
+
+    r = zylib_private_dequeue_peek_at(obj, index, &region_size, &region);
+    if (!r)
+    {
+        return 0;
+    }
+
+    *data = NULL;
+    r = zylib_private_allocator_malloc(obj->allocator, region_size, data);
+    if (!r)
+    {
+        return 0;
+    }
+
+    *size = region_size;
+    memcpy(*data, region, region_size);
+    return 1;
+}
+
+/*
+ * Prefetch the out-of-line memory region of a slot, if any
+ */
+ZYLIB_NONNULL
+static inline void zylib_private_dequeue_slot_prefetch(const zylib_private_dequeue_slot_t *const obj)
+{
+    /* Boxes, shared boxes and ropes are all referenced through the same pointer storage */
+    if (obj->kind != ZYLIB_PRIVATE_DEQUEUE_SLOT_KIND_INLINE)
+    {
+        ZYLIB_PREFETCH(obj->box);
+    }
+}
+
+/*
+ * Prefetch the memory region of the current element of a cursor and the element that follows it in a direction.
+ * Packed and fixed-size dequeues are walked sequentially through contiguous memory, which is left to the hardware.
+ */
+ZYLIB_NONNULL
+static void zylib_private_dequeue_cursor_prefetch(const zylib_dequeue_cursor_t *const cursor, _Bool forward)
+{
+    const zylib_private_dequeue_t *const obj = cursor->dequeue;
+    const zylib_private_dequeue_box_t *box;
+
+    switch (obj->mode)
+    {
+    case ZYLIB_PRIVATE_DEQUEUE_MODE_LINKED:
+        box = cursor->node;
+        zylib_private_dequeue_slot_prefetch(&box->slot);
+        ZYLIB_PREFETCH(forward ? box->next : box->previous);
+        break;
+    case ZYLIB_PRIVATE_DEQUEUE_MODE_BLOCKED:
+        zylib_private_dequeue_slot_prefetch(zylib_private_dequeue_slot_at(obj, cursor->index));
+        if (forward ? cursor->index + 1 < obj->size : cursor->index > 0)
+        {
+            ZYLIB_PREFETCH(zylib_private_dequeue_slot_at(obj, forward ? cursor->index + 1 : cursor->index - 1));
+        }
+        break;
+    case ZYLIB_PRIVATE_DEQUEUE_MODE_PACKED:
+    case ZYLIB_PRIVATE_DEQUEUE_MODE_FIXED:
+        break;
+    }
+}
+
+/*
+ * Deconstruct the element at the beginning of a non-empty dequeue
+ */
+ZYLIB_NONNULL
+static void zylib_private_dequeue_remove_first(zylib_private_dequeue_t *const obj)
+{
+    if (obj->mode == ZYLIB_PRIVATE_DEQUEUE_MODE_LINKED)
+    {
+        zylib_private_dequeue_unlink_first(obj);
+        return;
+    }
+    if (obj->mode == ZYLIB_PRIVATE_DEQUEUE_MODE_PACKED)
+    {
+        zylib_private_dequeue_unpack_first(obj);
+        return;
+    }
+    if (obj->mode == ZYLIB_PRIVATE_DEQUEUE_MODE_FIXED)
+    {
+        obj->head = (obj->head + 1) % obj->element_capacity;
+        --obj->size;
+        return;
+    }
+
+    zylib_private_dequeue_slot_destruct(zylib_private_dequeue_block_slot(obj, obj->head));
+    obj->head = (obj->head + 1) % zylib_private_dequeue_capacity(obj);
+    --obj->size;
+}
+
+/*
+ * Deconstruct the element at the end of a non-empty dequeue
+ */
+ZYLIB_NONNULL
+static void zylib_private_dequeue_remove_last(zylib_private_dequeue_t *const obj)
+{
+    if (obj->mode == ZYLIB_PRIVATE_DEQUEUE_MODE_LINKED)
+    {
+        zylib_private_dequeue_unlink_last(obj);
+        return;
+    }
+    if (obj->mode == ZYLIB_PRIVATE_DEQUEUE_MODE_PACKED)
+    {
+        zylib_private_dequeue_unpack_last(obj);
+        return;
+    }
+    if (obj->mode == ZYLIB_PRIVATE_DEQUEUE_MODE_FIXED)
+    {
+        --obj->size;
+        return;
+    }
+
+    zylib_private_dequeue_slot_destruct(zylib_private_dequeue_slot_at(obj, obj->size - 1));
+    --obj->size;
+}
+
+/*
+ * Function Definitions
+ */
+
+_Bool zylib_private_dequeue_construct(zylib_private_dequeue_t **obj, const zylib_private_allocator_t *allocator)
+{
+    _Bool r;
+
+    *obj = NULL;
+    r = zylib_private_allocator_malloc(allocator, sizeof(zylib_private_dequeue_t), (void **)obj);
+    if (!r)
+    {
+        goto error;
+    }
+
+    (*obj)->allocator = allocator;
+    (*obj)->node_pool = NULL;
+    (*obj)->large_node_pool = NULL;
+    (*obj)->first = NULL;
+    (*obj)->last = NULL;
+    (*obj)->blocks = NULL;
+    (*obj)->block_n = 0;
+    (*obj)->elements = NULL;
+    (*obj)->element_size = 0;
+    (*obj)->element_capacity = 0;
+    (*obj)->head = 0;
+    (*obj)->first_chunk = NULL;
+    (*obj)->last_chunk = NULL;
+    (*obj)->tail = NULL;
+    (*obj)->tail_first = 0;
+    (*obj)->tail_end = 0;
+    (*obj)->mode = ZYLIB_PRIVATE_DEQUEUE_MODE_LINKED;
+    (*obj)->size = 0;
+
+error:
+    return r;
+}
+
+_Bool zylib_private_dequeue_construct_pooled(zylib_private_dequeue_t **obj, const zylib_private_allocator_t *allocator)
+{
+    _Bool r;
+
+    r = zylib_private_dequeue_construct(obj, allocator);
+    if (!r)
+    {
+        goto error;
+    }
+
+    r = zylib_private_pool_construct(&(*obj)->node_pool, allocator, sizeof(zylib_private_dequeue_box_t));
+    if (!r)
+    {
+        goto error;
+    }
+
+    r = zylib_private_pool_construct(&(*obj)->large_node_pool, allocator,
+                                     zylib_private_dequeue_box_get_allocation_size(ZYLIB_PRIVATE_BOX_POOL_CAPACITY));
+    if (!r)
+    {
+        goto error;
+    }
+
+    goto done;
+error:
+    zylib_private_dequeue_destruct(obj);
+done:
+    return r;
+}
+
+_Bool zylib_private_dequeue_construct_blocked(zylib_private_dequeue_t **obj,
+                                              const zylib_private_allocator_t *allocator)
+{
+    _Bool r;
+
+    r = zylib_private_dequeue_construct(obj, allocator);
+    if (!r)
+    {
+        return 0;
+    }
+
+    (*obj)->mode = ZYLIB_PRIVATE_DEQUEUE_MODE_BLOCKED;
+    return 1;
+}
+
+_Bool zylib_private_dequeue_construct_packed(zylib_private_dequeue_t **obj, const zylib_private_allocator_t *allocator)
+{
+    _Bool r;
+
+    r = zylib_private_dequeue_construct(obj, allocator);
+    if (!r)
+    {
+        return 0;
+    }
+
+    (*obj)->mode = ZYLIB_PRIVATE_DEQUEUE_MODE_PACKED;
+    r = zylib_private_allocator_malloc(allocator, 2 * ZYLIB_PRIVATE_DEQUEUE_CHUNK_RECORD_MAX * sizeof(uint16_t),
+                                       (void **)&(*obj)->tail);
+    if (!r)
+    {
+        zylib_private_dequeue_destruct(obj);
+    }
+    return r;
+}
+
+_Bool zylib_private_dequeue_construct_fixed(zylib_private_dequeue_t **obj, const zylib_private_allocator_t *allocator,
+                                            uint64_t element_size)
+{
+    _Bool r;
+
+    if (element_size <= 0 || element_size > SIZE_MAX)
+    {
+        *obj = NULL;
+        return 0;
+    }
+
+    r = zylib_private_dequeue_construct(obj, allocator);
+    if (!r)
+    {
+        return 0;
+    }
+
+    (*obj)->mode = ZYLIB_PRIVATE_DEQUEUE_MODE_FIXED;
+    (*obj)->element_size = element_size;
+    return 1;
+}
+
+void zylib_private_dequeue_destruct(zylib_private_dequeue_t **obj)
+{
+    if (*obj != NULL)
+    {
+        zylib_private_dequeue_clear(*obj);
+        if ((*obj)->node_pool != NULL)
+        {
+            zylib_private_pool_destruct(&(*obj)->node_pool);
+        }
+        if ((*obj)->large_node_pool != NULL)
+        {
+            zylib_private_pool_destruct(&(*obj)->large_node_pool);
+        }
+        if ((*obj)->tail != NULL)
+        {
+            zylib_private_allocator_free_sized((*obj)->allocator,
+                                               2 * ZYLIB_PRIVATE_DEQUEUE_CHUNK_RECORD_MAX * sizeof(uint16_t),
+                                               (void **)&(*obj)->tail);
+        }
+        zylib_private_allocator_free_sized((*obj)->allocator, sizeof(zylib_private_dequeue_t), (void **)obj);
+    }
+}
+
+void zylib_private_dequeue_clear(zylib_private_dequeue_t *obj)
+{
+    if (obj->mode == ZYLIB_PRIVATE_DEQUEUE_MODE_FIXED)
+    {
+        if (obj->elements != NULL)
+        {
+            zylib_private_allocator_free_sized(obj->allocator, obj->element_capacity * obj->element_size,
+                                               (void **)&obj->elements);
+        }
+        obj->element_capacity = 0;
+        obj->head = 0;
+        obj->size = 0;
+        return;
+    }
+
+    if (obj->mode == ZYLIB_PRIVATE_DEQUEUE_MODE_PACKED)
+    {
+        zylib_private_dequeue_chunk_t *chunk = obj->first_chunk;
+        while (chunk != NULL)
+        {
+            zylib_private_dequeue_chunk_t *const next = chunk->next;
+            zylib_private_dequeue_chunk_destruct(&chunk, obj);
+            chunk = next;
+        }
+        obj->first_chunk = NULL;
+        obj->last_chunk = NULL;
+        obj->size = 0;
+        return;
+    }
+
+    if (obj->mode == ZYLIB_PRIVATE_DEQUEUE_MODE_BLOCKED)
+    {
+        for (size_t i = 0; i < obj->size; ++i)
+        {
+            zylib_private_dequeue_slot_destruct(zylib_private_dequeue_slot_at(obj, i));
+        }
+        for (size_t i = 0; i < obj->block_n; ++i)
+        {
+            if (obj->blocks[i] != NULL)
+            {
+                zylib_private_allocator_free_sized(
+                    obj->allocator, ZYLIB_PRIVATE_DEQUEUE_BLOCK_LENGTH * sizeof(zylib_private_dequeue_slot_t),
+                    (void **)&obj->blocks[i]);
+            }
+        }
+        if (obj->blocks != NULL)
+        {
+            zylib_private_allocator_free_sized(obj->allocator, obj->block_n * sizeof(zylib_private_dequeue_slot_t *),
+                                               (void **)&obj->blocks);
+        }
+        obj->block_n = 0;
+        obj->head = 0;
+        obj->size = 0;
+        return;
+    }
+
+    zylib_private_dequeue_box_t *box = obj->first;
+    while (box != NULL)
+    {
+        zylib_private_dequeue_box_t *const next = box->next;
+        zylib_private_dequeue_box_destruct(&box, obj);
+        box = next;
+    }
+    obj->first = NULL;
+    obj->last = NULL;
+    obj->size = 0;
+
+    /* Every node is freed, so a pooled dequeue hands its slabs back */
+    if (obj->node_pool != NULL)
+    {
+        (void)zylib_private_pool_trim(obj->node_pool);
+    }
+    if (obj->large_node_pool != NULL)
+    {
+        (void)zylib_private_pool_trim(obj->large_node_pool);
+    }
+}
+
+_Bool zylib_private_dequeue_push_first(zylib_private_dequeue_t *obj, uint64_t size, const void *data)
+{
+    _Bool r;
+    zylib_private_dequeue_slot_t *slot;
+
+    if (size <= 0 || size > SIZE_MAX)
+    {
+        return 0;
+    }
+
+    if (obj->mode == ZYLIB_PRIVATE_DEQUEUE_MODE_PACKED)
+    {
+        return zylib_private_dequeue_pack(obj, 1, size, data);
+    }
+    if (obj->mode == ZYLIB_PRIVATE_DEQUEUE_MODE_FIXED)
+    {
+        return size == obj->element_size && zylib_private_dequeue_push_n_first(obj, 1, data);
+    }
+
+    slot = zylib_private_dequeue_reserve(obj, 1, size);
+    if (slot == NULL)
+    {
+        return 0;
+    }
+
+    r = zylib_private_dequeue_slot_construct(slot, obj, size, data);
+    zylib_private_dequeue_commit(obj, slot, 1, r);
+    return r;
+}
+
+_Bool zylib_private_dequeue_push_last(zylib_private_dequeue_t *obj, uint64_t size, const void *data)
+{
+    _Bool r;
+    zylib_private_dequeue_slot_t *slot;
+
+    if (size <= 0 || size > SIZE_MAX)
+    {
+        return 0;
+    }
+
+    if (obj->mode == ZYLIB_PRIVATE_DEQUEUE_MODE_PACKED)
+    {
+        return zylib_private_dequeue_pack(obj, 0, size, data);
+    }
+    if (obj->mode == ZYLIB_PRIVATE_DEQUEUE_MODE_FIXED)
+    {
+        return size == obj->element_size && zylib_private_dequeue_push_n_last(obj, 1, data);
+    }
+
+    slot = zylib_private_dequeue_reserve(obj, 0, size);
+    if (slot == NULL)
+    {
+        return 0;
+    }
+
+    r = zylib_private_dequeue_slot_construct(slot, obj, size, data);
+    zylib_private_dequeue_commit(obj, slot, 0, r);
+    return r;
+}
+
+_Bool zylib_private_dequeue_push_n_first(zylib_private_dequeue_t *obj, uint64_t n, const void *data)
+{
+    _Bool r;
+
+    if (obj->mode != ZYLIB_PRIVATE_DEQUEUE_MODE_FIXED || n <= 0 || n > SIZE_MAX)
+    {
+        return 0;
+    }
+
+    r = zylib_private_dequeue_ring_reserve(obj, n);
+    if (!r)
+    {
+        return 0;
+    }
+
+    obj->head = (obj->head + obj->element_capacity - n) % obj->element_capacity;
+    zylib_private_dequeue_ring_write(obj, obj->head, n, data);
+    obj->size += n;
+
+    return 1;
+}
+
+_Bool zylib_private_dequeue_push_n_last(zylib_private_dequeue_t *obj, uint64_t n, const void *data)
+{
+    _Bool r;
+
+    if (obj->mode != ZYLIB_PRIVATE_DEQUEUE_MODE_FIXED || n <= 0 || n > SIZE_MAX)
+    {
+        return 0;
+    }
+
+    r = zylib_private_dequeue_ring_reserve(obj, n);
+    if (!r)
+    {
+        return 0;
+    }
+
+    zylib_private_dequeue_ring_write(obj, (obj->head + obj->size) % obj->element_capacity, n, data);
+    obj->size += n;
+
+    return 1;
+}
+
+_Bool zylib_private_dequeue_adopt_first(zylib_private_dequeue_t *obj, uint64_t size, void **data)
+{
+    _Bool r;
+    zylib_private_dequeue_slot_t *slot;
+
+    slot = zylib_private_dequeue_reserve(obj, 1, 0);
+    if (slot == NULL)
+    {
+        return 0;
+    }
+
+    r = zylib_private_dequeue_slot_adopt(slot, obj, size, data);
+    zylib_private_dequeue_commit(obj, slot, 1, r);
+    return r;
+}
+
+_Bool zylib_private_dequeue_adopt_last(zylib_private_dequeue_t *obj, uint64_t size, void **data)
+{
+    _Bool r;
+    zylib_private_dequeue_slot_t *slot;
+
+    slot = zylib_private_dequeue_reserve(obj, 0, 0);
+    if (slot == NULL)
+    {
+        return 0;
+    }
+
+    r = zylib_private_dequeue_slot_adopt(slot, obj, size, data);
+    zylib_private_dequeue_commit(obj, slot, 0, r);
+    return r;
+}
+
+_Bool zylib_private_dequeue_push_shared_first(zylib_private_dequeue_t *obj, zylib_private_shared_box_t *box)
+{
+    _Bool r;
+    zylib_private_dequeue_slot_t *slot;
+
+    slot = zylib_private_dequeue_reserve(obj, 1, 0);
+    if (slot == NULL)
+    {
+        return 0;
+    }
+
+    r = zylib_private_dequeue_slot_share(slot, box);
+    zylib_private_dequeue_commit(obj, slot, 1, r);
+    return r;
+}
+
+_Bool zylib_private_dequeue_push_shared_last(zylib_private_dequeue_t *obj, zylib_private_shared_box_t *box)
+{
+    _Bool r;
+    zylib_private_dequeue_slot_t *slot;
+
+    slot = zylib_private_dequeue_reserve(obj, 0, 0);
+    if (slot == NULL)
+    {
+        return 0;
+    }
+
+    r = zylib_private_dequeue_slot_share(slot, box);
+    zylib_private_dequeue_commit(obj, slot, 0, r);
+    return r;
+}
+
+_Bool zylib_private_dequeue_push_rope_first(zylib_private_dequeue_t *obj, zylib_private_rope_t **rope)
+{
+    _Bool r;
+    zylib_private_dequeue_slot_t *slot;
+
+    slot = zylib_private_dequeue_reserve(obj, 1, 0);
+    if (slot == NULL)
+    {
+        return 0;
+    }
+
+    r = zylib_private_dequeue_slot_adopt_rope(slot, rope);
+    zylib_private_dequeue_commit(obj, slot, 1, r);
+    return r;
+}
+
+_Bool zylib_private_dequeue_push_rope_last(zylib_private_dequeue_t *obj, zylib_private_rope_t **rope)
+{
+    _Bool r;
+    zylib_private_dequeue_slot_t *slot;
+
+    slot = zylib_private_dequeue_reserve(obj, 0, 0);
+    if (slot == NULL)
+    {
+        return 0;
+    }
+
+    r = zylib_private_dequeue_slot_adopt_rope(slot, rope);
+    zylib_private_dequeue_commit(obj, slot, 0, r);
+    return r;
+}
+
+_Bool zylib_private_dequeue_pop_n_first(zylib_private_dequeue_t *obj, uint64_t n, void *data)
+{
+    if (obj->mode != ZYLIB_PRIVATE_DEQUEUE_MODE_FIXED || n <= 0 || n > obj->size)
+    {
+        return 0;
+    }
+
+    zylib_private_dequeue_ring_read(obj, obj->head, n, data);
+    obj->head = (obj->head + n) % obj->element_capacity;
+    obj->size -= n;
+
+    return 1;
+}
+
+_Bool zylib_private_dequeue_pop_n_last(zylib_private_dequeue_t *obj, uint64_t n, void *data)
+{
+    if (obj->mode != ZYLIB_PRIVATE_DEQUEUE_MODE_FIXED || n <= 0 || n > obj->size)
+    {
+        return 0;
+    }
+
+    zylib_private_dequeue_ring_read(obj, (obj->head + obj->size - n) % obj->element_capacity, n, data);
+    obj->size -= n;
+
+    return 1;
+}
+
+void zylib_private_dequeue_discard_first(zylib_private_dequeue_t *obj)
+{
+    if (!zylib_private_dequeue_is_empty(obj))
+    {
+        zylib_private_dequeue_remove_first(obj);
+    }
+}
+
+void zylib_private_dequeue_discard_last(zylib_private_dequeue_t *obj)
+{
+    if (!zylib_private_dequeue_is_empty(obj))
+    {
+        zylib_private_dequeue_remove_last(obj);
+    }
+}
+
+_Bool zylib_private_dequeue_release_first(zylib_private_dequeue_t *obj, uint64_t *size, void **data)
+{
+    if (zylib_private_dequeue_is_empty(obj) || !zylib_private_dequeue_release_at(obj, 0, size, data))
+    {
+        return 0;
+    }
+
+    zylib_private_dequeue_remove_first(obj);
+    return 1;
+}
+
+_Bool zylib_private_dequeue_release_last(zylib_private_dequeue_t *obj, uint64_t *size, void **data)
+{
+    if (zylib_private_dequeue_is_empty(obj) || !zylib_private_dequeue_release_at(obj, obj->size - 1, size, data))
+    {
+        return 0;
+    }
+
+    zylib_private_dequeue_remove_last(obj);
+    return 1;
+}
+
+_Bool zylib_private_dequeue_peek_rope_first(const zylib_private_dequeue_t *obj, const zylib_private_rope_t **rope)
+{
+    const zylib_private_dequeue_slot_t *slot;
+
+    if (!zylib_private_dequeue_is_empty(obj) && zylib_private_dequeue_has_slots(obj))
+    {
+        slot = zylib_private_dequeue_slot_at(obj, 0);
+        if (slot->kind == ZYLIB_PRIVATE_DEQUEUE_SLOT_KIND_ROPE)
+        {
+            *rope = slot->rope;
+            return 1;
+        }
+    }
+    *rope = NULL;
+    return 0;
+}
+
+_Bool zylib_private_dequeue_peek_rope_last(const zylib_private_dequeue_t *obj, const zylib_private_rope_t **rope)
+{
+    const zylib_private_dequeue_slot_t *slot;
+
+    if (!zylib_private_dequeue_is_empty(obj) && zylib_private_dequeue_has_slots(obj))
+    {
+        slot = zylib_private_dequeue_slot_at(obj, obj->size - 1);
+        if (slot->kind == ZYLIB_PRIVATE_DEQUEUE_SLOT_KIND_ROPE)
+        {
+            *rope = slot->rope;
+            return 1;
+        }
+    }
+    *rope = NULL;
+    return 0;
+}
+
+_Bool zylib_private_dequeue_peek_first(const zylib_private_dequeue_t *obj, uint64_t *size, const void **data)
+{
+    if (!zylib_private_dequeue_is_empty(obj) && zylib_private_dequeue_peek_at(obj, 0, size, data))
+    {
+        return 1;
+    }
+    *size = 0;
+    *data = NULL;
+    return 0;
+}
+
+_Bool zylib_private_dequeue_peek_last(const zylib_private_dequeue_t *obj, uint64_t *size, const void **data)
+{
+    if (!zylib_private_dequeue_is_empty(obj) && zylib_private_dequeue_peek_at(obj, obj->size - 1, size, data))
+    {
+        return 1;
+    }
+    *size = 0;
+    *data = NULL;
+    return 0;
+}
+
+_Bool zylib_private_dequeue_at(const zylib_private_dequeue_t *obj, uint64_t index, uint64_t *size, const void **data)
+{
+    if (index < obj->size && zylib_private_dequeue_peek_at(obj, index, size, data))
+    {
+        return 1;
+    }
+    *size = 0;
+    *data = NULL;
+    return 0;
+}
+
+_Bool zylib_private_dequeue_cursor_first(const zylib_private_dequeue_t *obj, zylib_dequeue_cursor_t *cursor)
+{
+    if (zylib_private_dequeue_is_empty(obj))
+    {
+        return 0;
+    }
+
+    cursor->dequeue = obj;
+    cursor->node = NULL;
+    cursor->offset = 0;
+    cursor->index = 0;
+    if (obj->mode == ZYLIB_PRIVATE_DEQUEUE_MODE_LINKED)
+    {
+        cursor->node = obj->first;
+    }
+    else if (obj->mode == ZYLIB_PRIVATE_DEQUEUE_MODE_PACKED)
+    {
+        cursor->node = obj->first_chunk;
+        cursor->offset = obj->first_chunk->begin;
+    }
+
+    zylib_private_dequeue_cursor_prefetch(cursor, 1);
+    return 1;
+}
+
+_Bool zylib_private_dequeue_cursor_last(const zylib_private_dequeue_t *obj, zylib_dequeue_cursor_t *cursor)
+{
+    if (zylib_private_dequeue_is_empty(obj))
+    {
+        return 0;
+    }
+
+    cursor->dequeue = obj;
+    cursor->node = NULL;
+    cursor->offset = 0;
+    cursor->index = obj->size - 1;
+    if (obj->mode == ZYLIB_PRIVATE_DEQUEUE_MODE_LINKED)
+    {
+        cursor->node = obj->last;
+    }
+    else if (obj->mode == ZYLIB_PRIVATE_DEQUEUE_MODE_PACKED)
+    {
+        cursor->node = obj->last_chunk;
+        cursor->offset = obj->tail[obj->tail_end - 1];
+    }
+
+    zylib_private_dequeue_cursor_prefetch(cursor, 0);
+    return 1;
+}
+
+_Bool zylib_private_dequeue_cursor_next(zylib_dequeue_cursor_t *cursor)
+{
+    const zylib_private_dequeue_t *const obj = cursor->dequeue;
+    const zylib_private_dequeue_chunk_t *chunk;
+    uint64_t size;
+    const void *data;
+
+    if (cursor->index + 1 >= obj->size)
+    {
+        return 0;
+    }
+
+    if (obj->mode == ZYLIB_PRIVATE_DEQUEUE_MODE_LINKED)
+    {
+        cursor->node = ((const zylib_private_dequeue_box_t *)cursor->node)->next;
+    }
+    else if (obj->mode == ZYLIB_PRIVATE_DEQUEUE_MODE_PACKED)
+    {
+        chunk = cursor->node;
+        cursor->offset += zylib_private_dequeue_record_read_first(chunk, cursor->offset, &size, &data);
+        if (cursor->offset == chunk->end)
+        {
+            cursor->node = chunk->next;
+            cursor->offset = chunk->next->begin;
+        }
+    }
+    ++cursor->index;
+
+    zylib_private_dequeue_cursor_prefetch(cursor, 1);
+    return 1;
+}
+
+_Bool zylib_private_dequeue_cursor_prev(zylib_dequeue_cursor_t *cursor)
+{
+    const zylib_private_dequeue_t *const obj = cursor->dequeue;
+    const zylib_private_dequeue_chunk_t *chunk;
+
+    if (cursor->index <= 0)
+    {
+        return 0;
+    }
+
+    if (obj->mode == ZYLIB_PRIVATE_DEQUEUE_MODE_LINKED)
+    {
+        cursor->node = ((const zylib_private_dequeue_box_t *)cursor->node)->previous;
+    }
+    else if (obj->mode == ZYLIB_PRIVATE_DEQUEUE_MODE_PACKED)
+    {
+        chunk = cursor->node;
+        if (cursor->offset == chunk->begin)
+        {
+            chunk = chunk->previous;
+            cursor->node = chunk;
+            cursor->offset = chunk->end;
+        }
+        cursor->offset = zylib_private_dequeue_record_before(obj, chunk, cursor->offset);
+    }
+    --cursor->index;
+
+    zylib_private_dequeue_cursor_prefetch(cursor, 0);
+    return 1;
+}
+
+_Bool zylib_private_dequeue_cursor_get(const zylib_dequeue_cursor_t *cursor, uint64_t *size, const void **data)
+{
+    const zylib_private_dequeue_t *const obj = cursor->dequeue;
+
+    if (obj->mode == ZYLIB_PRIVATE_DEQUEUE_MODE_LINKED)
+    {
+        return zylib_private_dequeue_slot_peek(&((const zylib_private_dequeue_box_t *)cursor->node)->slot, size, data);
+    }
+    if (obj->mode == ZYLIB_PRIVATE_DEQUEUE_MODE_PACKED)
+    {
+        (void)zylib_private_dequeue_record_read_first(cursor->node, cursor->offset, size, data);
+        return 1;
+    }
+    return zylib_private_dequeue_peek_at(obj, cursor->index, size, data);
 }
 
 uint64_t zylib_private_dequeue_size(const zylib_private_dequeue_t *obj)
@@ -18,6 +18,7 @@
 #include <string.h>
 
 typedef _Bool (*zylib_private_dequeue_push_t)(zylib_private_dequeue_t *, uint64_t, const void *);
+typedef _Bool (*zylib_private_dequeue_push_rope_t)(zylib_private_dequeue_t *, zylib_private_rope_t **);
 
 struct zylib_private_error_box_s
 {
@@ -65,7 +66,60 @@ static _Bool zylib_private_error_push(zylib_private_error_t *obj, int64_t error_
 error:
     if (ptr != NULL)
     {
-        zylib_private_allocator_free(obj->allocator, (void **)&ptr);
+        zylib_private_allocator_free_sized(obj->allocator, sizeof(zylib_private_error_box_t) + auxiliary_size,
+                                           (void **)&ptr);
+    }
+    return r;
+}
+
+/*
+ * The error container is stored as a rope whose first chunk holds the header and whose other chunks are moved from
+ * the auxiliary rope
+ */
+static _Bool zylib_private_error_push_rope(zylib_private_error_t *obj, int64_t error_code, const char *file_name,
+                                           uint64_t line_number, const char *function_name,
+                                           zylib_private_rope_t **auxiliary, zylib_private_dequeue_push_rope_t push)
+{
+    _Bool r;
+    zylib_private_rope_t *rope = NULL;
+    const zylib_private_error_box_t error_box = {.error_code = error_code,
+                                                 .file_name = file_name,
+                                                 .line_number = line_number,
+                                                 .function_name = function_name,
+                                                 .auxiliary_size = zylib_private_rope_peek_size(*auxiliary)};
+
+    r = zylib_private_rope_construct(&rope, obj->allocator, sizeof(zylib_private_error_box_t));
+    if (!r)
+    {
+        goto error;
+    }
+
+    r = zylib_private_rope_append(rope, sizeof(zylib_private_error_box_t), &error_box);
+    if (!r)
+    {
+        goto error;
+    }
+
+    r = zylib_private_rope_concat(rope, auxiliary);
+    if (!r)
+    {
+        goto error;
+    }
+
+    r = push(obj->dequeue, &rope);
+    if (!r)
+    {
+        goto error;
+    }
+
+error:
+    if (rope != NULL)
+    {
+        zylib_private_rope_destruct(&rope);
+    }
+    if (*auxiliary != NULL)
+    {
+        zylib_private_rope_destruct(auxiliary);
     }
     return r;
 }
@@ -81,14 +135,13 @@ _Bool zylib_private_error_construct(zylib_private_error_t **obj, const zylib_pri
         goto error;
     }
 
+    (*obj)->allocator = allocator;
     r = zylib_private_dequeue_construct(&(*obj)->dequeue, allocator);
     if (!r)
     {
         goto error;
     }
 
-    (*obj)->allocator = allocator;
-
     goto done;
 error:
     zylib_private_error_destruct(obj);
@@ -104,7 +157,7 @@ void zylib_private_error_destruct(zylib_private_error_t **obj)
         {
             zylib_private_dequeue_destruct(&(*obj)->dequeue);
         }
-        zylib_private_allocator_free((*obj)->allocator, (void **)obj);
+        zylib_private_allocator_free_sized((*obj)->allocator, sizeof(zylib_private_error_t), (void **)obj);
     }
 }
 
@@ -129,6 +182,22 @@ _Bool zylib_private_error_push_last(zylib_private_error_t *obj, int64_t error_co
                                     auxiliary_data, zylib_private_dequeue_push_last);
 }
 
+_Bool zylib_private_error_push_rope_first(zylib_private_error_t *obj, int64_t error_code, const char *file_name,
+                                          uint64_t line_number, const char *function_name,
+                                          zylib_private_rope_t **auxiliary)
+{
+    return zylib_private_error_push_rope(obj, error_code, file_name, line_number, function_name, auxiliary,
+                                         zylib_private_dequeue_push_rope_first);
+}
+
+_Bool zylib_private_error_push_rope_last(zylib_private_error_t *obj, int64_t error_code, const char *file_name,
+                                         uint64_t line_number, const char *function_name,
+                                         zylib_private_rope_t **auxiliary)
+{
+    return zylib_private_error_push_rope(obj, error_code, file_name, line_number, function_name, auxiliary,
+                                         zylib_private_dequeue_push_rope_last);
+}
+
 void zylib_private_error_discard_first(zylib_private_error_t *obj)
 {
     zylib_private_dequeue_discard_first(obj->dequeue);
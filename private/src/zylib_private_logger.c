@@ -96,7 +96,8 @@ void zylib_private_logger_destruct(zylib_private_logger_t **logger)
 {
     if (*logger != NULL)
     {
-        zylib_private_allocator_free((const zylib_private_allocator_t *)(*logger)->allocator, (void **)logger);
+        zylib_private_allocator_free_sized((const zylib_private_allocator_t *)(*logger)->allocator,
+                                           sizeof(zylib_private_logger_t), (void **)logger);
     }
 }
 
@@ -128,7 +129,8 @@ uint64_t zylib_private_logger_write(const zylib_private_logger_t *logger, zylib_
     error:
         if (display_message != NULL)
         {
-            zylib_private_allocator_free(logger->allocator, (void **)&display_message);
+            zylib_private_allocator_free_sized(logger->allocator, ZYLIB_LOGGER_MAX_MESSAGE_SIZE,
+                                               (void **)&display_message);
         }
         return r;
     }
@@ -0,0 +1,397 @@
+/*
+ * Copyright 2023 Alexandre Fernandez <alex@fernandezfamily.email>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#if !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+#include "zylib_private_mmap.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define ZYLIB_PRIVATE_MMAP_SUPPORTED (1)
+#else
+#define ZYLIB_PRIVATE_MMAP_SUPPORTED (0)
+#endif
+
+/*
+ * Macros
+ */
+
+/* The size of huge pages when the operating system does not report it */
+#define ZYLIB_PRIVATE_MMAP_DEFAULT_HUGE_PAGE_SIZE ((size_t)2 * 1024 * 1024)
+
+/*
+ * Type Definitions
+ */
+
+typedef struct zylib_private_mmap_block_s
+{
+    /* The requested size */
+    size_t size;
+    /* The length of the mapping, or 0 if the block was allocated from the parent allocator object */
+    size_t length;
+    max_align_t data[];
+} zylib_private_mmap_block_t;
+
+typedef struct zylib_private_mmap_s
+{
+    const zylib_private_allocator_t *parent;
+    size_t threshold;
+    unsigned flags;
+    size_t page_size;
+    /* The size of the huge pages that back mappings with MAP_HUGETLB, a power of two */
+    size_t huge_page_size;
+} zylib_private_mmap_t;
+
+/*
+ * Static Function Declarations
+ */
+
+static void *zylib_private_mmap_malloc(void *context, size_t size);
+
+static void *zylib_private_mmap_calloc(void *context, size_t size);
+
+static void *zylib_private_mmap_realloc(void *context, void *ptr, size_t old_size, size_t size);
+
+static void zylib_private_mmap_free(void *context, void *ptr, size_t size);
+
+static void zylib_private_mmap_destruct(void *context);
+
+/*
+ * Static Variables
+ */
+
+static const zylib_allocator_vtable_t zylib_private_mmap_vtable = {.malloc = zylib_private_mmap_malloc,
+                                                                   .calloc = zylib_private_mmap_calloc,
+                                                                   .realloc = zylib_private_mmap_realloc,
+                                                                   .free = zylib_private_mmap_free,
+                                                                   .aligned_malloc = NULL,
+                                                                   .aligned_free = NULL,
+                                                                   .destruct = zylib_private_mmap_destruct};
+
+/*
+ * Static Function Definitions
+ */
+
+ZYLIB_NONNULL
+static inline zylib_private_mmap_block_t *zylib_private_mmap_header(void *ptr)
+{
+    return (zylib_private_mmap_block_t *)((unsigned char *)ptr - sizeof(zylib_private_mmap_block_t));
+}
+
+static inline size_t zylib_private_mmap_round(size_t size, size_t alignment)
+{
+    return (size + alignment - 1) & ~(alignment - 1);
+}
+
+/*
+ * Retrieve the default size of huge pages from /proc/meminfo, or ZYLIB_PRIVATE_MMAP_DEFAULT_HUGE_PAGE_SIZE if it is
+ * unavailable
+ */
+static size_t zylib_private_mmap_get_huge_page_size(void)
+{
+    size_t huge_page_size = ZYLIB_PRIVATE_MMAP_DEFAULT_HUGE_PAGE_SIZE;
+#if defined(__linux__)
+    char line[128];
+    size_t kib;
+    FILE *const file = fopen("/proc/meminfo", "r");
+
+    if (file == NULL)
+    {
+        return huge_page_size;
+    }
+
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        if (sscanf(line, "Hugepagesize: %zu kB", &kib) == 1)
+        {
+            /* Anything but a power of two would break the rounding of mapping lengths */
+            if (kib > 0 && kib <= SIZE_MAX / 1024 && (kib & (kib - 1)) == 0)
+            {
+                huge_page_size = kib * 1024;
+            }
+            break;
+        }
+    }
+    fclose(file);
+#endif
+    return huge_page_size;
+}
+
+/*
+ * Map a zero-filled block, or return NULL
+ */
+ZYLIB_NONNULL
+static zylib_private_mmap_block_t *zylib_private_mmap_map(const zylib_private_mmap_t *state, size_t size)
+{
+#if ZYLIB_PRIVATE_MMAP_SUPPORTED
+    const size_t length = zylib_private_mmap_round(sizeof(zylib_private_mmap_block_t) + size, state->page_size);
+    size_t x_length = length;
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+    void *ptr = MAP_FAILED;
+    _Bool populated = 0;
+    zylib_private_mmap_block_t *block;
+
+#if defined(MAP_POPULATE)
+    /* With transparent huge pages, prefaulting is deferred until the advice is in place */
+    if ((state->flags & ZYLIB_ALLOCATOR_MMAP_POPULATE) && !(state->flags & ZYLIB_ALLOCATOR_MMAP_TRANSPARENT_HUGEPAGE))
+    {
+        flags |= MAP_POPULATE;
+        populated = 1;
+    }
+#endif
+
+#if defined(MAP_HUGETLB)
+    if (state->flags & ZYLIB_ALLOCATOR_MMAP_HUGETLB)
+    {
+        x_length = zylib_private_mmap_round(length, state->huge_page_size);
+        ptr = mmap(NULL, x_length, PROT_READ | PROT_WRITE, flags | MAP_HUGETLB, -1, 0);
+    }
+#endif
+
+    if (ptr == MAP_FAILED)
+    {
+        x_length = length;
+        ptr = mmap(NULL, x_length, PROT_READ | PROT_WRITE, flags, -1, 0);
+        if (ptr == MAP_FAILED)
+        {
+            return NULL;
+        }
+    }
+
+#if defined(MADV_HUGEPAGE)
+    if (state->flags & ZYLIB_ALLOCATOR_MMAP_TRANSPARENT_HUGEPAGE)
+    {
+        madvise(ptr, x_length, MADV_HUGEPAGE);
+    }
+#endif
+
+    if ((state->flags & ZYLIB_ALLOCATOR_MMAP_POPULATE) && !populated)
+    {
+        for (size_t offset = 0; offset < x_length; offset += state->page_size)
+        {
+            ((volatile unsigned char *)ptr)[offset] = 0;
+        }
+    }
+
+    block = ptr;
+    block->size = size;
+    block->length = x_length;
+    return block;
+#else
+    (void)(state);
+    (void)(size);
+    return NULL;
+#endif
+}
+
+/*
+ * Resize a mapping, moving it if need be, or return NULL
+ */
+ZYLIB_NONNULL
+static zylib_private_mmap_block_t *zylib_private_mmap_remap(const zylib_private_mmap_t *state,
+                                                            zylib_private_mmap_block_t *block, size_t size)
+{
+#if ZYLIB_PRIVATE_MMAP_SUPPORTED && defined(MREMAP_MAYMOVE)
+    /* A mapping that might be backed by huge pages must keep a length that is a multiple of their size */
+    const size_t alignment = (state->flags & ZYLIB_ALLOCATOR_MMAP_HUGETLB) ? state->huge_page_size : state->page_size;
+    const size_t length = zylib_private_mmap_round(sizeof(zylib_private_mmap_block_t) + size, alignment);
+    void *const ptr = mremap(block, block->length, length, MREMAP_MAYMOVE);
+
+    if (ptr == MAP_FAILED)
+    {
+        return NULL;
+    }
+
+    block = ptr;
+    block->size = size;
+    block->length = length;
+    return block;
+#else
+    (void)(state);
+    (void)(block);
+    (void)(size);
+    return NULL;
+#endif
+}
+
+ZYLIB_NONNULL
+static void zylib_private_mmap_unmap(zylib_private_mmap_block_t *block)
+{
+#if ZYLIB_PRIVATE_MMAP_SUPPORTED
+    munmap(block, block->length);
+#else
+    (void)(block);
+#endif
+}
+
+/*
+ * Allocate a block from the mapping or from the parent allocator object, depending on its size
+ */
+ZYLIB_NONNULL
+static zylib_private_mmap_block_t *zylib_private_mmap_allocate(const zylib_private_mmap_t *state, size_t size,
+                                                               _Bool zero)
+{
+    zylib_private_mmap_block_t *block = NULL;
+
+    if (size > SIZE_MAX - sizeof(zylib_private_mmap_block_t) - state->huge_page_size)
+    {
+        return NULL;
+    }
+
+    if (size >= state->threshold && (block = zylib_private_mmap_map(state, size)) != NULL)
+    {
+        return block;
+    }
+
+    if (zero ? !zylib_private_allocator_calloc(state->parent, sizeof(zylib_private_mmap_block_t) + size,
+                                               (void **)&block)
+             : !zylib_private_allocator_malloc(state->parent, sizeof(zylib_private_mmap_block_t) + size,
+                                               (void **)&block))
+    {
+        return NULL;
+    }
+    block->size = size;
+    block->length = 0;
+    return block;
+}
+
+void *zylib_private_mmap_malloc(void *context, size_t size)
+{
+    zylib_private_mmap_block_t *const block = zylib_private_mmap_allocate(context, size, 0);
+    return block != NULL ? block->data : NULL;
+}
+
+void *zylib_private_mmap_calloc(void *context, size_t size)
+{
+    zylib_private_mmap_block_t *const block = zylib_private_mmap_allocate(context, size, 1);
+    return block != NULL ? block->data : NULL;
+}
+
+void *zylib_private_mmap_realloc(void *context, void *ptr, size_t old_size, size_t size)
+{
+    const zylib_private_mmap_t *const state = context;
+    zylib_private_mmap_block_t *block = zylib_private_mmap_header(ptr);
+    void *x_ptr;
+
+    (void)(old_size);
+
+    if (block->length == 0 && size < state->threshold)
+    {
+        if (!zylib_private_allocator_realloc_sized(state->parent, sizeof(zylib_private_mmap_block_t) + block->size,
+                                                   sizeof(zylib_private_mmap_block_t) + size, (void **)&block))
+        {
+            return NULL;
+        }
+        block->size = size;
+        return block->data;
+    }
+
+    if (block->length != 0 && size >= state->threshold && sizeof(zylib_private_mmap_block_t) + size <= block->length)
+    {
+        block->size = size;
+        return ptr;
+    }
+
+    if (block->length != 0 && size >= state->threshold && (state->flags & ZYLIB_ALLOCATOR_MMAP_REMAP) &&
+        size <= SIZE_MAX - sizeof(zylib_private_mmap_block_t) - state->huge_page_size)
+    {
+        zylib_private_mmap_block_t *const x_block = zylib_private_mmap_remap(state, block, size);
+        if (x_block != NULL)
+        {
+            return x_block->data;
+        }
+    }
+
+    x_ptr = zylib_private_mmap_malloc(context, size);
+    if (x_ptr != NULL)
+    {
+        memcpy(x_ptr, ptr, block->size < size ? block->size : size);
+        zylib_private_mmap_free(context, ptr, 0);
+    }
+    return x_ptr;
+}
+
+void zylib_private_mmap_free(void *context, void *ptr, size_t size)
+{
+    const zylib_private_mmap_t *const state = context;
+    zylib_private_mmap_block_t *block = zylib_private_mmap_header(ptr);
+
+    (void)(size);
+
+    if (block->length != 0)
+    {
+        zylib_private_mmap_unmap(block);
+        return;
+    }
+    zylib_private_allocator_free_sized(state->parent, sizeof(zylib_private_mmap_block_t) + block->size,
+                                       (void **)&block);
+}
+
+void zylib_private_mmap_destruct(void *context)
+{
+    zylib_private_mmap_t *state = context;
+    zylib_private_allocator_free_sized(state->parent, sizeof(zylib_private_mmap_t), (void **)&state);
+}
+
+/*
+ * Function Definitions
+ */
+
+_Bool zylib_private_mmap_construct(zylib_private_allocator_t **obj, size_t threshold, unsigned flags,
+                                   const zylib_private_allocator_t *parent)
+{
+    _Bool r;
+    zylib_private_mmap_t *state = NULL;
+
+    *obj = NULL;
+    r = zylib_private_allocator_malloc(parent, sizeof(zylib_private_mmap_t), (void **)&state);
+    if (!r)
+    {
+        goto error;
+    }
+
+    state->parent = parent;
+    state->threshold = threshold;
+    state->flags = flags;
+#if ZYLIB_PRIVATE_MMAP_SUPPORTED
+    const long page_size = sysconf(_SC_PAGESIZE);
+    state->page_size = page_size > 0 ? (size_t)page_size : 4096;
+#else
+    state->page_size = 4096;
+#endif
+    /* Reading /proc/meminfo is only worth it when huge pages are requested */
+    state->huge_page_size = (flags & ZYLIB_ALLOCATOR_MMAP_HUGETLB) ? zylib_private_mmap_get_huge_page_size()
+                                                                    : ZYLIB_PRIVATE_MMAP_DEFAULT_HUGE_PAGE_SIZE;
+
+    r = zylib_private_allocator_construct_context(obj, parent, &zylib_private_mmap_vtable, state);
+    if (!r)
+    {
+        goto error;
+    }
+
+    goto done;
+error:
+    if (state != NULL)
+    {
+        zylib_private_allocator_free_sized(parent, sizeof(zylib_private_mmap_t), (void **)&state);
+    }
+done:
+    return r;
+}
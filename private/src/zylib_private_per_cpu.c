@@ -0,0 +1,277 @@
+/*
+ * Copyright 2023 Alexandre Fernandez <alex@fernandezfamily.email>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#if !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+#include "zylib_private_per_cpu.h"
+#include "zylib_private_bins.h"
+#include <limits.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+#include <threads.h>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+/*
+ * Macros
+ */
+
+/* The number of blocks of a size class a shard keeps before flushing a batch to the parent allocator */
+#define ZYLIB_PRIVATE_PER_CPU_LIMIT (4U * ZYLIB_PRIVATE_BINS_BATCH)
+
+#define ZYLIB_PRIVATE_PER_CPU_MAX_SHARDS (256U)
+#define ZYLIB_PRIVATE_PER_CPU_LINE_SIZE (64U)
+
+/*
+ * Type Definitions
+ */
+
+typedef struct zylib_private_per_cpu_shard_s
+{
+    _Alignas(ZYLIB_PRIVATE_PER_CPU_LINE_SIZE) mtx_t lock;
+    zylib_private_bins_t bins;
+} zylib_private_per_cpu_shard_t;
+
+typedef struct zylib_private_per_cpu_s
+{
+    const zylib_private_allocator_t *parent;
+    mtx_t lock;
+    size_t shard_n;
+    zylib_private_per_cpu_shard_t *shards;
+} zylib_private_per_cpu_t;
+
+/*
+ * Static Function Declarations
+ */
+
+static void *zylib_private_per_cpu_malloc(void *context, size_t size);
+
+static void *zylib_private_per_cpu_realloc(void *context, void *ptr, size_t old_size, size_t size);
+
+static void zylib_private_per_cpu_free(void *context, void *ptr, size_t size);
+
+static void zylib_private_per_cpu_destruct(void *context);
+
+/*
+ * Static Variables
+ */
+
+static const zylib_allocator_vtable_t zylib_private_per_cpu_vtable = {.malloc = zylib_private_per_cpu_malloc,
+                                                                      .calloc = NULL,
+                                                                      .realloc = zylib_private_per_cpu_realloc,
+                                                                      .free = zylib_private_per_cpu_free,
+                                                                      .aligned_malloc = NULL,
+                                                                      .aligned_free = NULL,
+                                                                      .destruct = zylib_private_per_cpu_destruct};
+
+/* Without a way to query the current CPU, threads are spread over the shards in turn */
+static atomic_uint zylib_private_per_cpu_next_thread = 0;
+static _Thread_local unsigned zylib_private_per_cpu_thread = UINT_MAX;
+
+/*
+ * Static Function Definitions
+ */
+
+static size_t zylib_private_per_cpu_cpus(void)
+{
+#if defined(_SC_NPROCESSORS_CONF)
+    const long n = sysconf(_SC_NPROCESSORS_CONF);
+    if (n > 0)
+    {
+        return (size_t)n < ZYLIB_PRIVATE_PER_CPU_MAX_SHARDS ? (size_t)n : ZYLIB_PRIVATE_PER_CPU_MAX_SHARDS;
+    }
+#endif
+    return 1;
+}
+
+ZYLIB_NONNULL
+static inline zylib_private_per_cpu_shard_t *zylib_private_per_cpu_shard(const zylib_private_per_cpu_t *state)
+{
+#if defined(__linux__)
+    const int cpu = sched_getcpu();
+    if (cpu >= 0)
+    {
+        return &state->shards[(size_t)cpu % state->shard_n];
+    }
+#endif
+    if (zylib_private_per_cpu_thread == UINT_MAX)
+    {
+        zylib_private_per_cpu_thread = atomic_fetch_add_explicit(&zylib_private_per_cpu_next_thread, 1,
+                                                                 memory_order_relaxed) % UINT_MAX;
+    }
+    return &state->shards[zylib_private_per_cpu_thread % state->shard_n];
+}
+
+void *zylib_private_per_cpu_malloc(void *context, size_t size)
+{
+    zylib_private_per_cpu_t *const state = context;
+    zylib_private_per_cpu_shard_t *shard;
+    zylib_private_bins_block_t *block = NULL;
+    size_t c;
+
+    if (size > ZYLIB_PRIVATE_BINS_MAX_SIZE)
+    {
+        return zylib_private_bins_malloc_large(state->parent, &state->lock, size);
+    }
+
+    c = zylib_private_bins_class(size);
+    shard = zylib_private_per_cpu_shard(state);
+    mtx_lock(&shard->lock);
+    if (shard->bins.heads[c] != NULL || zylib_private_bins_refill(&shard->bins, state->parent, &state->lock, c))
+    {
+        block = shard->bins.heads[c];
+        shard->bins.heads[c] = block->next;
+        --shard->bins.count[c];
+    }
+    mtx_unlock(&shard->lock);
+
+    return block != NULL ? block->data : NULL;
+}
+
+void *zylib_private_per_cpu_realloc(void *context, void *ptr, size_t old_size, size_t size)
+{
+    zylib_private_per_cpu_t *const state = context;
+
+    (void)(old_size);
+
+    return zylib_private_bins_realloc(&zylib_private_per_cpu_vtable, context, state->parent, &state->lock, ptr, size);
+}
+
+void zylib_private_per_cpu_free(void *context, void *ptr, size_t size)
+{
+    zylib_private_per_cpu_t *const state = context;
+    zylib_private_bins_block_t *const block = zylib_private_bins_header(ptr);
+    zylib_private_per_cpu_shard_t *shard;
+    size_t c;
+
+    (void)(size);
+
+    if (block->size > ZYLIB_PRIVATE_BINS_MAX_SIZE)
+    {
+        mtx_lock(&state->lock);
+        zylib_private_bins_release(state->parent, block);
+        mtx_unlock(&state->lock);
+        return;
+    }
+
+    /* Blocks return to the shard of the CPU that frees them, wherever they were allocated */
+    c = zylib_private_bins_class(block->size);
+    shard = zylib_private_per_cpu_shard(state);
+    mtx_lock(&shard->lock);
+    block->next = shard->bins.heads[c];
+    shard->bins.heads[c] = block;
+    if (++shard->bins.count[c] > ZYLIB_PRIVATE_PER_CPU_LIMIT)
+    {
+        zylib_private_bins_flush(&shard->bins, state->parent, &state->lock, c, ZYLIB_PRIVATE_BINS_BATCH);
+    }
+    mtx_unlock(&shard->lock);
+}
+
+void zylib_private_per_cpu_destruct(void *context)
+{
+    zylib_private_per_cpu_t *state = context;
+
+    for (size_t i = 0; i < state->shard_n; ++i)
+    {
+        zylib_private_per_cpu_shard_t *const shard = &state->shards[i];
+        zylib_private_bins_empty(&shard->bins, state->parent);
+        mtx_destroy(&shard->lock);
+    }
+    zylib_private_allocator_aligned_free(state->parent, _Alignof(zylib_private_per_cpu_shard_t),
+                                         sizeof(zylib_private_per_cpu_shard_t) * state->shard_n,
+                                         (void **)&state->shards);
+    mtx_destroy(&state->lock);
+    zylib_private_allocator_free_sized(state->parent, sizeof(zylib_private_per_cpu_t), (void **)&state);
+}
+
+/*
+ * Function Definitions
+ */
+
+_Bool zylib_private_per_cpu_construct(zylib_private_allocator_t **obj, const zylib_private_allocator_t *parent)
+{
+    _Bool r;
+    zylib_private_per_cpu_t *state = NULL;
+    size_t shard_n = 0;
+
+    *obj = NULL;
+    r = zylib_private_allocator_malloc(parent, sizeof(zylib_private_per_cpu_t), (void **)&state);
+    if (!r)
+    {
+        goto error;
+    }
+
+    state->parent = parent;
+    state->shard_n = zylib_private_per_cpu_cpus();
+    state->shards = NULL;
+
+    if (mtx_init(&state->lock, mtx_plain) != thrd_success)
+    {
+        r = 0;
+        goto error;
+    }
+
+    r = zylib_private_allocator_aligned_malloc(parent, _Alignof(zylib_private_per_cpu_shard_t),
+                                               sizeof(zylib_private_per_cpu_shard_t) * state->shard_n,
+                                               (void **)&state->shards);
+    if (!r)
+    {
+        mtx_destroy(&state->lock);
+        goto error;
+    }
+
+    memset(state->shards, 0, sizeof(zylib_private_per_cpu_shard_t) * state->shard_n);
+    for (; shard_n < state->shard_n; ++shard_n)
+    {
+        if (mtx_init(&state->shards[shard_n].lock, mtx_plain) != thrd_success)
+        {
+            r = 0;
+            goto error;
+        }
+    }
+
+    r = zylib_private_allocator_construct_context(obj, parent, &zylib_private_per_cpu_vtable, state);
+    if (!r)
+    {
+        goto error;
+    }
+
+    goto done;
+error:
+    if (state != NULL && state->shards != NULL)
+    {
+        while (shard_n-- > 0)
+        {
+            mtx_destroy(&state->shards[shard_n].lock);
+        }
+        zylib_private_allocator_aligned_free(parent, _Alignof(zylib_private_per_cpu_shard_t),
+                                             sizeof(zylib_private_per_cpu_shard_t) * state->shard_n,
+                                             (void **)&state->shards);
+        mtx_destroy(&state->lock);
+    }
+    if (state != NULL)
+    {
+        zylib_private_allocator_free_sized(parent, sizeof(zylib_private_per_cpu_t), (void **)&state);
+    }
+done:
+    return r;
+}
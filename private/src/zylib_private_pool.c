@@ -0,0 +1,409 @@
+/*
+ * Copyright 2023 Alexandre Fernandez <alex@fernandezfamily.email>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "zylib_private_pool.h"
+#include "zylib_private_arena.h"
+#include "zylib_private_size_class.h"
+#include <stdatomic.h>
+#include <stdint.h>
+
+/*
+ * Macros
+ */
+
+#define ZYLIB_PRIVATE_POOL_SLAB_SIZE (4096U)
+
+/*
+ * Type Definitions
+ */
+
+typedef struct zylib_private_pool_slab_s
+{
+    /* The number of objects of the slab currently allocated, including those freed remotely but not yet reclaimed */
+    size_t live;
+    /* The time at which the slab last became empty, while decay is enabled */
+    uint64_t idle;
+    max_align_t data[];
+} zylib_private_pool_slab_t;
+
+typedef struct zylib_private_pool_object_s
+{
+    struct zylib_private_pool_object_s *next;
+} zylib_private_pool_object_t;
+
+struct zylib_private_pool_s
+{
+    const zylib_private_allocator_t *allocator;
+    size_t size;
+    size_t slab_size;
+    /* Every slab, sorted by address so that an object is located in its slab on deallocation */
+    zylib_private_pool_slab_t **slabs;
+    size_t slab_n, slab_capacity;
+    zylib_private_pool_object_t *free_list;
+    /* The slab that objects never allocated before are carved from */
+    zylib_private_pool_slab_t *current;
+    unsigned char *cursor, *end;
+    /* The number of objects currently allocated, including those freed remotely but not yet reclaimed */
+    size_t used;
+    /* The decay period in milliseconds, which follows the allocator object unless set, and the last time empty slabs
+     * were looked at */
+    uint64_t decay, epoch;
+    _Bool has_decay;
+    /* Objects freed by other threads, pushed without a lock and reclaimed by the owner */
+    _Atomic(zylib_private_pool_object_t *) remote;
+};
+
+/*
+ * Static Function Definitions
+ */
+
+/*
+ * Locate the slab holding an object
+ */
+ZYLIB_NONNULL
+static zylib_private_pool_slab_t *zylib_private_pool_find(const zylib_private_pool_t *obj, const void *ptr)
+{
+    size_t low = 0, high = obj->slab_n;
+
+    /* Find the last slab that starts at or before the object */
+    while (low < high)
+    {
+        const size_t middle = low + (high - low) / 2;
+        if ((uintptr_t)obj->slabs[middle] <= (uintptr_t)ptr)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    return obj->slabs[low - 1];
+}
+
+ZYLIB_NONNULL
+static _Bool zylib_private_pool_grow(zylib_private_pool_t *obj)
+{
+    zylib_private_pool_slab_t *slab = NULL;
+    size_t i;
+
+    if (obj->slab_n == obj->slab_capacity)
+    {
+        const size_t capacity = obj->slab_capacity != 0 ? obj->slab_capacity * 2 : 16;
+        if (obj->slabs == NULL
+                ? !zylib_private_allocator_malloc(obj->allocator, capacity * sizeof(zylib_private_pool_slab_t *),
+                                                  (void **)&obj->slabs)
+                : !zylib_private_allocator_realloc_sized(obj->allocator,
+                                                         obj->slab_capacity * sizeof(zylib_private_pool_slab_t *),
+                                                         capacity * sizeof(zylib_private_pool_slab_t *),
+                                                         (void **)&obj->slabs))
+        {
+            return 0;
+        }
+        obj->slab_capacity = capacity;
+    }
+
+    if (!zylib_private_allocator_malloc(obj->allocator, obj->slab_size, (void **)&slab))
+    {
+        return 0;
+    }
+
+    for (i = obj->slab_n; i > 0 && (uintptr_t)obj->slabs[i - 1] > (uintptr_t)slab; --i)
+    {
+        obj->slabs[i] = obj->slabs[i - 1];
+    }
+    obj->slabs[i] = slab;
+    ++obj->slab_n;
+
+    slab->live = 0;
+    slab->idle = 0;
+    obj->current = slab;
+    obj->cursor = (unsigned char *)slab->data;
+    obj->end = (unsigned char *)slab + obj->slab_size;
+    return 1;
+}
+
+/*
+ * Retrieve the decay period of a pool object, which is that of its allocator object unless set
+ */
+ZYLIB_NONNULL
+static uint64_t zylib_private_pool_get_decay(const zylib_private_pool_t *obj)
+{
+    uint64_t decay = 0;
+
+    if (obj->has_decay)
+    {
+        return obj->decay;
+    }
+    if (!zylib_private_size_class_peek_decay(obj->allocator, &decay))
+    {
+        (void)zylib_private_arena_peek_decay(obj->allocator, &decay);
+    }
+    return decay;
+}
+
+/*
+ * Return to the allocator object the slabs that have been empty for a whole period, dropping their objects from the
+ * free list
+ */
+ZYLIB_NONNULL
+static void zylib_private_pool_collect(zylib_private_pool_t *obj, uint64_t now, uint64_t period)
+{
+    zylib_private_pool_object_t **link = &obj->free_list;
+    size_t n = 0;
+
+    for (size_t i = 0; i < obj->slab_n; ++i)
+    {
+        n += obj->slabs[i]->live == 0 && now - obj->slabs[i]->idle >= period;
+    }
+    if (n == 0)
+    {
+        return;
+    }
+
+    while (*link != NULL)
+    {
+        const zylib_private_pool_slab_t *const slab = zylib_private_pool_find(obj, *link);
+        if (slab->live == 0 && now - slab->idle >= period)
+        {
+            *link = (*link)->next;
+        }
+        else
+        {
+            link = &(*link)->next;
+        }
+    }
+
+    n = 0;
+    for (size_t i = 0; i < obj->slab_n; ++i)
+    {
+        zylib_private_pool_slab_t *slab = obj->slabs[i];
+        if (slab->live == 0 && now - slab->idle >= period)
+        {
+            if (slab == obj->current)
+            {
+                obj->current = NULL;
+                obj->cursor = NULL;
+                obj->end = NULL;
+            }
+            zylib_private_allocator_free_sized(obj->allocator, obj->slab_size, (void **)&slab);
+        }
+        else
+        {
+            obj->slabs[n++] = slab;
+        }
+    }
+    obj->slab_n = n;
+}
+
+/*
+ * Put a deallocated object onto the free list; once its slab is empty, the slabs that have been empty for a whole
+ * decay period are returned, at most once per period
+ */
+ZYLIB_NONNULL
+static void zylib_private_pool_put(zylib_private_pool_t *obj, zylib_private_pool_object_t *object)
+{
+    zylib_private_pool_slab_t *const slab = zylib_private_pool_find(obj, object);
+
+    object->next = obj->free_list;
+    obj->free_list = object;
+    --obj->used;
+
+    if (--slab->live == 0)
+    {
+        const uint64_t decay = zylib_private_pool_get_decay(obj);
+        if (decay != 0)
+        {
+            const uint64_t now = zylib_private_allocator_clock();
+            slab->idle = now;
+            if (now - obj->epoch >= decay)
+            {
+                zylib_private_pool_collect(obj, now, decay);
+                obj->epoch = now;
+            }
+        }
+    }
+}
+
+/*
+ * Move every object freed by another thread onto the free list at once
+ */
+ZYLIB_NONNULL
+static void zylib_private_pool_reclaim(zylib_private_pool_t *obj)
+{
+    zylib_private_pool_object_t *object = atomic_exchange_explicit(&obj->remote, NULL, memory_order_acquire);
+
+    while (object != NULL)
+    {
+        zylib_private_pool_object_t *const next = object->next;
+        zylib_private_pool_put(obj, object);
+        object = next;
+    }
+}
+
+ZYLIB_NONNULL
+static void zylib_private_pool_release(zylib_private_pool_t *obj)
+{
+    for (size_t i = 0; i < obj->slab_n; ++i)
+    {
+        zylib_private_allocator_free_sized(obj->allocator, obj->slab_size, (void **)&obj->slabs[i]);
+    }
+    if (obj->slabs != NULL)
+    {
+        zylib_private_allocator_free_sized(obj->allocator, obj->slab_capacity * sizeof(zylib_private_pool_slab_t *),
+                                           (void **)&obj->slabs);
+    }
+    obj->slab_n = 0;
+    obj->slab_capacity = 0;
+    obj->free_list = NULL;
+    obj->current = NULL;
+    obj->cursor = NULL;
+    obj->end = NULL;
+}
+
+/*
+ * Function Definitions
+ */
+
+_Bool zylib_private_pool_construct(zylib_private_pool_t **obj, const zylib_private_allocator_t *allocator, size_t size)
+{
+    _Bool r;
+
+    if (size <= 0 || size > SIZE_MAX / 2)
+    {
+        return 0;
+    }
+
+    *obj = NULL;
+    r = zylib_private_allocator_malloc(allocator, sizeof(zylib_private_pool_t), (void **)obj);
+    if (!r)
+    {
+        goto error;
+    }
+
+    /* Every object must be able to hold a free list link, and be aligned like memory from the allocator */
+    if (size < sizeof(zylib_private_pool_object_t))
+    {
+        size = sizeof(zylib_private_pool_object_t);
+    }
+    size = (size + _Alignof(max_align_t) - 1) & ~(_Alignof(max_align_t) - 1);
+
+    (*obj)->allocator = allocator;
+    (*obj)->size = size;
+    (*obj)->slab_size = sizeof(zylib_private_pool_slab_t) + size > ZYLIB_PRIVATE_POOL_SLAB_SIZE
+                            ? sizeof(zylib_private_pool_slab_t) + size
+                            : ZYLIB_PRIVATE_POOL_SLAB_SIZE;
+    (*obj)->slabs = NULL;
+    (*obj)->slab_n = 0;
+    (*obj)->slab_capacity = 0;
+    (*obj)->free_list = NULL;
+    (*obj)->current = NULL;
+    (*obj)->cursor = NULL;
+    (*obj)->end = NULL;
+    (*obj)->used = 0;
+    (*obj)->decay = 0;
+    (*obj)->epoch = 0;
+    (*obj)->has_decay = 0;
+    atomic_init(&(*obj)->remote, NULL);
+
+error:
+    return r;
+}
+
+void zylib_private_pool_destruct(zylib_private_pool_t **obj)
+{
+    if (*obj != NULL)
+    {
+        zylib_private_pool_release(*obj);
+        zylib_private_allocator_free_sized((*obj)->allocator, sizeof(zylib_private_pool_t), (void **)obj);
+    }
+}
+
+_Bool zylib_private_pool_malloc(zylib_private_pool_t *obj, void **ptr)
+{
+    if (obj->free_list == NULL && atomic_load_explicit(&obj->remote, memory_order_relaxed) != NULL)
+    {
+        zylib_private_pool_reclaim(obj);
+    }
+
+    if (obj->free_list != NULL)
+    {
+        *ptr = obj->free_list;
+        obj->free_list = obj->free_list->next;
+        ++zylib_private_pool_find(obj, *ptr)->live;
+        ++obj->used;
+        return 1;
+    }
+
+    if ((obj->cursor == NULL || (size_t)(obj->end - obj->cursor) < obj->size) && !zylib_private_pool_grow(obj))
+    {
+        return 0;
+    }
+
+    *ptr = obj->cursor;
+    obj->cursor += obj->size;
+    ++obj->current->live;
+    ++obj->used;
+    return 1;
+}
+
+void zylib_private_pool_free(zylib_private_pool_t *obj, void **ptr)
+{
+    if (*ptr != NULL)
+    {
+        zylib_private_pool_put(obj, *ptr);
+        *ptr = NULL;
+    }
+}
+
+size_t zylib_private_pool_peek_size(const zylib_private_pool_t *obj)
+{
+    return obj->size;
+}
+
+void zylib_private_pool_free_remote(zylib_private_pool_t *obj, void **ptr)
+{
+    if (*ptr != NULL)
+    {
+        zylib_private_pool_object_t *const object = *ptr;
+        zylib_private_pool_object_t *head = atomic_load_explicit(&obj->remote, memory_order_relaxed);
+        do
+        {
+            object->next = head;
+        } while (!atomic_compare_exchange_weak_explicit(&obj->remote, &head, object, memory_order_release,
+                                                        memory_order_relaxed));
+        *ptr = NULL;
+    }
+}
+
+_Bool zylib_private_pool_trim(zylib_private_pool_t *obj)
+{
+    zylib_private_pool_reclaim(obj);
+    zylib_private_pool_collect(obj, zylib_private_allocator_clock(), 0);
+    return obj->used == 0;
+}
+
+void zylib_private_pool_set_decay(zylib_private_pool_t *obj, uint64_t decay)
+{
+    const uint64_t now = zylib_private_allocator_clock();
+
+    obj->decay = decay;
+    obj->has_decay = 1;
+    obj->epoch = now;
+    for (size_t i = 0; i < obj->slab_n; ++i)
+    {
+        obj->slabs[i]->idle = now;
+    }
+}
@@ -0,0 +1,406 @@
+/*
+ * Copyright 2023 Alexandre Fernandez <alex@fernandezfamily.email>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "zylib_private_profiler.h"
+#include <stdint.h>
+#include <string.h>
+#include <threads.h>
+
+#if defined(__has_include)
+#if __has_include(<execinfo.h>)
+#include <execinfo.h>
+#define ZYLIB_PRIVATE_PROFILER_BACKTRACE (1)
+#endif
+#endif
+
+/*
+ * Macros
+ */
+
+#define ZYLIB_PRIVATE_PROFILER_MAX_DEPTH (32U)
+#define ZYLIB_PRIVATE_PROFILER_BUCKET_N (256U)
+
+/* The most frames of the profiler itself that a backtrace may start with, above the caller of the function table */
+#define ZYLIB_PRIVATE_PROFILER_SKIP_MAX (8U)
+
+/*
+ * The return address of the function table entry, which is the first frame recorded: matching it in a backtrace skips
+ * the frames of the profiler whatever the compiler inlined
+ */
+#if defined(__GNUC__)
+#define ZYLIB_PRIVATE_PROFILER_CALLER() __builtin_return_address(0)
+#else
+#define ZYLIB_PRIVATE_PROFILER_CALLER() NULL
+#endif
+
+/*
+ * Type Definitions
+ */
+
+typedef struct zylib_private_profiler_stack_s
+{
+    struct zylib_private_profiler_stack_s *next;
+    size_t hash;
+    size_t depth;
+    void *frames[ZYLIB_PRIVATE_PROFILER_MAX_DEPTH];
+    /* The live samples taken at this stack, and the number of bytes they stand for */
+    size_t count;
+    size_t bytes;
+} zylib_private_profiler_stack_t;
+
+typedef struct zylib_private_profiler_block_s
+{
+    /* The stack at which the block was sampled, or NULL */
+    zylib_private_profiler_stack_t *stack;
+    size_t size;
+    max_align_t data[];
+} zylib_private_profiler_block_t;
+
+typedef struct zylib_private_profiler_s
+{
+    const zylib_private_allocator_t *parent;
+    size_t sample_rate;
+    mtx_t lock;
+    zylib_private_profiler_stack_t *buckets[ZYLIB_PRIVATE_PROFILER_BUCKET_N];
+} zylib_private_profiler_t;
+
+/*
+ * Static Function Declarations
+ */
+
+static void *zylib_private_profiler_malloc(void *context, size_t size);
+
+static void *zylib_private_profiler_realloc(void *context, void *ptr, size_t old_size, size_t size);
+
+static void zylib_private_profiler_free(void *context, void *ptr, size_t size);
+
+static void zylib_private_profiler_destruct(void *context);
+
+/*
+ * Static Variables
+ */
+
+static const zylib_allocator_vtable_t zylib_private_profiler_vtable = {.malloc = zylib_private_profiler_malloc,
+                                                                       .calloc = NULL,
+                                                                       .realloc = zylib_private_profiler_realloc,
+                                                                       .free = zylib_private_profiler_free,
+                                                                       .aligned_malloc = NULL,
+                                                                       .aligned_free = NULL,
+                                                                       .destruct = zylib_private_profiler_destruct};
+
+/*
+ * The number of bytes each thread allocates before its next sample, and the state of its random number generator;
+ * they are shared by every profiler allocator object that the thread allocates from
+ */
+static _Thread_local size_t zylib_private_profiler_countdown = 0;
+static _Thread_local uint64_t zylib_private_profiler_random = 0;
+
+/*
+ * Static Function Definitions
+ */
+
+ZYLIB_NONNULL
+static inline zylib_private_profiler_block_t *zylib_private_profiler_header(void *ptr)
+{
+    return (zylib_private_profiler_block_t *)((unsigned char *)ptr - sizeof(zylib_private_profiler_block_t));
+}
+
+/*
+ * Draw the distance to the next sample uniformly from [1, 2 * sample_rate], so that it averages sample_rate
+ */
+static size_t zylib_private_profiler_interval(size_t sample_rate)
+{
+    uint64_t x = zylib_private_profiler_random;
+
+    if (x == 0)
+    {
+        x = (uint64_t)(uintptr_t)&zylib_private_profiler_random | 1;
+    }
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    zylib_private_profiler_random = x;
+
+    return sample_rate < SIZE_MAX / 2 ? (size_t)(x % (2 * (uint64_t)sample_rate)) + 1 : sample_rate;
+}
+
+/*
+ * Decide whether an allocation of size bytes is sampled
+ */
+static inline _Bool zylib_private_profiler_sample(size_t sample_rate, size_t size)
+{
+    if (sample_rate == 0)
+    {
+        return 1;
+    }
+    if (zylib_private_profiler_countdown == 0)
+    {
+        zylib_private_profiler_countdown = zylib_private_profiler_interval(sample_rate);
+    }
+    if (size < zylib_private_profiler_countdown)
+    {
+        zylib_private_profiler_countdown -= size;
+        return 0;
+    }
+    zylib_private_profiler_countdown = zylib_private_profiler_interval(sample_rate);
+    return 1;
+}
+
+/*
+ * Look up, or insert, the stack starting at the return address of the function table entry; the caller holds the lock
+ */
+ZYLIB_NONNULL_N(1)
+static zylib_private_profiler_stack_t *zylib_private_profiler_capture(zylib_private_profiler_t *profiler, void *caller)
+{
+    void *frames[ZYLIB_PRIVATE_PROFILER_MAX_DEPTH + ZYLIB_PRIVATE_PROFILER_SKIP_MAX];
+    size_t skip = 0;
+    size_t depth;
+    size_t hash = (size_t)14695981039346656037ULL;
+    zylib_private_profiler_stack_t *stack;
+    zylib_private_profiler_stack_t **bucket;
+
+#if defined(ZYLIB_PRIVATE_PROFILER_BACKTRACE)
+    const size_t n =
+        (size_t)backtrace(frames, (int)(ZYLIB_PRIVATE_PROFILER_MAX_DEPTH + ZYLIB_PRIVATE_PROFILER_SKIP_MAX));
+    while (skip < n && frames[skip] != caller)
+    {
+        ++skip;
+    }
+    /* Without a match, such as when the caller is unknown, the whole backtrace is kept */
+    if (skip == n)
+    {
+        skip = 0;
+    }
+    depth = n - skip < ZYLIB_PRIVATE_PROFILER_MAX_DEPTH ? n - skip : ZYLIB_PRIVATE_PROFILER_MAX_DEPTH;
+#else
+    frames[0] = caller;
+    depth = caller != NULL ? 1 : 0;
+#endif
+
+    for (size_t i = 0; i < depth; ++i)
+    {
+        hash = (hash ^ (size_t)(uintptr_t)frames[skip + i]) * (size_t)1099511628211ULL;
+    }
+
+    bucket = &profiler->buckets[hash % ZYLIB_PRIVATE_PROFILER_BUCKET_N];
+    for (stack = *bucket; stack != NULL; stack = stack->next)
+    {
+        if (stack->hash == hash && stack->depth == depth &&
+            memcmp(stack->frames, &frames[skip], depth * sizeof(void *)) == 0)
+        {
+            return stack;
+        }
+    }
+
+    if (!zylib_private_allocator_malloc(profiler->parent, sizeof(zylib_private_profiler_stack_t), (void **)&stack))
+    {
+        return NULL;
+    }
+    stack->hash = hash;
+    stack->depth = depth;
+    memcpy(stack->frames, &frames[skip], depth * sizeof(void *));
+    stack->count = 0;
+    stack->bytes = 0;
+    stack->next = *bucket;
+    *bucket = stack;
+    return stack;
+}
+
+/*
+ * Account a sampled block, allocated by a call returning to caller; it stands for every allocation made until the next
+ * sample
+ */
+ZYLIB_NONNULL_N(1)
+ZYLIB_NONNULL_N(2)
+static void zylib_private_profiler_record(zylib_private_profiler_t *profiler, zylib_private_profiler_block_t *block,
+                                          void *caller)
+{
+    mtx_lock(&profiler->lock);
+    block->stack = zylib_private_profiler_capture(profiler, caller);
+    if (block->stack != NULL)
+    {
+        ++block->stack->count;
+        block->stack->bytes += block->size > profiler->sample_rate ? block->size : profiler->sample_rate;
+    }
+    mtx_unlock(&profiler->lock);
+}
+
+ZYLIB_NONNULL
+static void zylib_private_profiler_forget(zylib_private_profiler_t *profiler, zylib_private_profiler_block_t *block)
+{
+    mtx_lock(&profiler->lock);
+    --block->stack->count;
+    block->stack->bytes -= block->size > profiler->sample_rate ? block->size : profiler->sample_rate;
+    mtx_unlock(&profiler->lock);
+    block->stack = NULL;
+}
+
+void *zylib_private_profiler_malloc(void *context, size_t size)
+{
+    zylib_private_profiler_t *const profiler = context;
+    zylib_private_profiler_block_t *block = NULL;
+
+    if (size > SIZE_MAX - sizeof(zylib_private_profiler_block_t) ||
+        !zylib_private_allocator_malloc(profiler->parent, sizeof(zylib_private_profiler_block_t) + size,
+                                        (void **)&block))
+    {
+        return NULL;
+    }
+
+    block->stack = NULL;
+    block->size = size;
+    if (zylib_private_profiler_sample(profiler->sample_rate, size))
+    {
+        zylib_private_profiler_record(profiler, block, ZYLIB_PRIVATE_PROFILER_CALLER());
+    }
+    return block->data;
+}
+
+void *zylib_private_profiler_realloc(void *context, void *ptr, size_t old_size, size_t size)
+{
+    zylib_private_profiler_t *const profiler = context;
+    zylib_private_profiler_block_t *block = zylib_private_profiler_header(ptr);
+
+    (void)(old_size);
+
+    if (size > SIZE_MAX - sizeof(zylib_private_profiler_block_t) ||
+        !zylib_private_allocator_realloc_sized(profiler->parent, sizeof(zylib_private_profiler_block_t) + block->size,
+                                               sizeof(zylib_private_profiler_block_t) + size, (void **)&block))
+    {
+        return NULL;
+    }
+
+    if (block->stack != NULL)
+    {
+        zylib_private_profiler_forget(profiler, block);
+    }
+    block->size = size;
+    if (zylib_private_profiler_sample(profiler->sample_rate, size))
+    {
+        zylib_private_profiler_record(profiler, block, ZYLIB_PRIVATE_PROFILER_CALLER());
+    }
+    return block->data;
+}
+
+void zylib_private_profiler_free(void *context, void *ptr, size_t size)
+{
+    zylib_private_profiler_t *const profiler = context;
+    zylib_private_profiler_block_t *block = zylib_private_profiler_header(ptr);
+
+    (void)(size);
+
+    if (block->stack != NULL)
+    {
+        zylib_private_profiler_forget(profiler, block);
+    }
+    zylib_private_allocator_free_sized(profiler->parent, sizeof(zylib_private_profiler_block_t) + block->size,
+                                       (void **)&block);
+}
+
+void zylib_private_profiler_destruct(void *context)
+{
+    zylib_private_profiler_t *profiler = context;
+
+    for (size_t i = 0; i < ZYLIB_PRIVATE_PROFILER_BUCKET_N; ++i)
+    {
+        zylib_private_profiler_stack_t *stack = profiler->buckets[i];
+        while (stack != NULL)
+        {
+            zylib_private_profiler_stack_t *const next = stack->next;
+            zylib_private_allocator_free_sized(profiler->parent, sizeof(zylib_private_profiler_stack_t),
+                                               (void **)&stack);
+            stack = next;
+        }
+    }
+    mtx_destroy(&profiler->lock);
+    zylib_private_allocator_free_sized(profiler->parent, sizeof(zylib_private_profiler_t), (void **)&profiler);
+}
+
+/*
+ * Function Definitions
+ */
+
+_Bool zylib_private_profiler_construct(zylib_private_allocator_t **obj, size_t sample_rate,
+                                       const zylib_private_allocator_t *parent)
+{
+    _Bool r;
+    zylib_private_profiler_t *profiler = NULL;
+
+    *obj = NULL;
+    r = zylib_private_allocator_malloc(parent, sizeof(zylib_private_profiler_t), (void **)&profiler);
+    if (!r)
+    {
+        goto error;
+    }
+
+    memset(profiler, 0, sizeof(zylib_private_profiler_t));
+    profiler->parent = parent;
+    profiler->sample_rate = sample_rate;
+
+    if (mtx_init(&profiler->lock, mtx_plain) != thrd_success)
+    {
+        r = 0;
+        goto error;
+    }
+
+    r = zylib_private_allocator_construct_context(obj, parent, &zylib_private_profiler_vtable, profiler);
+    if (!r)
+    {
+        mtx_destroy(&profiler->lock);
+        goto error;
+    }
+
+    goto done;
+error:
+    if (profiler != NULL)
+    {
+        zylib_private_allocator_free_sized(parent, sizeof(zylib_private_profiler_t), (void **)&profiler);
+    }
+done:
+    return r;
+}
+
+_Bool zylib_private_profiler_dump(const zylib_private_allocator_t *obj, FILE *stream)
+{
+    zylib_private_profiler_t *profiler;
+    _Bool r = 1;
+
+    if (zylib_private_allocator_peek_vtable(obj) != &zylib_private_profiler_vtable)
+    {
+        return 0;
+    }
+
+    profiler = zylib_private_allocator_peek_context(obj);
+    mtx_lock(&profiler->lock);
+    for (size_t i = 0; i < ZYLIB_PRIVATE_PROFILER_BUCKET_N; ++i)
+    {
+        for (const zylib_private_profiler_stack_t *stack = profiler->buckets[i]; stack != NULL; stack = stack->next)
+        {
+            if (stack->count == 0)
+            {
+                continue;
+            }
+
+            /* Folded stacks list the outermost frame first */
+            for (size_t j = stack->depth; j-- > 0;)
+            {
+                r = r && fprintf(stream, j > 0 ? "%p;" : "%p", stack->frames[j]) >= 0;
+            }
+            r = r && fprintf(stream, " %zu\n", stack->bytes) >= 0;
+        }
+    }
+    mtx_unlock(&profiler->lock);
+    return r;
+}
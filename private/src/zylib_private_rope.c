@@ -0,0 +1,277 @@
+/*
+ * Copyright 2023 Alexandre Fernandez <alex@fernandezfamily.email>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "zylib_private_rope.h"
+#include <string.h>
+
+/*
+ * Type Definitions
+ */
+
+typedef struct zylib_private_rope_chunk_s
+{
+    struct zylib_private_rope_chunk_s *next;
+    size_t size;
+    size_t capacity;
+    max_align_t data[];
+} zylib_private_rope_chunk_t;
+
+struct zylib_private_rope_s
+{
+    const zylib_private_allocator_t *allocator;
+    size_t chunk_size;
+    uint64_t size;
+    zylib_private_rope_chunk_t *first, *last;
+};
+
+/*
+ * Static Function Definitions
+ */
+
+ZYLIB_NONNULL
+static _Bool zylib_private_rope_chunk_construct(zylib_private_rope_chunk_t **obj,
+                                                const zylib_private_allocator_t *allocator, size_t capacity)
+{
+    _Bool r;
+
+    if (capacity > SIZE_MAX - offsetof(zylib_private_rope_chunk_t, data))
+    {
+        return 0;
+    }
+
+    *obj = NULL;
+    r = zylib_private_allocator_malloc(allocator, offsetof(zylib_private_rope_chunk_t, data) + capacity, (void **)obj);
+    if (!r)
+    {
+        return 0;
+    }
+
+    (*obj)->next = NULL;
+    (*obj)->size = 0;
+    (*obj)->capacity = capacity;
+
+    return 1;
+}
+
+ZYLIB_NONNULL_N(2)
+static void zylib_private_rope_chunk_destruct_all(zylib_private_rope_chunk_t *obj,
+                                                  const zylib_private_allocator_t *allocator)
+{
+    while (obj != NULL)
+    {
+        zylib_private_rope_chunk_t *next = obj->next;
+        zylib_private_allocator_free_sized(allocator, offsetof(zylib_private_rope_chunk_t, data) + obj->capacity,
+                                           (void **)&obj);
+        obj = next;
+    }
+}
+
+/*
+ * Copy every chunk of a rope object into a memory region of its size
+ */
+ZYLIB_NONNULL
+static void zylib_private_rope_copy(const zylib_private_rope_t *obj, unsigned char *ptr)
+{
+    for (const zylib_private_rope_chunk_t *chunk = obj->first; chunk != NULL; chunk = chunk->next)
+    {
+        memcpy(ptr, chunk->data, chunk->size);
+        ptr += chunk->size;
+    }
+}
+
+/*
+ * Function Definitions
+ */
+
+_Bool zylib_private_rope_construct(zylib_private_rope_t **obj, const zylib_private_allocator_t *allocator,
+                                   size_t chunk_size)
+{
+    _Bool r;
+
+    *obj = NULL;
+    r = zylib_private_allocator_malloc(allocator, sizeof(zylib_private_rope_t), (void **)obj);
+    if (!r)
+    {
+        return 0;
+    }
+
+    (*obj)->allocator = allocator;
+    (*obj)->chunk_size = chunk_size > 0 ? chunk_size : ZYLIB_PRIVATE_ROPE_CHUNK_SIZE;
+    (*obj)->size = 0;
+    (*obj)->first = NULL;
+    (*obj)->last = NULL;
+
+    return 1;
+}
+
+void zylib_private_rope_destruct(zylib_private_rope_t **obj)
+{
+    if (*obj != NULL)
+    {
+        zylib_private_rope_chunk_destruct_all((*obj)->first, (*obj)->allocator);
+        zylib_private_allocator_free_sized((*obj)->allocator, sizeof(zylib_private_rope_t), (void **)obj);
+    }
+}
+
+_Bool zylib_private_rope_append(zylib_private_rope_t *obj, uint64_t size, const void *ptr)
+{
+    _Bool r;
+    const unsigned char *source = ptr;
+
+    if (size > UINT64_MAX - obj->size)
+    {
+        return 0;
+    }
+
+    while (size > 0)
+    {
+        size_t n;
+
+        if (obj->last == NULL || obj->last->size == obj->last->capacity)
+        {
+            zylib_private_rope_chunk_t *chunk = NULL;
+            r = zylib_private_rope_chunk_construct(&chunk, obj->allocator, obj->chunk_size);
+            if (!r)
+            {
+                return 0;
+            }
+
+            if (obj->last != NULL)
+            {
+                obj->last->next = chunk;
+            }
+            else
+            {
+                obj->first = chunk;
+            }
+            obj->last = chunk;
+        }
+
+        n = obj->last->capacity - obj->last->size;
+        if (n > size)
+        {
+            n = (size_t)size;
+        }
+        memcpy(&((unsigned char *)obj->last->data)[obj->last->size], source, n);
+        obj->last->size += n;
+        obj->size += n;
+        source += n;
+        size -= n;
+    }
+
+    return 1;
+}
+
+_Bool zylib_private_rope_concat(zylib_private_rope_t *obj, zylib_private_rope_t **rope)
+{
+    if (*rope == obj || (*rope)->allocator != obj->allocator || (*rope)->size > UINT64_MAX - obj->size)
+    {
+        return 0;
+    }
+
+    if ((*rope)->first != NULL)
+    {
+        if (obj->last != NULL)
+        {
+            obj->last->next = (*rope)->first;
+        }
+        else
+        {
+            obj->first = (*rope)->first;
+        }
+        obj->last = (*rope)->last;
+        obj->size += (*rope)->size;
+        (*rope)->first = NULL;
+        (*rope)->last = NULL;
+    }
+
+    zylib_private_rope_destruct(rope);
+    return 1;
+}
+
+_Bool zylib_private_rope_next(const zylib_private_rope_t *obj, const void **iterator, uint64_t *size,
+                              const void **ptr)
+{
+    const zylib_private_rope_chunk_t *chunk =
+        *iterator == NULL ? obj->first : ((const zylib_private_rope_chunk_t *)*iterator)->next;
+
+    if (chunk == NULL)
+    {
+        return 0;
+    }
+
+    *iterator = chunk;
+    *size = chunk->size;
+    *ptr = chunk->data;
+
+    return 1;
+}
+
+_Bool zylib_private_rope_flatten(zylib_private_rope_t *obj, const void **ptr)
+{
+    _Bool r;
+    zylib_private_rope_chunk_t *chunk = NULL;
+
+    if (obj->first == NULL || obj->size > SIZE_MAX)
+    {
+        return 0;
+    }
+
+    if (obj->first != obj->last)
+    {
+        r = zylib_private_rope_chunk_construct(&chunk, obj->allocator, (size_t)obj->size);
+        if (!r)
+        {
+            return 0;
+        }
+
+        zylib_private_rope_copy(obj, (unsigned char *)chunk->data);
+        chunk->size = (size_t)obj->size;
+        zylib_private_rope_chunk_destruct_all(obj->first, obj->allocator);
+        obj->first = chunk;
+        obj->last = chunk;
+    }
+
+    *ptr = obj->first->data;
+    return 1;
+}
+
+_Bool zylib_private_rope_release(zylib_private_rope_t **obj, uint64_t *size, void **ptr)
+{
+    _Bool r;
+
+    if ((*obj)->first == NULL || (*obj)->size > SIZE_MAX)
+    {
+        return 0;
+    }
+
+    *ptr = NULL;
+    r = zylib_private_allocator_malloc((*obj)->allocator, (size_t)(*obj)->size, ptr);
+    if (!r)
+    {
+        return 0;
+    }
+
+    zylib_private_rope_copy(*obj, *ptr);
+    *size = (*obj)->size;
+    zylib_private_rope_destruct(obj);
+
+    return 1;
+}
+
+uint64_t zylib_private_rope_peek_size(const zylib_private_rope_t *obj)
+{
+    return obj->size;
+}
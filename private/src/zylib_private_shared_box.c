@@ -0,0 +1,141 @@
+/*
+ * Copyright 2023 Alexandre Fernandez <alex@fernandezfamily.email>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "zylib_private_shared_box.h"
+#include <stdatomic.h>
+#include <stddef.h>
+#include <string.h>
+
+/*
+ * Type Definitions
+ */
+
+struct zylib_private_shared_box_s
+{
+    const zylib_private_allocator_t *allocator;
+    /* The shared box object that owns the memory region, or NULL if it is stored in data */
+    struct zylib_private_shared_box_s *owner;
+    _Atomic uint64_t references;
+    uint64_t size;
+    const unsigned char *region;
+    max_align_t data[];
+};
+
+/*
+ * Function Definitions
+ */
+
+_Bool zylib_private_shared_box_construct(zylib_private_shared_box_t **obj, const zylib_private_allocator_t *allocator,
+                                         uint64_t size, const void *ptr)
+{
+    _Bool r;
+
+    if (size <= 0 || size > SIZE_MAX - offsetof(zylib_private_shared_box_t, data))
+    {
+        return 0;
+    }
+
+    *obj = NULL;
+    r = zylib_private_allocator_malloc(allocator, offsetof(zylib_private_shared_box_t, data) + (size_t)size,
+                                       (void **)obj);
+    if (!r)
+    {
+        return 0;
+    }
+
+    (*obj)->allocator = allocator;
+    (*obj)->owner = NULL;
+    atomic_init(&(*obj)->references, 1);
+    (*obj)->size = size;
+    (*obj)->region = (const unsigned char *)(*obj)->data;
+    memcpy((*obj)->data, ptr, size);
+
+    return 1;
+}
+
+_Bool zylib_private_shared_box_slice(zylib_private_shared_box_t **obj, zylib_private_shared_box_t *box,
+                                     uint64_t offset, uint64_t size)
+{
+    _Bool r;
+
+    if (size <= 0 || offset > box->size || size > box->size - offset)
+    {
+        return 0;
+    }
+
+    *obj = NULL;
+    r = zylib_private_allocator_malloc(box->allocator, offsetof(zylib_private_shared_box_t, data), (void **)obj);
+    if (!r)
+    {
+        return 0;
+    }
+
+    /* A slice of a slice views the owner directly, so that chains of slices stay one level deep */
+    (*obj)->allocator = box->allocator;
+    (*obj)->owner = box->owner != NULL ? box->owner : box;
+    atomic_init(&(*obj)->references, 1);
+    (*obj)->size = size;
+    (*obj)->region = &box->region[offset];
+    zylib_private_shared_box_acquire((*obj)->owner);
+
+    return 1;
+}
+
+void zylib_private_shared_box_acquire(zylib_private_shared_box_t *obj)
+{
+    atomic_fetch_add_explicit(&obj->references, 1, memory_order_relaxed);
+}
+
+void zylib_private_shared_box_destruct(zylib_private_shared_box_t **obj)
+{
+    zylib_private_shared_box_t *owner;
+
+    if (*obj == NULL)
+    {
+        return;
+    }
+
+    if (atomic_fetch_sub_explicit(&(*obj)->references, 1, memory_order_release) != 1)
+    {
+        *obj = NULL;
+        return;
+    }
+
+    /* Every other reference has been released, so their writes happen before the deallocation */
+    atomic_thread_fence(memory_order_acquire);
+    owner = (*obj)->owner;
+    if (owner != NULL)
+    {
+        zylib_private_allocator_free_sized((*obj)->allocator, offsetof(zylib_private_shared_box_t, data),
+                                           (void **)obj);
+        zylib_private_shared_box_destruct(&owner);
+    }
+    else
+    {
+        zylib_private_allocator_free_sized((*obj)->allocator,
+                                           offsetof(zylib_private_shared_box_t, data) + (size_t)(*obj)->size,
+                                           (void **)obj);
+    }
+}
+
+uint64_t zylib_private_shared_box_peek_size(const zylib_private_shared_box_t *obj)
+{
+    return obj->size;
+}
+
+const void *zylib_private_shared_box_peek_data(const zylib_private_shared_box_t *obj)
+{
+    return obj->region;
+}
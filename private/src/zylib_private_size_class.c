@@ -0,0 +1,551 @@
+/*
+ * Copyright 2023 Alexandre Fernandez <alex@fernandezfamily.email>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "zylib_private_size_class.h"
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * Macros
+ */
+
+/* Pages are aligned to their size, so the page of any region is found by masking its address */
+#define ZYLIB_PRIVATE_SIZE_CLASS_PAGE_SIZE ((size_t)64 * 1024)
+#define ZYLIB_PRIVATE_SIZE_CLASS_CHUNK_PAGES (16U)
+#define ZYLIB_PRIVATE_SIZE_CLASS_CHUNK_SIZE (ZYLIB_PRIVATE_SIZE_CLASS_PAGE_SIZE * ZYLIB_PRIVATE_SIZE_CLASS_CHUNK_PAGES)
+
+/* Sizes are 16 through 128 bytes in steps of 16, then four classes per power of two through 8 KiB */
+#define ZYLIB_PRIVATE_SIZE_CLASS_N (32U)
+#define ZYLIB_PRIVATE_SIZE_CLASS_MAX_SIZE ((size_t)8 * 1024)
+
+/*
+ * Type Definitions
+ */
+
+typedef struct zylib_private_size_class_free_s
+{
+    struct zylib_private_size_class_free_s *next;
+} zylib_private_size_class_free_t;
+
+typedef struct zylib_private_size_class_page_s
+{
+    /* The size class */
+    size_t c;
+    /* The region size */
+    size_t size;
+    /* The neighbours in the list of pages of the same class with free regions, or in the list of empty pages */
+    struct zylib_private_size_class_page_s *previous;
+    struct zylib_private_size_class_page_s *next;
+    zylib_private_size_class_free_t *free;
+    /* The number of regions handed out at least once, and currently in use */
+    size_t bump;
+    size_t used;
+    size_t capacity;
+    /* While empty: when the page became empty, and whether its memory was returned to the operating system */
+    uint64_t idle;
+    _Bool discarded;
+    max_align_t data[];
+} zylib_private_size_class_page_t;
+
+/*
+ * A memory region larger than ZYLIB_PRIVATE_SIZE_CLASS_MAX_SIZE, allocated from the parent allocator object behind a
+ * header
+ */
+typedef struct zylib_private_size_class_large_s
+{
+    size_t size;
+    max_align_t data[];
+} zylib_private_size_class_large_t;
+
+typedef struct zylib_private_size_class_s
+{
+    const zylib_private_allocator_t *parent;
+    zylib_private_size_class_page_t *partial[ZYLIB_PRIVATE_SIZE_CLASS_N];
+    zylib_private_size_class_page_t *empty;
+    /* The chunks of pages, sorted by address, which tells regions carved from pages apart from large ones */
+    void **chunks;
+    size_t chunk_n, chunk_capacity;
+    /* The decay period in milliseconds, or 0, and the last time empty pages were looked at */
+    uint64_t decay;
+    uint64_t epoch;
+} zylib_private_size_class_t;
+
+/*
+ * Static Function Declarations
+ */
+
+static void *zylib_private_size_class_malloc(void *context, size_t size);
+
+static void *zylib_private_size_class_realloc(void *context, void *ptr, size_t old_size, size_t size);
+
+static void zylib_private_size_class_free(void *context, void *ptr, size_t size);
+
+static void zylib_private_size_class_destruct(void *context);
+
+/*
+ * Static Variables
+ */
+
+static const zylib_allocator_vtable_t zylib_private_size_class_vtable = {
+    .malloc = zylib_private_size_class_malloc,
+    .calloc = NULL,
+    .realloc = zylib_private_size_class_realloc,
+    .free = zylib_private_size_class_free,
+    .aligned_malloc = NULL,
+    .aligned_free = NULL,
+    .destruct = zylib_private_size_class_destruct};
+
+/*
+ * Static Function Definitions
+ */
+
+static inline size_t zylib_private_size_class_index(size_t size)
+{
+    size_t shift = 7;
+
+    if (size <= 128)
+    {
+        return size <= 16 ? 0 : (size - 1) / 16;
+    }
+
+    while (((size - 1) >> (shift + 1)) != 0)
+    {
+        ++shift;
+    }
+    return 8 + (shift - 7) * 4 + ((size - 1) >> (shift - 2)) - 4;
+}
+
+static inline size_t zylib_private_size_class_size(size_t c)
+{
+    if (c < 8)
+    {
+        return (c + 1) * 16;
+    }
+    return (4 + (c - 8) % 4 + 1) << (7 + (c - 8) / 4 - 2);
+}
+
+ZYLIB_NONNULL
+static inline zylib_private_size_class_page_t *zylib_private_size_class_page(void *ptr)
+{
+    return (zylib_private_size_class_page_t *)((uintptr_t)ptr & ~(uintptr_t)(ZYLIB_PRIVATE_SIZE_CLASS_PAGE_SIZE - 1));
+}
+
+ZYLIB_NONNULL
+static inline void zylib_private_size_class_unlink(zylib_private_size_class_page_t **head,
+                                                   zylib_private_size_class_page_t *page)
+{
+    if (page->previous != NULL)
+    {
+        page->previous->next = page->next;
+    }
+    else
+    {
+        *head = page->next;
+    }
+    if (page->next != NULL)
+    {
+        page->next->previous = page->previous;
+    }
+    page->previous = NULL;
+    page->next = NULL;
+}
+
+ZYLIB_NONNULL
+static inline void zylib_private_size_class_link(zylib_private_size_class_page_t **head,
+                                                 zylib_private_size_class_page_t *page)
+{
+    page->previous = NULL;
+    page->next = *head;
+    if (*head != NULL)
+    {
+        (*head)->previous = page;
+    }
+    *head = page;
+}
+
+/*
+ * Retrieve whether a memory region was carved from a page, as opposed to being a large one
+ */
+ZYLIB_NONNULL
+static _Bool zylib_private_size_class_is_small(const zylib_private_size_class_t *state, const void *ptr)
+{
+    size_t low = 0, high = state->chunk_n;
+
+    /* Find the last chunk that starts at or before the region */
+    while (low < high)
+    {
+        const size_t middle = low + (high - low) / 2;
+        if ((uintptr_t)state->chunks[middle] <= (uintptr_t)ptr)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    return low > 0 && (uintptr_t)ptr - (uintptr_t)state->chunks[low - 1] < ZYLIB_PRIVATE_SIZE_CLASS_CHUNK_SIZE;
+}
+
+/*
+ * Allocate a chunk of pages from the parent allocator object and add them to the empty pages
+ */
+ZYLIB_NONNULL
+static _Bool zylib_private_size_class_grow(zylib_private_size_class_t *state)
+{
+    void *pages = NULL;
+    size_t i;
+    uint64_t now;
+
+    if (state->chunk_n == state->chunk_capacity)
+    {
+        const size_t capacity = state->chunk_capacity != 0 ? state->chunk_capacity * 2 : 16;
+        if (state->chunks == NULL
+                ? !zylib_private_allocator_malloc(state->parent, capacity * sizeof(void *), (void **)&state->chunks)
+                : !zylib_private_allocator_realloc_sized(state->parent, state->chunk_capacity * sizeof(void *),
+                                                         capacity * sizeof(void *), (void **)&state->chunks))
+        {
+            return 0;
+        }
+        state->chunk_capacity = capacity;
+    }
+
+    if (!zylib_private_allocator_aligned_malloc(state->parent, ZYLIB_PRIVATE_SIZE_CLASS_PAGE_SIZE,
+                                                ZYLIB_PRIVATE_SIZE_CLASS_CHUNK_SIZE, &pages))
+    {
+        return 0;
+    }
+
+    for (i = state->chunk_n; i > 0 && (uintptr_t)state->chunks[i - 1] > (uintptr_t)pages; --i)
+    {
+        state->chunks[i] = state->chunks[i - 1];
+    }
+    state->chunks[i] = pages;
+    ++state->chunk_n;
+
+    /* New pages start their idle period now, rather than being discarded by the next decay */
+    now = zylib_private_allocator_clock();
+    for (i = 0; i < ZYLIB_PRIVATE_SIZE_CLASS_CHUNK_PAGES; ++i)
+    {
+        zylib_private_size_class_page_t *const page =
+            (zylib_private_size_class_page_t *)((unsigned char *)pages + i * ZYLIB_PRIVATE_SIZE_CLASS_PAGE_SIZE);
+        page->idle = now;
+        page->discarded = 0;
+        zylib_private_size_class_link(&state->empty, page);
+    }
+    return 1;
+}
+
+/*
+ * Return the memory of an empty page, past its header, to the operating system
+ */
+ZYLIB_NONNULL
+static void zylib_private_size_class_discard(zylib_private_size_class_page_t *page)
+{
+    if (!page->discarded)
+    {
+        zylib_private_allocator_discard(page->data,
+                                        ZYLIB_PRIVATE_SIZE_CLASS_PAGE_SIZE - sizeof(zylib_private_size_class_page_t));
+        page->discarded = 1;
+    }
+}
+
+/*
+ * Discard the pages that have been empty for a whole decay period, at most once per period
+ */
+ZYLIB_NONNULL
+static void zylib_private_size_class_decay(zylib_private_size_class_t *state, uint64_t now)
+{
+    if (now - state->epoch < state->decay)
+    {
+        return;
+    }
+
+    for (zylib_private_size_class_page_t *page = state->empty; page != NULL; page = page->next)
+    {
+        if (!page->discarded && now - page->idle >= state->decay)
+        {
+            zylib_private_size_class_discard(page);
+        }
+    }
+    state->epoch = now;
+}
+
+ZYLIB_NONNULL
+static zylib_private_size_class_page_t *zylib_private_size_class_take(zylib_private_size_class_t *state, size_t c)
+{
+    zylib_private_size_class_page_t *page;
+
+    if (state->empty == NULL && !zylib_private_size_class_grow(state))
+    {
+        return NULL;
+    }
+
+    page = state->empty;
+    zylib_private_size_class_unlink(&state->empty, page);
+    page->c = c;
+    page->size = zylib_private_size_class_size(c);
+    page->free = NULL;
+    page->bump = 0;
+    page->used = 0;
+    page->discarded = 0;
+    page->capacity = (ZYLIB_PRIVATE_SIZE_CLASS_PAGE_SIZE - sizeof(zylib_private_size_class_page_t)) / page->size;
+    zylib_private_size_class_link(&state->partial[c], page);
+    return page;
+}
+
+ZYLIB_NONNULL
+static inline zylib_private_size_class_large_t *zylib_private_size_class_large(void *ptr)
+{
+    return (zylib_private_size_class_large_t *)((unsigned char *)ptr - sizeof(zylib_private_size_class_large_t));
+}
+
+ZYLIB_NONNULL
+static void *zylib_private_size_class_malloc_large(zylib_private_size_class_t *state, size_t size)
+{
+    zylib_private_size_class_large_t *large = NULL;
+
+    if (size > SIZE_MAX - sizeof(zylib_private_size_class_large_t) ||
+        !zylib_private_allocator_malloc(state->parent, sizeof(zylib_private_size_class_large_t) + size,
+                                        (void **)&large))
+    {
+        return NULL;
+    }
+
+    large->size = size;
+    return large->data;
+}
+
+void *zylib_private_size_class_malloc(void *context, size_t size)
+{
+    zylib_private_size_class_t *const state = context;
+    zylib_private_size_class_page_t *page;
+    void *ptr;
+    size_t c;
+
+    if (size > ZYLIB_PRIVATE_SIZE_CLASS_MAX_SIZE)
+    {
+        return zylib_private_size_class_malloc_large(state, size);
+    }
+
+    c = zylib_private_size_class_index(size);
+    page = state->partial[c];
+    if (page == NULL && (page = zylib_private_size_class_take(state, c)) == NULL)
+    {
+        return NULL;
+    }
+
+    if (page->free != NULL)
+    {
+        ptr = page->free;
+        page->free = page->free->next;
+    }
+    else
+    {
+        ptr = (unsigned char *)page->data + page->bump * page->size;
+        ++page->bump;
+    }
+
+    if (++page->used == page->capacity)
+    {
+        zylib_private_size_class_unlink(&state->partial[c], page);
+    }
+    return ptr;
+}
+
+void *zylib_private_size_class_realloc(void *context, void *ptr, size_t old_size, size_t size)
+{
+    const zylib_private_size_class_t *const state = context;
+    zylib_private_size_class_large_t *large;
+    size_t region_size;
+    void *x_ptr;
+
+    (void)(old_size);
+
+    if (zylib_private_size_class_is_small(state, ptr))
+    {
+        const zylib_private_size_class_page_t *const page = zylib_private_size_class_page(ptr);
+        if (size <= ZYLIB_PRIVATE_SIZE_CLASS_MAX_SIZE && zylib_private_size_class_index(size) == page->c)
+        {
+            return ptr;
+        }
+        region_size = page->size;
+    }
+    else
+    {
+        large = zylib_private_size_class_large(ptr);
+        if (size > ZYLIB_PRIVATE_SIZE_CLASS_MAX_SIZE)
+        {
+            if (size > SIZE_MAX - sizeof(zylib_private_size_class_large_t) ||
+                !zylib_private_allocator_realloc_sized(state->parent,
+                                                       sizeof(zylib_private_size_class_large_t) + large->size,
+                                                       sizeof(zylib_private_size_class_large_t) + size,
+                                                       (void **)&large))
+            {
+                return NULL;
+            }
+            large->size = size;
+            return large->data;
+        }
+        region_size = large->size;
+    }
+
+    x_ptr = zylib_private_size_class_malloc(context, size);
+    if (x_ptr != NULL)
+    {
+        memcpy(x_ptr, ptr, region_size < size ? region_size : size);
+        zylib_private_size_class_free(context, ptr, 0);
+    }
+    return x_ptr;
+}
+
+void zylib_private_size_class_free(void *context, void *ptr, size_t size)
+{
+    zylib_private_size_class_t *const state = context;
+    zylib_private_size_class_page_t *page;
+    zylib_private_size_class_free_t *const region = ptr;
+
+    (void)(size);
+
+    if (!zylib_private_size_class_is_small(state, ptr))
+    {
+        zylib_private_size_class_large_t *large = zylib_private_size_class_large(ptr);
+        zylib_private_allocator_free_sized(state->parent, sizeof(zylib_private_size_class_large_t) + large->size,
+                                           (void **)&large);
+        return;
+    }
+
+    page = zylib_private_size_class_page(ptr);
+
+    if (page->used-- == page->capacity)
+    {
+        zylib_private_size_class_link(&state->partial[page->c], page);
+    }
+    region->next = page->free;
+    page->free = region;
+
+    /* An empty page is handed to any class, unless it is the last page of its own */
+    if (page->used == 0 && (page->previous != NULL || page->next != NULL))
+    {
+        zylib_private_size_class_unlink(&state->partial[page->c], page);
+        zylib_private_size_class_link(&state->empty, page);
+        if (state->decay != 0)
+        {
+            page->idle = zylib_private_allocator_clock();
+            zylib_private_size_class_decay(state, page->idle);
+        }
+    }
+}
+
+void zylib_private_size_class_destruct(void *context)
+{
+    zylib_private_size_class_t *state = context;
+
+    for (size_t i = 0; i < state->chunk_n; ++i)
+    {
+        zylib_private_allocator_aligned_free(state->parent, ZYLIB_PRIVATE_SIZE_CLASS_PAGE_SIZE,
+                                             ZYLIB_PRIVATE_SIZE_CLASS_CHUNK_SIZE, &state->chunks[i]);
+    }
+    if (state->chunks != NULL)
+    {
+        zylib_private_allocator_free_sized(state->parent, state->chunk_capacity * sizeof(void *),
+                                           (void **)&state->chunks);
+    }
+    zylib_private_allocator_free_sized(state->parent, sizeof(zylib_private_size_class_t), (void **)&state);
+}
+
+/*
+ * Function Definitions
+ */
+
+_Bool zylib_private_size_class_construct(zylib_private_allocator_t **obj, const zylib_private_allocator_t *parent)
+{
+    _Bool r;
+    zylib_private_size_class_t *state = NULL;
+
+    *obj = NULL;
+    r = zylib_private_allocator_malloc(parent, sizeof(zylib_private_size_class_t), (void **)&state);
+    if (!r)
+    {
+        goto error;
+    }
+
+    memset(state, 0, sizeof(zylib_private_size_class_t));
+    state->parent = parent;
+
+    r = zylib_private_allocator_construct_context(obj, parent, &zylib_private_size_class_vtable, state);
+    if (!r)
+    {
+        goto error;
+    }
+
+    goto done;
+error:
+    if (state != NULL)
+    {
+        zylib_private_allocator_free_sized(parent, sizeof(zylib_private_size_class_t), (void **)&state);
+    }
+done:
+    return r;
+}
+
+_Bool zylib_private_size_class_trim(zylib_private_allocator_t *obj)
+{
+    zylib_private_size_class_t *state;
+
+    if (zylib_private_allocator_peek_vtable(obj) != &zylib_private_size_class_vtable)
+    {
+        return 0;
+    }
+
+    state = zylib_private_allocator_peek_context(obj);
+    for (zylib_private_size_class_page_t *page = state->empty; page != NULL; page = page->next)
+    {
+        zylib_private_size_class_discard(page);
+    }
+    return 1;
+}
+
+_Bool zylib_private_size_class_set_decay(zylib_private_allocator_t *obj, uint64_t decay)
+{
+    zylib_private_size_class_t *state;
+    uint64_t now;
+
+    if (zylib_private_allocator_peek_vtable(obj) != &zylib_private_size_class_vtable)
+    {
+        return 0;
+    }
+
+    state = zylib_private_allocator_peek_context(obj);
+    now = zylib_private_allocator_clock();
+    state->decay = decay;
+    state->epoch = now;
+    for (zylib_private_size_class_page_t *page = state->empty; page != NULL; page = page->next)
+    {
+        page->idle = now;
+    }
+    return 1;
+}
+
+_Bool zylib_private_size_class_peek_decay(const zylib_private_allocator_t *obj, uint64_t *decay)
+{
+    if (zylib_private_allocator_peek_vtable(obj) != &zylib_private_size_class_vtable)
+    {
+        return 0;
+    }
+
+    *decay = ((const zylib_private_size_class_t *)zylib_private_allocator_peek_context(obj))->decay;
+    return 1;
+}
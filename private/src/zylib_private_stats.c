@@ -0,0 +1,386 @@
+/*
+ * Copyright 2023 Alexandre Fernandez <alex@fernandezfamily.email>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "zylib_private_stats.h"
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+#include <threads.h>
+
+/*
+ * Macros
+ */
+
+/* A thread publishes its change in live bytes once it reaches this many bytes, bounding the high-water mark error */
+#define ZYLIB_PRIVATE_STATS_FLUSH_BYTES ((int64_t)64 * 1024)
+
+#define ZYLIB_PRIVATE_STATS_LINE_SIZE (64U)
+
+/*
+ * Type Definitions
+ */
+
+typedef struct zylib_private_stats_block_s
+{
+    /* The requested size */
+    size_t size;
+    max_align_t data[];
+} zylib_private_stats_block_t;
+
+typedef struct zylib_private_stats_local_s zylib_private_stats_local_t;
+
+typedef struct zylib_private_stats_s
+{
+    const zylib_private_allocator_t *parent;
+    mtx_t lock;
+    tss_t key;
+    zylib_private_stats_local_t *locals;
+    /* The sum of every published change in live bytes, and its maximum */
+    _Atomic int64_t live;
+    _Atomic int64_t peak;
+} zylib_private_stats_t;
+
+/*
+ * The counters are only written by the thread that owns them and read by zylib_private_stats_query()
+ */
+struct zylib_private_stats_local_s
+{
+    _Alignas(ZYLIB_PRIVATE_STATS_LINE_SIZE) zylib_private_stats_t *stats;
+    zylib_private_stats_local_t *next;
+    _Bool orphan;
+    /* The change in live bytes not yet published */
+    int64_t pending;
+    _Atomic uint64_t allocation_count;
+    _Atomic uint64_t free_count;
+    _Atomic uint64_t allocated_bytes;
+    _Atomic uint64_t freed_bytes;
+    _Atomic uint64_t histogram[ZYLIB_ALLOCATOR_STATS_HISTOGRAM_N];
+};
+
+/*
+ * Static Function Declarations
+ */
+
+static void *zylib_private_stats_malloc(void *context, size_t size);
+
+static void *zylib_private_stats_realloc(void *context, void *ptr, size_t old_size, size_t size);
+
+static void zylib_private_stats_free(void *context, void *ptr, size_t size);
+
+static void zylib_private_stats_destruct(void *context);
+
+/*
+ * Static Variables
+ */
+
+static const zylib_allocator_vtable_t zylib_private_stats_vtable = {.malloc = zylib_private_stats_malloc,
+                                                                    .calloc = NULL,
+                                                                    .realloc = zylib_private_stats_realloc,
+                                                                    .free = zylib_private_stats_free,
+                                                                    .aligned_malloc = NULL,
+                                                                    .aligned_free = NULL,
+                                                                    .destruct = zylib_private_stats_destruct};
+
+/*
+ * Static Function Definitions
+ */
+
+ZYLIB_NONNULL
+static inline zylib_private_stats_block_t *zylib_private_stats_header(void *ptr)
+{
+    return (zylib_private_stats_block_t *)((unsigned char *)ptr - sizeof(zylib_private_stats_block_t));
+}
+
+/*
+ * Increment a counter that only the calling thread writes, without a locked instruction
+ */
+ZYLIB_NONNULL
+static inline void zylib_private_stats_add(_Atomic uint64_t *counter, uint64_t value)
+{
+    atomic_store_explicit(counter, atomic_load_explicit(counter, memory_order_relaxed) + value, memory_order_relaxed);
+}
+
+static inline size_t zylib_private_stats_bucket(size_t size)
+{
+    size_t i = 0;
+    while (i < ZYLIB_ALLOCATOR_STATS_HISTOGRAM_N - 1 && ((size_t)1 << i) < size)
+    {
+        ++i;
+    }
+    return i;
+}
+
+ZYLIB_NONNULL
+static void zylib_private_stats_publish(zylib_private_stats_local_t *local)
+{
+    zylib_private_stats_t *const stats = local->stats;
+    const int64_t pending = local->pending;
+    const int64_t live = atomic_fetch_add_explicit(&stats->live, pending, memory_order_relaxed) + pending;
+    int64_t peak = atomic_load_explicit(&stats->peak, memory_order_relaxed);
+
+    local->pending = 0;
+    while (live > peak && !atomic_compare_exchange_weak_explicit(&stats->peak, &peak, live, memory_order_relaxed,
+                                                                 memory_order_relaxed))
+    {
+    }
+}
+
+ZYLIB_NONNULL
+static inline void zylib_private_stats_count_malloc(zylib_private_stats_local_t *local, size_t size)
+{
+    zylib_private_stats_add(&local->allocation_count, 1);
+    zylib_private_stats_add(&local->allocated_bytes, size);
+    zylib_private_stats_add(&local->histogram[zylib_private_stats_bucket(size)], 1);
+    local->pending += (int64_t)size;
+    if (local->pending >= ZYLIB_PRIVATE_STATS_FLUSH_BYTES)
+    {
+        zylib_private_stats_publish(local);
+    }
+}
+
+ZYLIB_NONNULL
+static inline void zylib_private_stats_count_free(zylib_private_stats_local_t *local, size_t size)
+{
+    zylib_private_stats_add(&local->free_count, 1);
+    zylib_private_stats_add(&local->freed_bytes, size);
+    local->pending -= (int64_t)size;
+    if (local->pending <= -ZYLIB_PRIVATE_STATS_FLUSH_BYTES)
+    {
+        zylib_private_stats_publish(local);
+    }
+}
+
+/*
+ * Invoked when a thread that used the allocator exits; its counters are kept and the next thread adopts them
+ */
+static void zylib_private_stats_detach(void *value)
+{
+    zylib_private_stats_local_t *const local = value;
+
+    mtx_lock(&local->stats->lock);
+    zylib_private_stats_publish(local);
+    local->orphan = 1;
+    mtx_unlock(&local->stats->lock);
+}
+
+ZYLIB_NONNULL
+static zylib_private_stats_local_t *zylib_private_stats_attach(zylib_private_stats_t *stats)
+{
+    zylib_private_stats_local_t *local;
+
+    mtx_lock(&stats->lock);
+    for (local = stats->locals; local != NULL && !local->orphan; local = local->next)
+    {
+    }
+
+    if (local == NULL)
+    {
+        if (!zylib_private_allocator_aligned_malloc(stats->parent, _Alignof(zylib_private_stats_local_t),
+                                                    sizeof(zylib_private_stats_local_t), (void **)&local))
+        {
+            local = NULL;
+            goto done;
+        }
+        memset(local, 0, sizeof(zylib_private_stats_local_t));
+        atomic_init(&local->allocation_count, 0);
+        atomic_init(&local->free_count, 0);
+        atomic_init(&local->allocated_bytes, 0);
+        atomic_init(&local->freed_bytes, 0);
+        for (size_t i = 0; i < ZYLIB_ALLOCATOR_STATS_HISTOGRAM_N; ++i)
+        {
+            atomic_init(&local->histogram[i], 0);
+        }
+        local->stats = stats;
+        local->next = stats->locals;
+        stats->locals = local;
+    }
+
+    local->orphan = 0;
+    if (tss_set(stats->key, local) != thrd_success)
+    {
+        local->orphan = 1;
+        local = NULL;
+    }
+
+done:
+    mtx_unlock(&stats->lock);
+    return local;
+}
+
+ZYLIB_NONNULL
+static inline zylib_private_stats_local_t *zylib_private_stats_local(zylib_private_stats_t *stats)
+{
+    zylib_private_stats_local_t *const local = tss_get(stats->key);
+    return local != NULL ? local : zylib_private_stats_attach(stats);
+}
+
+void *zylib_private_stats_malloc(void *context, size_t size)
+{
+    zylib_private_stats_t *const stats = context;
+    zylib_private_stats_local_t *const local = zylib_private_stats_local(stats);
+    zylib_private_stats_block_t *block = NULL;
+
+    if (local == NULL || size > SIZE_MAX - sizeof(zylib_private_stats_block_t) ||
+        !zylib_private_allocator_malloc(stats->parent, sizeof(zylib_private_stats_block_t) + size, (void **)&block))
+    {
+        return NULL;
+    }
+
+    block->size = size;
+    zylib_private_stats_count_malloc(local, size);
+    return block->data;
+}
+
+void *zylib_private_stats_realloc(void *context, void *ptr, size_t old_size, size_t size)
+{
+    zylib_private_stats_t *const stats = context;
+    zylib_private_stats_local_t *const local = zylib_private_stats_local(stats);
+    zylib_private_stats_block_t *block = zylib_private_stats_header(ptr);
+    const size_t x_size = block->size;
+
+    (void)(old_size);
+
+    if (local == NULL || size > SIZE_MAX - sizeof(zylib_private_stats_block_t) ||
+        !zylib_private_allocator_realloc_sized(stats->parent, sizeof(zylib_private_stats_block_t) + x_size,
+                                               sizeof(zylib_private_stats_block_t) + size, (void **)&block))
+    {
+        return NULL;
+    }
+
+    block->size = size;
+    zylib_private_stats_count_free(local, x_size);
+    zylib_private_stats_count_malloc(local, size);
+    return block->data;
+}
+
+void zylib_private_stats_free(void *context, void *ptr, size_t size)
+{
+    zylib_private_stats_t *const stats = context;
+    zylib_private_stats_local_t *const local = zylib_private_stats_local(stats);
+    zylib_private_stats_block_t *block = zylib_private_stats_header(ptr);
+
+    (void)(size);
+
+    if (local != NULL)
+    {
+        zylib_private_stats_count_free(local, block->size);
+    }
+    zylib_private_allocator_free_sized(stats->parent, sizeof(zylib_private_stats_block_t) + block->size,
+                                       (void **)&block);
+}
+
+void zylib_private_stats_destruct(void *context)
+{
+    zylib_private_stats_t *stats = context;
+    zylib_private_stats_local_t *local = stats->locals;
+
+    tss_delete(stats->key);
+    while (local != NULL)
+    {
+        zylib_private_stats_local_t *const next = local->next;
+        zylib_private_allocator_aligned_free(stats->parent, _Alignof(zylib_private_stats_local_t),
+                                             sizeof(zylib_private_stats_local_t), (void **)&local);
+        local = next;
+    }
+    mtx_destroy(&stats->lock);
+    zylib_private_allocator_free_sized(stats->parent, sizeof(zylib_private_stats_t), (void **)&stats);
+}
+
+/*
+ * Function Definitions
+ */
+
+_Bool zylib_private_stats_construct(zylib_private_allocator_t **obj, const zylib_private_allocator_t *parent)
+{
+    _Bool r;
+    zylib_private_stats_t *stats = NULL;
+
+    *obj = NULL;
+    r = zylib_private_allocator_malloc(parent, sizeof(zylib_private_stats_t), (void **)&stats);
+    if (!r)
+    {
+        goto error;
+    }
+
+    stats->parent = parent;
+    stats->locals = NULL;
+    atomic_init(&stats->live, 0);
+    atomic_init(&stats->peak, 0);
+
+    if (mtx_init(&stats->lock, mtx_plain) != thrd_success)
+    {
+        r = 0;
+        goto error;
+    }
+
+    if (tss_create(&stats->key, zylib_private_stats_detach) != thrd_success)
+    {
+        mtx_destroy(&stats->lock);
+        r = 0;
+        goto error;
+    }
+
+    r = zylib_private_allocator_construct_context(obj, parent, &zylib_private_stats_vtable, stats);
+    if (!r)
+    {
+        tss_delete(stats->key);
+        mtx_destroy(&stats->lock);
+        goto error;
+    }
+
+    goto done;
+error:
+    if (stats != NULL)
+    {
+        zylib_private_allocator_free_sized(parent, sizeof(zylib_private_stats_t), (void **)&stats);
+    }
+done:
+    return r;
+}
+
+_Bool zylib_private_stats_query(const zylib_private_allocator_t *obj, zylib_allocator_stats_t *stats)
+{
+    zylib_private_stats_t *state;
+    uint64_t allocated_bytes = 0;
+    uint64_t freed_bytes = 0;
+    int64_t peak;
+
+    if (zylib_private_allocator_peek_vtable(obj) != &zylib_private_stats_vtable)
+    {
+        return 0;
+    }
+
+    state = zylib_private_allocator_peek_context(obj);
+    memset(stats, 0, sizeof(zylib_allocator_stats_t));
+
+    mtx_lock(&state->lock);
+    for (const zylib_private_stats_local_t *local = state->locals; local != NULL; local = local->next)
+    {
+        stats->allocation_count += atomic_load_explicit(&local->allocation_count, memory_order_relaxed);
+        stats->free_count += atomic_load_explicit(&local->free_count, memory_order_relaxed);
+        allocated_bytes += atomic_load_explicit(&local->allocated_bytes, memory_order_relaxed);
+        freed_bytes += atomic_load_explicit(&local->freed_bytes, memory_order_relaxed);
+        for (size_t i = 0; i < ZYLIB_ALLOCATOR_STATS_HISTOGRAM_N; ++i)
+        {
+            stats->histogram[i] += atomic_load_explicit(&local->histogram[i], memory_order_relaxed);
+        }
+    }
+    mtx_unlock(&state->lock);
+
+    stats->live_bytes = allocated_bytes >= freed_bytes ? allocated_bytes - freed_bytes : 0;
+    peak = atomic_load_explicit(&state->peak, memory_order_relaxed);
+    stats->peak_bytes = peak > 0 && (uint64_t)peak > stats->live_bytes ? (uint64_t)peak : stats->live_bytes;
+    return 1;
+}
@@ -0,0 +1,317 @@
+/*
+ * Copyright 2023 Alexandre Fernandez <alex@fernandezfamily.email>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "zylib_private_thread_cache.h"
+#include "zylib_private_bins.h"
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+#include <threads.h>
+
+/*
+ * Macros
+ */
+
+/* The number of blocks of a size class a thread keeps before flushing a batch to the parent allocator */
+#define ZYLIB_PRIVATE_THREAD_CACHE_LIMIT (2U * ZYLIB_PRIVATE_BINS_BATCH)
+
+#define ZYLIB_PRIVATE_THREAD_CACHE_LINE_SIZE (64U)
+
+/*
+ * Type Definitions
+ */
+
+typedef struct zylib_private_thread_cache_local_s zylib_private_thread_cache_local_t;
+
+typedef struct zylib_private_thread_cache_s
+{
+    const zylib_private_allocator_t *parent;
+    mtx_t lock;
+    tss_t key;
+    zylib_private_thread_cache_local_t *locals;
+} zylib_private_thread_cache_t;
+
+struct zylib_private_thread_cache_local_s
+{
+    /* Written by other threads; kept apart from the bins */
+    _Alignas(ZYLIB_PRIVATE_THREAD_CACHE_LINE_SIZE) _Atomic(zylib_private_bins_block_t *) remote;
+    _Alignas(ZYLIB_PRIVATE_THREAD_CACHE_LINE_SIZE) zylib_private_thread_cache_t *cache;
+    zylib_private_thread_cache_local_t *next;
+    _Bool orphan;
+    zylib_private_bins_t bins;
+};
+
+/*
+ * Static Function Declarations
+ */
+
+static void *zylib_private_thread_cache_malloc(void *context, size_t size);
+
+static void *zylib_private_thread_cache_realloc(void *context, void *ptr, size_t old_size, size_t size);
+
+static void zylib_private_thread_cache_free(void *context, void *ptr, size_t size);
+
+static void zylib_private_thread_cache_destruct(void *context);
+
+/*
+ * Static Variables
+ */
+
+static const zylib_allocator_vtable_t zylib_private_thread_cache_vtable = {
+    .malloc = zylib_private_thread_cache_malloc,
+    .calloc = NULL,
+    .realloc = zylib_private_thread_cache_realloc,
+    .free = zylib_private_thread_cache_free,
+    .aligned_malloc = NULL,
+    .aligned_free = NULL,
+    .destruct = zylib_private_thread_cache_destruct};
+
+/*
+ * Static Function Definitions
+ */
+
+/*
+ * Move the blocks freed by other threads into the bins
+ */
+ZYLIB_NONNULL
+static void zylib_private_thread_cache_reclaim(zylib_private_thread_cache_local_t *local)
+{
+    zylib_private_bins_block_t *block = atomic_exchange_explicit(&local->remote, NULL, memory_order_acquire);
+
+    while (block != NULL)
+    {
+        zylib_private_bins_block_t *const next = block->next;
+        const size_t c = zylib_private_bins_class(block->size);
+        block->next = local->bins.heads[c];
+        local->bins.heads[c] = block;
+        ++local->bins.count[c];
+        block = next;
+    }
+}
+
+/*
+ * Return every block held by a thread to the parent allocator; the caller holds the lock
+ */
+ZYLIB_NONNULL
+static void zylib_private_thread_cache_empty(zylib_private_thread_cache_local_t *local)
+{
+    zylib_private_thread_cache_reclaim(local);
+    zylib_private_bins_empty(&local->bins, local->cache->parent);
+}
+
+/*
+ * Invoked when a thread that used the cache exits; the bins are handed back and the local cache is left for the next
+ * thread to adopt
+ */
+static void zylib_private_thread_cache_detach(void *value)
+{
+    zylib_private_thread_cache_local_t *const local = value;
+
+    mtx_lock(&local->cache->lock);
+    zylib_private_thread_cache_empty(local);
+    local->orphan = 1;
+    mtx_unlock(&local->cache->lock);
+}
+
+ZYLIB_NONNULL
+static zylib_private_thread_cache_local_t *zylib_private_thread_cache_attach(zylib_private_thread_cache_t *cache)
+{
+    zylib_private_thread_cache_local_t *local;
+
+    mtx_lock(&cache->lock);
+    for (local = cache->locals; local != NULL && !local->orphan; local = local->next)
+    {
+    }
+
+    if (local == NULL)
+    {
+        if (!zylib_private_allocator_aligned_malloc(cache->parent, _Alignof(zylib_private_thread_cache_local_t),
+                                                    sizeof(zylib_private_thread_cache_local_t), (void **)&local))
+        {
+            local = NULL;
+            goto done;
+        }
+        memset(local, 0, sizeof(zylib_private_thread_cache_local_t));
+        atomic_init(&local->remote, NULL);
+        local->cache = cache;
+        local->next = cache->locals;
+        cache->locals = local;
+    }
+
+    local->orphan = 0;
+    if (tss_set(cache->key, local) != thrd_success)
+    {
+        local->orphan = 1;
+        local = NULL;
+    }
+
+done:
+    mtx_unlock(&cache->lock);
+    return local;
+}
+
+void *zylib_private_thread_cache_malloc(void *context, size_t size)
+{
+    zylib_private_thread_cache_t *const cache = context;
+    zylib_private_thread_cache_local_t *local;
+    zylib_private_bins_block_t *block;
+    size_t c;
+
+    if (size > ZYLIB_PRIVATE_BINS_MAX_SIZE)
+    {
+        return zylib_private_bins_malloc_large(cache->parent, &cache->lock, size);
+    }
+
+    local = tss_get(cache->key);
+    if (local == NULL && (local = zylib_private_thread_cache_attach(cache)) == NULL)
+    {
+        return NULL;
+    }
+
+    if (atomic_load_explicit(&local->remote, memory_order_relaxed) != NULL)
+    {
+        zylib_private_thread_cache_reclaim(local);
+    }
+
+    c = zylib_private_bins_class(size);
+    if (local->bins.heads[c] == NULL && !zylib_private_bins_refill(&local->bins, cache->parent, &cache->lock, c))
+    {
+        return NULL;
+    }
+
+    block = local->bins.heads[c];
+    local->bins.heads[c] = block->next;
+    --local->bins.count[c];
+    block->owner = local;
+    return block->data;
+}
+
+void *zylib_private_thread_cache_realloc(void *context, void *ptr, size_t old_size, size_t size)
+{
+    zylib_private_thread_cache_t *const cache = context;
+
+    (void)(old_size);
+
+    return zylib_private_bins_realloc(&zylib_private_thread_cache_vtable, context, cache->parent, &cache->lock, ptr,
+                                      size);
+}
+
+void zylib_private_thread_cache_free(void *context, void *ptr, size_t size)
+{
+    zylib_private_thread_cache_t *const cache = context;
+    zylib_private_bins_block_t *const block = zylib_private_bins_header(ptr);
+    zylib_private_thread_cache_local_t *owner;
+    zylib_private_thread_cache_local_t *local;
+    size_t c;
+
+    (void)(size);
+
+    if (block->size > ZYLIB_PRIVATE_BINS_MAX_SIZE)
+    {
+        mtx_lock(&cache->lock);
+        zylib_private_bins_release(cache->parent, block);
+        mtx_unlock(&cache->lock);
+        return;
+    }
+
+    owner = block->owner;
+    local = tss_get(cache->key);
+    if (owner != local)
+    {
+        zylib_private_bins_block_t *head = atomic_load_explicit(&owner->remote, memory_order_relaxed);
+        do
+        {
+            block->next = head;
+        } while (!atomic_compare_exchange_weak_explicit(&owner->remote, &head, block, memory_order_release,
+                                                        memory_order_relaxed));
+        return;
+    }
+
+    c = zylib_private_bins_class(block->size);
+    block->next = local->bins.heads[c];
+    local->bins.heads[c] = block;
+    if (++local->bins.count[c] > ZYLIB_PRIVATE_THREAD_CACHE_LIMIT)
+    {
+        zylib_private_bins_flush(&local->bins, cache->parent, &cache->lock, c, ZYLIB_PRIVATE_BINS_BATCH);
+    }
+}
+
+void zylib_private_thread_cache_destruct(void *context)
+{
+    zylib_private_thread_cache_t *cache = context;
+    zylib_private_thread_cache_local_t *local = cache->locals;
+
+    tss_delete(cache->key);
+    while (local != NULL)
+    {
+        zylib_private_thread_cache_local_t *const next = local->next;
+        zylib_private_thread_cache_empty(local);
+        zylib_private_allocator_aligned_free(cache->parent, _Alignof(zylib_private_thread_cache_local_t),
+                                             sizeof(zylib_private_thread_cache_local_t), (void **)&local);
+        local = next;
+    }
+    mtx_destroy(&cache->lock);
+    zylib_private_allocator_free_sized(cache->parent, sizeof(zylib_private_thread_cache_t), (void **)&cache);
+}
+
+/*
+ * Function Definitions
+ */
+
+_Bool zylib_private_thread_cache_construct(zylib_private_allocator_t **obj, const zylib_private_allocator_t *parent)
+{
+    _Bool r;
+    zylib_private_thread_cache_t *cache = NULL;
+
+    *obj = NULL;
+    r = zylib_private_allocator_malloc(parent, sizeof(zylib_private_thread_cache_t), (void **)&cache);
+    if (!r)
+    {
+        goto error;
+    }
+
+    cache->parent = parent;
+    cache->locals = NULL;
+
+    if (mtx_init(&cache->lock, mtx_plain) != thrd_success)
+    {
+        r = 0;
+        goto error;
+    }
+
+    if (tss_create(&cache->key, zylib_private_thread_cache_detach) != thrd_success)
+    {
+        mtx_destroy(&cache->lock);
+        r = 0;
+        goto error;
+    }
+
+    r = zylib_private_allocator_construct_context(obj, parent, &zylib_private_thread_cache_vtable, cache);
+    if (!r)
+    {
+        tss_delete(cache->key);
+        mtx_destroy(&cache->lock);
+        goto error;
+    }
+
+    goto done;
+error:
+    if (cache != NULL)
+    {
+        zylib_private_allocator_free_sized(parent, sizeof(zylib_private_thread_cache_t), (void **)&cache);
+    }
+done:
+    return r;
+}
@@ -17,6 +17,8 @@
 #include "zylib_allocator_def.h"
 #include "zylib_def.h"
 #include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
 
 /**
  * Allocator Data Structure
@@ -37,6 +39,19 @@ ZYLIB_NONNULL
 _Bool zylib_allocator_construct(zylib_allocator_t **obj, zylib_allocator_malloc_t malloc,
                                 zylib_allocator_realloc_t realloc, zylib_allocator_free_t free);
 
+/**
+ * Construct an allocator object that dispatches to a function table operating on a context.
+ * The object itself is allocated from the function table.
+ * @param obj The object to construct
+ * @param vtable The function table; must outlive the object
+ * @param context The context passed to every function in vtable
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL_N(1)
+ZYLIB_NONNULL_N(2)
+_Bool zylib_allocator_construct_context(zylib_allocator_t **obj, const zylib_allocator_vtable_t *vtable,
+                                        void *context);
+
 /**
  * Deconstruct an allocator object
  * @param obj The object to deconstruct
@@ -54,6 +69,16 @@ void zylib_allocator_destruct(zylib_allocator_t **obj);
 ZYLIB_NONNULL
 _Bool zylib_allocator_malloc(const zylib_allocator_t *obj, size_t size, void **ptr);
 
+/**
+ * Allocate a zero-filled memory region
+ * @param obj The allocator object
+ * @param size The size of the region to allocate
+ * @param ptr The pointer to the address of the memory region
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_allocator_calloc(const zylib_allocator_t *obj, size_t size, void **ptr);
+
 /**
  * Resize an allocated memory region
  * @param obj The allocator object
@@ -64,6 +89,17 @@ _Bool zylib_allocator_malloc(const zylib_allocator_t *obj, size_t size, void **p
 ZYLIB_NONNULL
 _Bool zylib_allocator_realloc(const zylib_allocator_t *obj, size_t size, void **ptr);
 
+/**
+ * Resize an allocated memory region whose size is known
+ * @param obj The allocator object
+ * @param old_size The current size of the memory region
+ * @param size The new size of the memory region
+ * @param ptr The pointer to the address of the memory region
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_allocator_realloc_sized(const zylib_allocator_t *obj, size_t old_size, size_t size, void **ptr);
+
 /**
  * Deallocate a memory region
  * @param obj The allocator object
@@ -72,4 +108,205 @@ _Bool zylib_allocator_realloc(const zylib_allocator_t *obj, size_t size, void **
 ZYLIB_NONNULL
 void zylib_allocator_free(const zylib_allocator_t *obj, void **ptr);
 
+/**
+ * Deallocate a memory region whose size is known
+ * @param obj The allocator object
+ * @param size The size of the memory region
+ * @param ptr The pointer to the memory region
+ */
+ZYLIB_NONNULL
+void zylib_allocator_free_sized(const zylib_allocator_t *obj, size_t size, void **ptr);
+
+/**
+ * Allocate a memory region whose address is a multiple of alignment.
+ * Allocators without a native aligned_malloc over-allocate and align within the region.
+ * @param obj The allocator object
+ * @param alignment The alignment of the region; a power of two, such as a cache line or page size
+ * @param size The size of the region to allocate
+ * @param ptr The pointer to the address of the memory region
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_allocator_aligned_malloc(const zylib_allocator_t *obj, size_t alignment, size_t size, void **ptr);
+
+/**
+ * Deallocate a memory region allocated by zylib_allocator_aligned_malloc()
+ * @param obj The allocator object
+ * @param alignment The alignment of the memory region
+ * @param size The size of the memory region, or zero if unknown
+ * @param ptr The pointer to the memory region
+ */
+ZYLIB_NONNULL
+void zylib_allocator_aligned_free(const zylib_allocator_t *obj, size_t alignment, size_t size, void **ptr);
+
+/**
+ * Construct an arena allocator object.
+ * Memory is handed out from blocks of block_size bytes by advancing a cursor. Deallocation is a no-op, except for the
+ * most recent allocation; every allocation is reclaimed at once by zylib_allocator_arena_reset().
+ * An arena allocator object is not thread-safe.
+ * @param obj The object to construct
+ * @param block_size The size of each block; larger requests receive a dedicated block
+ * @param parent The allocator object from which the object and its blocks are allocated
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_allocator_construct_arena(zylib_allocator_t **obj, size_t block_size, const zylib_allocator_t *parent);
+
+/**
+ * Reclaim every memory region allocated from an arena allocator object in constant time.
+ * Blocks are retained and reused by subsequent allocations.
+ * @param obj The arena allocator object
+ * @return True if and only if obj is an arena allocator object
+ */
+ZYLIB_NONNULL
+_Bool zylib_allocator_arena_reset(zylib_allocator_t *obj);
+
+/**
+ * Return the memory that an arena or size-class allocator object holds but does not use.
+ * An arena allocator object returns the blocks past its current one to its parent allocator object; both return the
+ * unused pages they keep for reuse to the operating system.
+ * @param obj The arena or size-class allocator object
+ * @return True if and only if obj is an arena or size-class allocator object
+ */
+ZYLIB_NONNULL
+_Bool zylib_allocator_trim(zylib_allocator_t *obj);
+
+/**
+ * Set the decay period of an arena or size-class allocator object.
+ * Memory that stays unused for a whole period is returned as by zylib_allocator_trim(): an arena allocator object
+ * checks on reset for blocks it has not reached since the period started, and a size-class allocator object checks,
+ * at most once per period, for pages that have been empty for that long whenever a page becomes empty. Pool objects
+ * and pooled dequeue objects built on obj follow the same period for their slabs, unless set with
+ * zylib_pool_set_decay().
+ * @param obj The arena or size-class allocator object
+ * @param milliseconds The decay period, or 0 to retain memory until zylib_allocator_trim() (the default)
+ * @return True if and only if obj is an arena or size-class allocator object
+ */
+ZYLIB_NONNULL
+_Bool zylib_allocator_set_decay(zylib_allocator_t *obj, uint64_t milliseconds);
+
+/**
+ * Construct a thread-caching allocator object.
+ * Each thread keeps per-size-class free lists in front of the parent allocator object; they are refilled and flushed
+ * in batches, and memory regions freed by another thread are handed back to their owner through a lock-free list.
+ * Calls into the parent allocator object are serialized, so it need not be thread-safe.
+ * @param obj The object to construct
+ * @param parent The allocator object from which the object and every memory region are allocated
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_allocator_construct_thread_cache(zylib_allocator_t **obj, const zylib_allocator_t *parent);
+
+/**
+ * Construct a per-CPU allocator object.
+ * Small memory regions are served from per-size-class free lists sharded by the CPU that the calling thread runs on,
+ * each shard behind its own lock, so cached memory grows with the number of CPUs rather than threads. Shards are
+ * refilled from, and flushed to, the parent allocator object in batches. Calls into the parent allocator object are
+ * serialized, so it need not be thread-safe.
+ * @param obj The object to construct
+ * @param parent The allocator object from which the object and every memory region are allocated
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_allocator_construct_per_cpu(zylib_allocator_t **obj, const zylib_allocator_t *parent);
+
+/**
+ * Construct a size-class allocator object.
+ * Memory regions of up to 8 KiB are rounded up to one of 32 size classes and carved from 64 KiB pages dedicated to a
+ * single class; the page of a region is found from its address, so regions carry no header. Larger memory regions
+ * are allocated from the parent allocator object behind a size header. Pages are allocated from the parent allocator
+ * object in chunks of 16 and only returned to it on destruction. A size-class allocator object is not thread-safe.
+ * @param obj The object to construct
+ * @param parent The allocator object from which the object and every page are allocated
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_allocator_construct_size_class(zylib_allocator_t **obj, const zylib_allocator_t *parent);
+
+/**
+ * Construct a memory mapping allocator object.
+ * Memory regions of at least threshold bytes are mapped directly from the operating system, optionally backed by huge
+ * pages and prefaulted, and optionally grown by remapping rather than copying; smaller ones are allocated from the
+ * parent allocator object. Where memory mapping is unavailable or fails, every memory region is allocated from the
+ * parent allocator object.
+ * The object is exactly as thread-safe as the parent allocator object.
+ * @param obj The object to construct
+ * @param threshold The size from which memory regions are mapped
+ * @param flags A combination of zylib_allocator_mmap_flags_t
+ * @param parent The allocator object from which the object and every smaller memory region are allocated
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_allocator_construct_mmap(zylib_allocator_t **obj, size_t threshold, unsigned flags,
+                                     const zylib_allocator_t *parent);
+
+/**
+ * Construct a statistics allocator object.
+ * Every request is forwarded to the parent allocator object and accounted in per-thread counters that are only
+ * aggregated by zylib_allocator_stats(). The object is exactly as thread-safe as the parent allocator object.
+ * @param obj The object to construct
+ * @param parent The allocator object from which the object and every memory region are allocated
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_allocator_construct_stats(zylib_allocator_t **obj, const zylib_allocator_t *parent);
+
+/**
+ * Take a snapshot of the statistics of a statistics allocator object.
+ * The high-water mark may lag the true one by up to 64 KiB per thread.
+ * @param obj The statistics allocator object
+ * @param stats The snapshot
+ * @return True if and only if obj is a statistics allocator object
+ */
+ZYLIB_NONNULL
+_Bool zylib_allocator_stats(const zylib_allocator_t *obj, zylib_allocator_stats_t *stats);
+
+/**
+ * Construct a budget allocator object.
+ * Every request is forwarded to the parent allocator object, provided the bytes allocated through the object stay
+ * within hard_limit; past it, allocations fail without reaching the parent allocator object. Threads reserve budget
+ * in batches of up to 64 KiB or 1/64th of hard_limit; once it runs out, the reservations of every thread are taken
+ * back before an allocation fails. Whenever a thread tops up its reservation, it compares the bytes allocated to
+ * soft_limit, and invokes pressure if they reached it since they were last seen below it, so that the owner can shed
+ * load; pressure may thus be invoked up to a batch per thread late. The object is exactly as thread-safe as the parent
+ * allocator object.
+ * @param obj The object to construct
+ * @param soft_limit The bytes allocated at which pressure is invoked
+ * @param hard_limit The bytes allocated beyond which allocations fail
+ * @param pressure The function invoked when the bytes allocated reach soft_limit, or NULL
+ * @param context The argument passed to pressure
+ * @param parent The allocator object from which the object and every memory region are allocated
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL_N(1)
+ZYLIB_NONNULL_N(6)
+_Bool zylib_allocator_construct_budget(zylib_allocator_t **obj, size_t soft_limit, size_t hard_limit,
+                                       zylib_allocator_pressure_t pressure, void *context,
+                                       const zylib_allocator_t *parent);
+
+/**
+ * Construct a sampling heap profiler allocator object.
+ * Every request is forwarded to the parent allocator object. On average one allocation per sample_rate bytes records
+ * the call stack that made it, until the memory region is freed. Each thread counts down the bytes to its next sample
+ * across every profiler allocator object it allocates from, so profilers sharing a thread should share a sample rate.
+ * The object is exactly as thread-safe as the parent allocator object.
+ * @param obj The object to construct
+ * @param sample_rate The mean number of bytes allocated between two samples, or 0 to sample every allocation
+ * @param parent The allocator object from which the object and every memory region are allocated
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_allocator_construct_profiler(zylib_allocator_t **obj, size_t sample_rate, const zylib_allocator_t *parent);
+
+/**
+ * Write the live samples of a sampling heap profiler allocator object in folded stack format.
+ * Each line lists the return addresses of a call stack, outermost first and separated by semicolons, followed by the
+ * estimated number of live bytes allocated from it.
+ * @param obj The sampling heap profiler allocator object
+ * @param stream The stream
+ * @return True if and only if obj is a sampling heap profiler allocator object and the stream was written
+ */
+ZYLIB_NONNULL
+_Bool zylib_allocator_profiler_dump(const zylib_allocator_t *obj, FILE *stream);
+
 ZYLIB_END_DECLS
@@ -15,6 +15,7 @@
  */
 #pragma once
 #include <stddef.h>
+#include <stdint.h>
 
 /**
  * Malloc Function Pointer Data Type
@@ -30,3 +31,129 @@ typedef void *(*zylib_allocator_realloc_t)(void *ptr, size_t size);
  * Free Function Pointer Data Type
  */
 typedef void (*zylib_allocator_free_t)(void *ptr);
+
+/**
+ * Context Malloc Function Pointer Data Type
+ */
+typedef void *(*zylib_allocator_context_malloc_t)(void *context, size_t size);
+
+/**
+ * Context Calloc Function Pointer Data Type.
+ * Returns a zero-filled memory region.
+ */
+typedef void *(*zylib_allocator_context_calloc_t)(void *context, size_t size);
+
+/**
+ * Context Realloc Function Pointer Data Type.
+ * The old size is zero if and only if it is unknown to the caller.
+ */
+typedef void *(*zylib_allocator_context_realloc_t)(void *context, void *ptr, size_t old_size, size_t size);
+
+/**
+ * Context Free Function Pointer Data Type.
+ * The size is zero if and only if it is unknown to the caller.
+ */
+typedef void (*zylib_allocator_context_free_t)(void *context, void *ptr, size_t size);
+
+/**
+ * Context Aligned Malloc Function Pointer Data Type.
+ * The alignment is a power of two.
+ */
+typedef void *(*zylib_allocator_context_aligned_malloc_t)(void *context, size_t alignment, size_t size);
+
+/**
+ * Context Aligned Free Function Pointer Data Type.
+ * The size is zero if and only if it is unknown to the caller.
+ */
+typedef void (*zylib_allocator_context_aligned_free_t)(void *context, void *ptr, size_t alignment, size_t size);
+
+/**
+ * Context Destruct Function Pointer Data Type
+ */
+typedef void (*zylib_allocator_context_destruct_t)(void *context);
+
+/**
+ * Allocator Function Table Data Structure
+ */
+typedef struct zylib_allocator_vtable_s
+{
+    zylib_allocator_context_malloc_t malloc;
+    /**
+     * May be null; malloc followed by memset is used instead
+     */
+    zylib_allocator_context_calloc_t calloc;
+    zylib_allocator_context_realloc_t realloc;
+    zylib_allocator_context_free_t free;
+    /**
+     * May be null, in which case aligned_free must be null as well; malloc is over-allocated and aligned instead
+     */
+    zylib_allocator_context_aligned_malloc_t aligned_malloc;
+    zylib_allocator_context_aligned_free_t aligned_free;
+    /**
+     * Invoked once the allocator object has been deallocated; may be null
+     */
+    zylib_allocator_context_destruct_t destruct;
+} zylib_allocator_vtable_t;
+
+/**
+ * The Number of Allocation Size Histogram Buckets
+ */
+#define ZYLIB_ALLOCATOR_STATS_HISTOGRAM_N (64U)
+
+/**
+ * Allocation Statistics Data Structure
+ */
+typedef struct zylib_allocator_stats_s
+{
+    /**
+     * The number of allocations, including the new region of every reallocation
+     */
+    uint64_t allocation_count;
+    /**
+     * The number of deallocations, including the old region of every reallocation
+     */
+    uint64_t free_count;
+    /**
+     * The number of bytes currently allocated
+     */
+    uint64_t live_bytes;
+    /**
+     * The largest number of bytes allocated at once
+     */
+    uint64_t peak_bytes;
+    /**
+     * histogram[i] is the number of allocations whose size is in (2^(i-1), 2^i]
+     */
+    uint64_t histogram[ZYLIB_ALLOCATOR_STATS_HISTOGRAM_N];
+} zylib_allocator_stats_t;
+
+/**
+ * Memory Mapping Allocator Flags
+ */
+typedef enum zylib_allocator_mmap_flags_e
+{
+    /**
+     * Back mappings with explicit huge pages of the default size, read from /proc/meminfo when the object is
+     * constructed, falling back to regular pages when none are available
+     */
+    ZYLIB_ALLOCATOR_MMAP_HUGETLB = 1 << 0,
+    /**
+     * Advise the kernel to back mappings with transparent huge pages
+     */
+    ZYLIB_ALLOCATOR_MMAP_TRANSPARENT_HUGEPAGE = 1 << 1,
+    /**
+     * Prefault mappings when they are created
+     */
+    ZYLIB_ALLOCATOR_MMAP_POPULATE = 1 << 2,
+    /**
+     * Grow mappings with mremap(), moving page table entries instead of copying memory
+     */
+    ZYLIB_ALLOCATOR_MMAP_REMAP = 1 << 3
+} zylib_allocator_mmap_flags_t;
+
+/**
+ * Memory Pressure Function Pointer Data Type.
+ * Invoked by the thread that found the bytes allocated through a budget allocator at its soft limit, which it passes as
+ * usage.
+ */
+typedef void (*zylib_allocator_pressure_t)(void *context, size_t usage, size_t soft_limit);
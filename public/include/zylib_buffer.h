@@ -0,0 +1,127 @@
+/*
+ * Copyright 2023 Alexandre Fernandez <alex@fernandezfamily.email>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "zylib_allocator.h"
+#include <stddef.h>
+
+/**
+ * Growable Byte Buffer Data Structure
+ */
+typedef void *zylib_buffer_t;
+
+ZYLIB_BEGIN_DECLS
+
+/**
+ * Construct a buffer object.
+ * The memory region grows geometrically, so appending is amortized constant time.
+ * @param obj The object to construct
+ * @param allocator The allocator object
+ * @param capacity The initial capacity, which may be 0
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_buffer_construct(zylib_buffer_t **obj, const zylib_allocator_t *allocator, size_t capacity);
+
+/**
+ * Deconstruct a buffer object
+ * @param obj The object to deconstruct
+ */
+ZYLIB_NONNULL
+void zylib_buffer_destruct(zylib_buffer_t **obj);
+
+/**
+ * Grow the capacity of a buffer to at least capacity bytes
+ * @param obj The buffer object
+ * @param capacity The capacity
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_buffer_reserve(zylib_buffer_t *obj, size_t capacity);
+
+/**
+ * Shrink the capacity of a buffer to its size
+ * @param obj The buffer object
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_buffer_shrink_to_fit(zylib_buffer_t *obj);
+
+/**
+ * Append a memory region to a buffer
+ * @param obj The buffer object
+ * @param size The size of the memory region
+ * @param data The memory region to copy
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_buffer_append(zylib_buffer_t *obj, size_t size, const void *data);
+
+/**
+ * Append formatted text to a buffer; the terminating null character is written past the size of the buffer, so the
+ * memory region holds a string until the next append
+ * @param obj The buffer object
+ * @param format The format string
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_PRINTF_LIKE(2, 3)
+ZYLIB_NONNULL
+_Bool zylib_buffer_append_format(zylib_buffer_t *obj, const char *format, ...);
+
+/**
+ * Empty a buffer, retaining its capacity
+ * @param obj The buffer object
+ */
+ZYLIB_NONNULL
+void zylib_buffer_clear(zylib_buffer_t *obj);
+
+/**
+ * Hand the memory region of a non-empty buffer back to the caller, leaving the buffer empty.
+ * The memory region is shrunk to its size first, so it can be passed to zylib_dequeue_adopt_first() or
+ * zylib_dequeue_adopt_last().
+ * @param obj The buffer object
+ * @param size The pointer to the size of the memory region
+ * @param data The pointer to the memory region, to be deallocated with the allocator object of obj
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_buffer_detach(zylib_buffer_t *obj, size_t *size, void **data);
+
+/**
+ * Retrieve the size of a buffer
+ * @param obj The buffer object
+ * @return The size of the memory region
+ */
+ZYLIB_NONNULL
+size_t zylib_buffer_size(const zylib_buffer_t *obj);
+
+/**
+ * Retrieve the capacity of a buffer
+ * @param obj The buffer object
+ * @return The capacity of the memory region
+ */
+ZYLIB_NONNULL
+size_t zylib_buffer_capacity(const zylib_buffer_t *obj);
+
+/**
+ * Retrieve the memory region of a buffer; it is invalidated by any operation that grows or shrinks the buffer
+ * @param obj The buffer object
+ * @return The address of the memory region, or NULL if the buffer has no capacity
+ */
+ZYLIB_NONNULL
+void *zylib_buffer_data(const zylib_buffer_t *obj);
+
+ZYLIB_END_DECLS
@@ -46,3 +46,15 @@
 #else
 #define ZYLIB_NONNULL_N(n)
 #endif
+
+#if defined(__GNUC__)
+#define ZYLIB_NOINLINE __attribute__((noinline))
+#else
+#define ZYLIB_NOINLINE
+#endif
+
+#if defined(__GNUC__)
+#define ZYLIB_PREFETCH(address) __builtin_prefetch(address)
+#else
+#define ZYLIB_PREFETCH(address) ((void)(address))
+#endif
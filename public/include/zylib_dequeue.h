@@ -16,6 +16,9 @@
 #pragma once
 
 #include "zylib_allocator.h"
+#include "zylib_dequeue_def.h"
+#include "zylib_rope.h"
+#include "zylib_shared_box.h"
 #include <stdint.h>
 
 /**
@@ -34,6 +37,54 @@ ZYLIB_BEGIN_DECLS
 ZYLIB_NONNULL
 _Bool zylib_dequeue_construct(zylib_dequeue_t **obj, const zylib_allocator_t *allocator);
 
+/**
+ * Construct a dequeue object whose nodes holding small memory regions are allocated from page-sized slabs.
+ * Slabs are retained for reuse, which trades memory for fewer allocator calls, until the object is cleared or
+ * deconstructed, or until they stay empty for the decay period set on the allocator object.
+ * @param obj The object to construct
+ * @param allocator The allocator object
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_dequeue_construct_pooled(zylib_dequeue_t **obj, const zylib_allocator_t *allocator);
+
+/**
+ * Construct a dequeue object whose nodes are stored in a ring of fixed-size blocks instead of a linked list.
+ * Nodes are retrieved by index in constant time with zylib_dequeue_at(), and blocks are retained until the object is
+ * cleared or deconstructed.
+ * @param obj The object to construct
+ * @param allocator The allocator object
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_dequeue_construct_blocked(zylib_dequeue_t **obj, const zylib_allocator_t *allocator);
+
+/**
+ * Construct a dequeue object whose memory regions are copied back-to-back into large chunks, each preceded by its size
+ * encoded as a varint; this costs 1 byte per node for memory regions of up to 127 bytes. Walking such a dequeue
+ * backwards with a cursor reads each chunk but the last from its beginning.
+ * Memory regions retrieved from such a dequeue are not aligned, and nodes can only be inserted with
+ * zylib_dequeue_push_first() and zylib_dequeue_push_last().
+ * @param obj The object to construct
+ * @param allocator The allocator object
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_dequeue_construct_packed(zylib_dequeue_t **obj, const zylib_allocator_t *allocator);
+
+/**
+ * Construct a dequeue object whose memory regions all have the same size, copied densely into a ring buffer.
+ * Nodes can be inserted and removed in bulk with zylib_dequeue_push_n_first(), zylib_dequeue_push_n_last(),
+ * zylib_dequeue_pop_n_first() and zylib_dequeue_pop_n_last(), and one at a time with zylib_dequeue_push_first() and
+ * zylib_dequeue_push_last() given memory regions of that size.
+ * @param obj The object to construct
+ * @param allocator The allocator object
+ * @param element_size The size of every memory region
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_dequeue_construct_fixed(zylib_dequeue_t **obj, const zylib_allocator_t *allocator, uint64_t element_size);
+
 /**
  * Deconstruct a dequeue object
  * @param obj The object to deconstruct
@@ -68,6 +119,108 @@ _Bool zylib_dequeue_push_first(zylib_dequeue_t *obj, uint64_t size, const void *
 ZYLIB_NONNULL
 _Bool zylib_dequeue_push_last(zylib_dequeue_t *obj, uint64_t size, const void *data);
 
+/**
+ * Insert n nodes at the beginning of a fixed-size dequeue, in the order of their memory regions
+ * @param obj The dequeue object, constructed with zylib_dequeue_construct_fixed()
+ * @param n The number of nodes
+ * @param data The memory regions, n times the element size of obj in total
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_dequeue_push_n_first(zylib_dequeue_t *obj, uint64_t n, const void *data);
+
+/**
+ * Insert n nodes at the end of a fixed-size dequeue, in the order of their memory regions
+ * @param obj The dequeue object, constructed with zylib_dequeue_construct_fixed()
+ * @param n The number of nodes
+ * @param data The memory regions, n times the element size of obj in total
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_dequeue_push_n_last(zylib_dequeue_t *obj, uint64_t n, const void *data);
+
+/**
+ * Insert a node at the beginning of a dequeue that takes ownership of a memory region instead of copying it
+ * @param obj The dequeue object
+ * @param size The size of the memory region
+ * @param data The pointer to the memory region, which must have been allocated from the allocator object of obj; set
+ * to NULL on success
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_dequeue_adopt_first(zylib_dequeue_t *obj, uint64_t size, void **data);
+
+/**
+ * Insert a node at the end of a dequeue that takes ownership of a memory region instead of copying it
+ * @param obj The dequeue object
+ * @param size The size of the memory region
+ * @param data The pointer to the memory region, which must have been allocated from the allocator object of obj; set
+ * to NULL on success
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_dequeue_adopt_last(zylib_dequeue_t *obj, uint64_t size, void **data);
+
+/**
+ * Insert a node at the beginning of a dequeue that acquires a reference to a shared box instead of copying its
+ * memory region
+ * @param obj The dequeue object
+ * @param box The shared box object
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_dequeue_push_shared_first(zylib_dequeue_t *obj, zylib_shared_box_t *box);
+
+/**
+ * Insert a node at the end of a dequeue that acquires a reference to a shared box instead of copying its memory
+ * region
+ * @param obj The dequeue object
+ * @param box The shared box object
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_dequeue_push_shared_last(zylib_dequeue_t *obj, zylib_shared_box_t *box);
+
+/**
+ * Insert a node at the beginning of a dequeue that takes ownership of a non-empty rope; the rope is flattened into a
+ * single segment on insertion, so that retrieving its node never modifies nor allocates
+ * @param obj The dequeue object
+ * @param rope The pointer to the rope object, which must share the allocator object of obj; set to NULL on success
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_dequeue_push_rope_first(zylib_dequeue_t *obj, zylib_rope_t **rope);
+
+/**
+ * Insert a node at the end of a dequeue that takes ownership of a non-empty rope; the rope is flattened into a single
+ * segment on insertion, so that retrieving its node never modifies nor allocates
+ * @param obj The dequeue object
+ * @param rope The pointer to the rope object, which must share the allocator object of obj; set to NULL on success
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_dequeue_push_rope_last(zylib_dequeue_t *obj, zylib_rope_t **rope);
+
+/**
+ * Copy the memory regions of the n nodes at the beginning of a fixed-size dequeue, in order, then remove them
+ * @param obj The dequeue object, constructed with zylib_dequeue_construct_fixed()
+ * @param n The number of nodes, which must not exceed the number of nodes of obj
+ * @param data The memory region receiving n times the element size of obj
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_dequeue_pop_n_first(zylib_dequeue_t *obj, uint64_t n, void *data);
+
+/**
+ * Copy the memory regions of the n nodes at the end of a fixed-size dequeue, in order, then remove them
+ * @param obj The dequeue object, constructed with zylib_dequeue_construct_fixed()
+ * @param n The number of nodes, which must not exceed the number of nodes of obj
+ * @param data The memory region receiving n times the element size of obj
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_dequeue_pop_n_last(zylib_dequeue_t *obj, uint64_t n, void *data);
+
 /**
  * Deconstruct the node at the beginning of a dequeue
  * @param obj The dequeue object
@@ -82,6 +235,28 @@ void zylib_dequeue_discard_first(zylib_dequeue_t *obj);
 ZYLIB_NONNULL
 void zylib_dequeue_discard_last(zylib_dequeue_t *obj);
 
+/**
+ * Deconstruct the node at the beginning of a dequeue, handing its memory region back to the caller.
+ * An adopted memory region is handed back without being copied; the memory region of a shared box is copied.
+ * @param obj The dequeue object
+ * @param size The pointer to the size of the memory region
+ * @param data The pointer to the memory region, to be deallocated with the allocator object of obj
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_dequeue_release_first(zylib_dequeue_t *obj, uint64_t *size, void **data);
+
+/**
+ * Deconstruct the node at the end of a dequeue, handing its memory region back to the caller.
+ * An adopted memory region is handed back without being copied; the memory region of a shared box is copied.
+ * @param obj The dequeue object
+ * @param size The pointer to the size of the memory region
+ * @param data The pointer to the memory region, to be deallocated with the allocator object of obj
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_dequeue_release_last(zylib_dequeue_t *obj, uint64_t *size, void **data);
+
 /**
  * Retrieve the node at the beginning of a dequeue
  * @param obj The dequeue object
@@ -102,6 +277,81 @@ _Bool zylib_dequeue_peek_first(const zylib_dequeue_t *obj, uint64_t *size, const
 ZYLIB_NONNULL
 _Bool zylib_dequeue_peek_last(const zylib_dequeue_t *obj, uint64_t *size, const void **data);
 
+/**
+ * Retrieve the node at an index of a dequeue, counting from its beginning.
+ * This takes constant time for a dequeue constructed with zylib_dequeue_construct_blocked(), and linear time otherwise.
+ * @param obj The dequeue object
+ * @param index The index of the node
+ * @param size The pointer to the size of the memory region
+ * @param data The pointer to the memory region
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_dequeue_at(const zylib_dequeue_t *obj, uint64_t index, uint64_t *size, const void **data);
+
+/**
+ * Retrieve the rope stored by the node at the beginning of a dequeue
+ * @param obj The dequeue object
+ * @param rope The pointer to the rope object
+ * @return True if and only if the node exists and stores a rope
+ */
+ZYLIB_NONNULL
+_Bool zylib_dequeue_peek_rope_first(const zylib_dequeue_t *obj, const zylib_rope_t **rope);
+
+/**
+ * Retrieve the rope stored by the node at the end of a dequeue
+ * @param obj The dequeue object
+ * @param rope The pointer to the rope object
+ * @return True if and only if the node exists and stores a rope
+ */
+ZYLIB_NONNULL
+_Bool zylib_dequeue_peek_rope_last(const zylib_dequeue_t *obj, const zylib_rope_t **rope);
+
+/**
+ * Position a cursor at the first node of a dequeue.
+ * Cursors walk a dequeue without modifying it nor allocating memory, and prefetch the nodes ahead of them.
+ * @param obj The dequeue object
+ * @param cursor The cursor
+ * @return True if and only if the dequeue is not empty
+ */
+ZYLIB_NONNULL
+_Bool zylib_dequeue_cursor_first(const zylib_dequeue_t *obj, zylib_dequeue_cursor_t *cursor);
+
+/**
+ * Position a cursor at the last node of a dequeue
+ * @param obj The dequeue object
+ * @param cursor The cursor
+ * @return True if and only if the dequeue is not empty
+ */
+ZYLIB_NONNULL
+_Bool zylib_dequeue_cursor_last(const zylib_dequeue_t *obj, zylib_dequeue_cursor_t *cursor);
+
+/**
+ * Move a cursor to the next node of its dequeue; the cursor is left unchanged at the last node
+ * @param cursor The cursor, positioned with zylib_dequeue_cursor_first() or zylib_dequeue_cursor_last()
+ * @return True if and only if there was a next node
+ */
+ZYLIB_NONNULL
+_Bool zylib_dequeue_cursor_next(zylib_dequeue_cursor_t *cursor);
+
+/**
+ * Move a cursor to the previous node of its dequeue; the cursor is left unchanged at the first node
+ * @param cursor The cursor, positioned with zylib_dequeue_cursor_first() or zylib_dequeue_cursor_last()
+ * @return True if and only if there was a previous node
+ */
+ZYLIB_NONNULL
+_Bool zylib_dequeue_cursor_prev(zylib_dequeue_cursor_t *cursor);
+
+/**
+ * Retrieve the node at the position of a cursor
+ * @param cursor The cursor, positioned with zylib_dequeue_cursor_first() or zylib_dequeue_cursor_last()
+ * @param size The pointer to the size of the memory region
+ * @param data The pointer to the memory region
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_dequeue_cursor_get(const zylib_dequeue_cursor_t *cursor, uint64_t *size, const void **data);
+
 /**
  * Retrieve the number of nodes stored within a dequeue
  * @param obj The dequeue object
@@ -0,0 +1,33 @@
+/*
+ * Copyright 2023 Alexandre Fernandez <alex@fernandezfamily.email>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Dequeue Cursor Data Structure.
+ * A cursor is a position within a dequeue, owned by the caller; its members are private, and it is invalidated by any
+ * operation that inserts or removes nodes.
+ */
+typedef struct zylib_dequeue_cursor_s
+{
+    const void *dequeue;
+    /* The current node of a linked dequeue, or the chunk holding the current node of a packed dequeue */
+    const void *node;
+    /* The offset of the current node within its chunk */
+    size_t offset;
+    uint64_t index;
+} zylib_dequeue_cursor_t;
@@ -16,6 +16,7 @@
 #pragma once
 
 #include "zylib_allocator.h"
+#include "zylib_rope.h"
 #include <stdint.h>
 
 /**
@@ -87,6 +88,38 @@ ZYLIB_NONNULL_N(5)
 _Bool zylib_error_push_last(zylib_error_t *obj, int64_t error_code, const char *file_name, uint64_t line_number,
                             const char *function_name, uint64_t auxiliary_size, const void *auxiliary_data);
 
+/**
+ * Insert an error container at the beginning of an error dequeue whose auxiliary data is a rope.
+ * The rope is moved into the error container and flattened once, when it is inserted.
+ * @param obj The error dequeue object
+ * @param error_code The error code
+ * @param file_name The file name string literal
+ * @param line_number The line number
+ * @param function_name The function name string literal
+ * @param auxiliary The pointer to the rope object, which must share the allocator object of obj; it is deconstructed
+ * and set to NULL whether or not the operation is successful
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_error_push_rope_first(zylib_error_t *obj, int64_t error_code, const char *file_name, uint64_t line_number,
+                                  const char *function_name, zylib_rope_t **auxiliary);
+
+/**
+ * Insert an error container at the end of an error dequeue whose auxiliary data is a rope.
+ * The rope is moved into the error container and flattened once, when it is inserted.
+ * @param obj The error dequeue object
+ * @param error_code The error code
+ * @param file_name The file name string literal
+ * @param line_number The line number
+ * @param function_name The function name string literal
+ * @param auxiliary The pointer to the rope object, which must share the allocator object of obj; it is deconstructed
+ * and set to NULL whether or not the operation is successful
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_error_push_rope_last(zylib_error_t *obj, int64_t error_code, const char *file_name, uint64_t line_number,
+                                 const char *function_name, zylib_rope_t **auxiliary);
+
 /**
  * Deconstruct the error container at the beginning of an error dequeue
  * @param obj The error dequeue object
@@ -0,0 +1,101 @@
+/*
+ * Copyright 2023 Alexandre Fernandez <alex@fernandezfamily.email>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "zylib_allocator.h"
+
+/**
+ * Fixed-Size Object Pool Data Structure
+ */
+typedef void *zylib_pool_t;
+
+ZYLIB_BEGIN_DECLS
+
+/**
+ * Construct a pool object.
+ * Objects of a fixed size are served from page-sized slabs; freed objects are kept on an intrusive free list and
+ * reused before the slabs grow. Objects are suitably aligned for any type, like memory from the allocator. Slabs left
+ * empty are returned to the allocator when the pool is trimmed, or once they stay empty for a whole decay period.
+ * A pool object is owned by a single thread, but other threads may free its objects with zylib_pool_free_remote().
+ * @param obj The object to construct
+ * @param allocator The allocator object
+ * @param size The size of each object
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_pool_construct(zylib_pool_t **obj, const zylib_allocator_t *allocator, size_t size);
+
+/**
+ * Deconstruct a pool object, along with every object allocated from it
+ * @param obj The object to deconstruct
+ */
+ZYLIB_NONNULL
+void zylib_pool_destruct(zylib_pool_t **obj);
+
+/**
+ * Allocate an object
+ * @param obj The pool object
+ * @param ptr The pointer to the address of the object
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_pool_malloc(zylib_pool_t *obj, void **ptr);
+
+/**
+ * Deallocate an object
+ * @param obj The pool object
+ * @param ptr The pointer to the object
+ */
+ZYLIB_NONNULL
+void zylib_pool_free(zylib_pool_t *obj, void **ptr);
+
+/**
+ * Deallocate an object from a thread other than the one that owns the pool object.
+ * The object is pushed onto a lock-free list that the owner reclaims, in one batch, the next time its free list runs
+ * out; it may be called concurrently from any number of threads.
+ * @param obj The pool object
+ * @param ptr The pointer to the object
+ */
+ZYLIB_NONNULL
+void zylib_pool_free_remote(zylib_pool_t *obj, void **ptr);
+
+/**
+ * Retrieve the size of the objects served by a pool object
+ * @param obj The pool object
+ * @return The object size, rounded up to a multiple of _Alignof(max_align_t)
+ */
+ZYLIB_NONNULL
+size_t zylib_pool_size(const zylib_pool_t *obj);
+
+/**
+ * Return every empty slab of a pool object to its allocator
+ * @param obj The pool object
+ * @return True if and only if no object was allocated
+ */
+ZYLIB_NONNULL
+_Bool zylib_pool_trim(zylib_pool_t *obj);
+
+/**
+ * Set the decay period of a pool object.
+ * Whenever a slab becomes empty, the slabs that have been empty for a whole period are returned to the allocator, at
+ * most once per period. Until set, the decay period is the one set on the allocator with zylib_allocator_set_decay().
+ * @param obj The pool object
+ * @param milliseconds The decay period, or 0 to retain slabs until zylib_pool_trim()
+ */
+ZYLIB_NONNULL
+void zylib_pool_set_decay(zylib_pool_t *obj, uint64_t milliseconds);
+
+ZYLIB_END_DECLS
@@ -0,0 +1,85 @@
+/*
+ * Copyright 2023 Alexandre Fernandez <alex@fernandezfamily.email>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "zylib_allocator.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Rope Data Structure.
+ * A memory region stored as a chain of fixed-size chunks, for payloads too large to grow by reallocation.
+ */
+typedef void *zylib_rope_t;
+
+ZYLIB_BEGIN_DECLS
+
+/**
+ * Construct an empty rope object
+ * @param obj The object to construct
+ * @param allocator The allocator object
+ * @param chunk_size The size of each chunk, or 0 for the default of 64 KiB
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_rope_construct(zylib_rope_t **obj, const zylib_allocator_t *allocator, size_t chunk_size);
+
+/**
+ * Deconstruct a rope object
+ * @param obj The object to deconstruct
+ */
+ZYLIB_NONNULL
+void zylib_rope_destruct(zylib_rope_t **obj);
+
+/**
+ * Append a memory region to a rope; the memory region already stored is never copied
+ * @param obj The rope object
+ * @param size The size of the memory region
+ * @param data The memory region to copy
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_rope_append(zylib_rope_t *obj, uint64_t size, const void *data);
+
+/**
+ * Retrieve the next contiguous segment of a rope
+ * @param obj The rope object
+ * @param iterator The pointer to the iterator, which must be NULL to retrieve the first segment
+ * @param size The pointer to the size of the segment
+ * @param data The pointer to the segment
+ * @return True if and only if a segment was retrieved
+ */
+ZYLIB_NONNULL
+_Bool zylib_rope_next(const zylib_rope_t *obj, const void **iterator, uint64_t *size, const void **data);
+
+/**
+ * Copy the chunks of a non-empty rope into a single contiguous memory region, unless it is already contiguous
+ * @param obj The rope object
+ * @param data The pointer to the memory region, which remains valid until the rope is modified
+ * @return True if and only if the operation was successful
+ */
+ZYLIB_NONNULL
+_Bool zylib_rope_flatten(zylib_rope_t *obj, const void **data);
+
+/**
+ * Retrieve the size of the memory region of a rope
+ * @param obj The rope object
+ * @return The size of the memory region
+ */
+ZYLIB_NONNULL
+uint64_t zylib_rope_size(const zylib_rope_t *obj);
+
+ZYLIB_END_DECLS
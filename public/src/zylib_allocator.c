@@ -15,6 +15,14 @@
  */
 #include "zylib_allocator.h"
 #include "zylib_private_allocator.h"
+#include "zylib_private_arena.h"
+#include "zylib_private_budget.h"
+#include "zylib_private_mmap.h"
+#include "zylib_private_per_cpu.h"
+#include "zylib_private_profiler.h"
+#include "zylib_private_size_class.h"
+#include "zylib_private_stats.h"
+#include "zylib_private_thread_cache.h"
 #include <assert.h>
 
 /*
@@ -31,6 +39,17 @@ _Bool zylib_allocator_construct(zylib_allocator_t **obj, zylib_allocator_malloc_
     return zylib_private_allocator_construct((zylib_private_allocator_t **)obj, malloc, realloc, free);
 }
 
+_Bool zylib_allocator_construct_context(zylib_allocator_t **obj, const zylib_allocator_vtable_t *vtable,
+                                        void *context)
+{
+    assert(obj != NULL);
+    assert(vtable != NULL);
+    assert(vtable->malloc != NULL);
+    assert(vtable->realloc != NULL);
+    assert(vtable->free != NULL);
+    return zylib_private_allocator_construct_context((zylib_private_allocator_t **)obj, NULL, vtable, context);
+}
+
 void zylib_allocator_destruct(zylib_allocator_t **obj)
 {
     assert(obj != NULL);
@@ -45,6 +64,14 @@ _Bool zylib_allocator_malloc(const zylib_allocator_t *obj, size_t size, void **d
     return zylib_private_allocator_malloc((const zylib_private_allocator_t *)obj, size, data);
 }
 
+_Bool zylib_allocator_calloc(const zylib_allocator_t *obj, size_t size, void **data)
+{
+    assert(obj != NULL);
+    assert(size > 0);
+    assert(data != NULL);
+    return zylib_private_allocator_calloc((const zylib_private_allocator_t *)obj, size, data);
+}
+
 _Bool zylib_allocator_realloc(const zylib_allocator_t *obj, size_t size, void **data)
 {
     assert(obj != NULL);
@@ -53,9 +80,142 @@ _Bool zylib_allocator_realloc(const zylib_allocator_t *obj, size_t size, void **
     return zylib_private_allocator_realloc((const zylib_private_allocator_t *)obj, size, data);
 }
 
+_Bool zylib_allocator_realloc_sized(const zylib_allocator_t *obj, size_t old_size, size_t size, void **data)
+{
+    assert(obj != NULL);
+    assert(size > 0);
+    assert(data != NULL);
+    return zylib_private_allocator_realloc_sized((const zylib_private_allocator_t *)obj, old_size, size, data);
+}
+
 void zylib_allocator_free(const zylib_allocator_t *obj, void **data)
 {
     assert(obj != NULL);
     assert(data != NULL);
     zylib_private_allocator_free((const zylib_private_allocator_t *)obj, data);
 }
+
+void zylib_allocator_free_sized(const zylib_allocator_t *obj, size_t size, void **data)
+{
+    assert(obj != NULL);
+    assert(data != NULL);
+    zylib_private_allocator_free_sized((const zylib_private_allocator_t *)obj, size, data);
+}
+
+_Bool zylib_allocator_aligned_malloc(const zylib_allocator_t *obj, size_t alignment, size_t size, void **data)
+{
+    assert(obj != NULL);
+    assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+    assert(size > 0);
+    assert(data != NULL);
+    return zylib_private_allocator_aligned_malloc((const zylib_private_allocator_t *)obj, alignment, size, data);
+}
+
+void zylib_allocator_aligned_free(const zylib_allocator_t *obj, size_t alignment, size_t size, void **data)
+{
+    assert(obj != NULL);
+    assert(data != NULL);
+    zylib_private_allocator_aligned_free((const zylib_private_allocator_t *)obj, alignment, size, data);
+}
+
+_Bool zylib_allocator_construct_arena(zylib_allocator_t **obj, size_t block_size, const zylib_allocator_t *parent)
+{
+    assert(obj != NULL);
+    assert(block_size > 0);
+    assert(parent != NULL);
+    return zylib_private_arena_construct((zylib_private_allocator_t **)obj, block_size,
+                                         (const zylib_private_allocator_t *)parent);
+}
+
+_Bool zylib_allocator_arena_reset(zylib_allocator_t *obj)
+{
+    assert(obj != NULL);
+    return zylib_private_arena_reset((zylib_private_allocator_t *)obj);
+}
+
+_Bool zylib_allocator_trim(zylib_allocator_t *obj)
+{
+    assert(obj != NULL);
+    return zylib_private_arena_trim((zylib_private_allocator_t *)obj) ||
+           zylib_private_size_class_trim((zylib_private_allocator_t *)obj);
+}
+
+_Bool zylib_allocator_set_decay(zylib_allocator_t *obj, uint64_t milliseconds)
+{
+    assert(obj != NULL);
+    return zylib_private_arena_set_decay((zylib_private_allocator_t *)obj, milliseconds) ||
+           zylib_private_size_class_set_decay((zylib_private_allocator_t *)obj, milliseconds);
+}
+
+_Bool zylib_allocator_construct_thread_cache(zylib_allocator_t **obj, const zylib_allocator_t *parent)
+{
+    assert(obj != NULL);
+    assert(parent != NULL);
+    return zylib_private_thread_cache_construct((zylib_private_allocator_t **)obj,
+                                                (const zylib_private_allocator_t *)parent);
+}
+
+_Bool zylib_allocator_construct_per_cpu(zylib_allocator_t **obj, const zylib_allocator_t *parent)
+{
+    assert(obj != NULL);
+    assert(parent != NULL);
+    return zylib_private_per_cpu_construct((zylib_private_allocator_t **)obj,
+                                           (const zylib_private_allocator_t *)parent);
+}
+
+_Bool zylib_allocator_construct_size_class(zylib_allocator_t **obj, const zylib_allocator_t *parent)
+{
+    assert(obj != NULL);
+    assert(parent != NULL);
+    return zylib_private_size_class_construct((zylib_private_allocator_t **)obj,
+                                              (const zylib_private_allocator_t *)parent);
+}
+
+_Bool zylib_allocator_construct_mmap(zylib_allocator_t **obj, size_t threshold, unsigned flags,
+                                     const zylib_allocator_t *parent)
+{
+    assert(obj != NULL);
+    assert(parent != NULL);
+    return zylib_private_mmap_construct((zylib_private_allocator_t **)obj, threshold, flags,
+                                        (const zylib_private_allocator_t *)parent);
+}
+
+_Bool zylib_allocator_construct_stats(zylib_allocator_t **obj, const zylib_allocator_t *parent)
+{
+    assert(obj != NULL);
+    assert(parent != NULL);
+    return zylib_private_stats_construct((zylib_private_allocator_t **)obj, (const zylib_private_allocator_t *)parent);
+}
+
+_Bool zylib_allocator_stats(const zylib_allocator_t *obj, zylib_allocator_stats_t *stats)
+{
+    assert(obj != NULL);
+    assert(stats != NULL);
+    return zylib_private_stats_query((const zylib_private_allocator_t *)obj, stats);
+}
+
+_Bool zylib_allocator_construct_budget(zylib_allocator_t **obj, size_t soft_limit, size_t hard_limit,
+                                       zylib_allocator_pressure_t pressure, void *context,
+                                       const zylib_allocator_t *parent)
+{
+    assert(obj != NULL);
+    assert(soft_limit <= hard_limit);
+    assert(parent != NULL);
+    return zylib_private_budget_construct((zylib_private_allocator_t **)obj, soft_limit, hard_limit, pressure, context,
+                                          (const zylib_private_allocator_t *)parent);
+}
+
+_Bool zylib_allocator_construct_profiler(zylib_allocator_t **obj, size_t sample_rate, const zylib_allocator_t *parent)
+{
+    assert(obj != NULL);
+    assert(parent != NULL);
+    return zylib_private_profiler_construct((zylib_private_allocator_t **)obj, sample_rate,
+                                            (const zylib_private_allocator_t *)parent);
+}
+
+_Bool zylib_allocator_profiler_dump(const zylib_allocator_t *obj, FILE *stream)
+{
+    assert(obj != NULL);
+    assert(stream != NULL);
+    return zylib_private_profiler_dump((const zylib_private_allocator_t *)obj, stream);
+}
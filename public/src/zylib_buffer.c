@@ -0,0 +1,98 @@
+/*
+ * Copyright 2023 Alexandre Fernandez <alex@fernandezfamily.email>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "zylib_buffer.h"
+#include "zylib_private_buffer.h"
+#include <assert.h>
+#include <stdarg.h>
+
+_Bool zylib_buffer_construct(zylib_buffer_t **obj, const zylib_allocator_t *allocator, size_t capacity)
+{
+    assert(obj != NULL);
+    assert(allocator != NULL);
+    return zylib_private_buffer_construct((zylib_private_buffer_t **)obj, (const zylib_private_allocator_t *)allocator,
+                                          capacity);
+}
+
+void zylib_buffer_destruct(zylib_buffer_t **obj)
+{
+    assert(obj != NULL);
+    zylib_private_buffer_destruct((zylib_private_buffer_t **)obj);
+}
+
+_Bool zylib_buffer_reserve(zylib_buffer_t *obj, size_t capacity)
+{
+    assert(obj != NULL);
+    return zylib_private_buffer_reserve((zylib_private_buffer_t *)obj, capacity);
+}
+
+_Bool zylib_buffer_shrink_to_fit(zylib_buffer_t *obj)
+{
+    assert(obj != NULL);
+    return zylib_private_buffer_shrink_to_fit((zylib_private_buffer_t *)obj);
+}
+
+_Bool zylib_buffer_append(zylib_buffer_t *obj, size_t size, const void *data)
+{
+    assert(obj != NULL);
+    assert(data != NULL);
+    return zylib_private_buffer_append((zylib_private_buffer_t *)obj, size, data);
+}
+
+_Bool zylib_buffer_append_format(zylib_buffer_t *obj, const char *format, ...)
+{
+    _Bool r;
+    va_list args;
+
+    assert(obj != NULL);
+    assert(format != NULL);
+
+    va_start(args, format);
+    r = zylib_private_buffer_append_vformat((zylib_private_buffer_t *)obj, format, args);
+    va_end(args);
+    return r;
+}
+
+void zylib_buffer_clear(zylib_buffer_t *obj)
+{
+    assert(obj != NULL);
+    zylib_private_buffer_clear((zylib_private_buffer_t *)obj);
+}
+
+_Bool zylib_buffer_detach(zylib_buffer_t *obj, size_t *size, void **data)
+{
+    assert(obj != NULL);
+    assert(size != NULL);
+    assert(data != NULL);
+    return zylib_private_buffer_detach((zylib_private_buffer_t *)obj, size, data);
+}
+
+size_t zylib_buffer_size(const zylib_buffer_t *obj)
+{
+    assert(obj != NULL);
+    return zylib_private_buffer_peek_size((const zylib_private_buffer_t *)obj);
+}
+
+size_t zylib_buffer_capacity(const zylib_buffer_t *obj)
+{
+    assert(obj != NULL);
+    return zylib_private_buffer_peek_capacity((const zylib_private_buffer_t *)obj);
+}
+
+void *zylib_buffer_data(const zylib_buffer_t *obj)
+{
+    assert(obj != NULL);
+    return zylib_private_buffer_peek_data((const zylib_private_buffer_t *)obj);
+}
@@ -25,6 +25,39 @@ _Bool zylib_dequeue_construct(zylib_dequeue_t **obj, const zylib_allocator_t *al
                                            (const zylib_private_allocator_t *)allocator);
 }
 
+_Bool zylib_dequeue_construct_pooled(zylib_dequeue_t **obj, const zylib_allocator_t *allocator)
+{
+    assert(obj != NULL);
+    assert(allocator != NULL);
+    return zylib_private_dequeue_construct_pooled((zylib_private_dequeue_t **)obj,
+                                                  (const zylib_private_allocator_t *)allocator);
+}
+
+_Bool zylib_dequeue_construct_blocked(zylib_dequeue_t **obj, const zylib_allocator_t *allocator)
+{
+    assert(obj != NULL);
+    assert(allocator != NULL);
+    return zylib_private_dequeue_construct_blocked((zylib_private_dequeue_t **)obj,
+                                                   (const zylib_private_allocator_t *)allocator);
+}
+
+_Bool zylib_dequeue_construct_packed(zylib_dequeue_t **obj, const zylib_allocator_t *allocator)
+{
+    assert(obj != NULL);
+    assert(allocator != NULL);
+    return zylib_private_dequeue_construct_packed((zylib_private_dequeue_t **)obj,
+                                                  (const zylib_private_allocator_t *)allocator);
+}
+
+_Bool zylib_dequeue_construct_fixed(zylib_dequeue_t **obj, const zylib_allocator_t *allocator, uint64_t element_size)
+{
+    assert(obj != NULL);
+    assert(allocator != NULL);
+    assert(element_size > 0);
+    return zylib_private_dequeue_construct_fixed((zylib_private_dequeue_t **)obj,
+                                                 (const zylib_private_allocator_t *)allocator, element_size);
+}
+
 void zylib_dequeue_destruct(zylib_dequeue_t **obj)
 {
     assert(obj != NULL);
@@ -53,6 +86,86 @@ _Bool zylib_dequeue_push_last(zylib_dequeue_t *obj, uint64_t size, const void *d
     return zylib_private_dequeue_push_last((zylib_private_dequeue_t *)obj, size, data);
 }
 
+_Bool zylib_dequeue_push_n_first(zylib_dequeue_t *obj, uint64_t n, const void *data)
+{
+    assert(obj != NULL);
+    assert(n > 0);
+    assert(data != NULL);
+    return zylib_private_dequeue_push_n_first((zylib_private_dequeue_t *)obj, n, data);
+}
+
+_Bool zylib_dequeue_push_n_last(zylib_dequeue_t *obj, uint64_t n, const void *data)
+{
+    assert(obj != NULL);
+    assert(n > 0);
+    assert(data != NULL);
+    return zylib_private_dequeue_push_n_last((zylib_private_dequeue_t *)obj, n, data);
+}
+
+_Bool zylib_dequeue_adopt_first(zylib_dequeue_t *obj, uint64_t size, void **data)
+{
+    assert(obj != NULL);
+    assert(size > 0);
+    assert(data != NULL);
+    assert(*data != NULL);
+    return zylib_private_dequeue_adopt_first((zylib_private_dequeue_t *)obj, size, data);
+}
+
+_Bool zylib_dequeue_adopt_last(zylib_dequeue_t *obj, uint64_t size, void **data)
+{
+    assert(obj != NULL);
+    assert(size > 0);
+    assert(data != NULL);
+    assert(*data != NULL);
+    return zylib_private_dequeue_adopt_last((zylib_private_dequeue_t *)obj, size, data);
+}
+
+_Bool zylib_dequeue_push_shared_first(zylib_dequeue_t *obj, zylib_shared_box_t *box)
+{
+    assert(obj != NULL);
+    assert(box != NULL);
+    return zylib_private_dequeue_push_shared_first((zylib_private_dequeue_t *)obj, (zylib_private_shared_box_t *)box);
+}
+
+_Bool zylib_dequeue_push_shared_last(zylib_dequeue_t *obj, zylib_shared_box_t *box)
+{
+    assert(obj != NULL);
+    assert(box != NULL);
+    return zylib_private_dequeue_push_shared_last((zylib_private_dequeue_t *)obj, (zylib_private_shared_box_t *)box);
+}
+
+_Bool zylib_dequeue_push_rope_first(zylib_dequeue_t *obj, zylib_rope_t **rope)
+{
+    assert(obj != NULL);
+    assert(rope != NULL);
+    assert(*rope != NULL);
+    return zylib_private_dequeue_push_rope_first((zylib_private_dequeue_t *)obj, (zylib_private_rope_t **)rope);
+}
+
+_Bool zylib_dequeue_push_rope_last(zylib_dequeue_t *obj, zylib_rope_t **rope)
+{
+    assert(obj != NULL);
+    assert(rope != NULL);
+    assert(*rope != NULL);
+    return zylib_private_dequeue_push_rope_last((zylib_private_dequeue_t *)obj, (zylib_private_rope_t **)rope);
+}
+
+_Bool zylib_dequeue_pop_n_first(zylib_dequeue_t *obj, uint64_t n, void *data)
+{
+    assert(obj != NULL);
+    assert(n > 0);
+    assert(data != NULL);
+    return zylib_private_dequeue_pop_n_first((zylib_private_dequeue_t *)obj, n, data);
+}
+
+_Bool zylib_dequeue_pop_n_last(zylib_dequeue_t *obj, uint64_t n, void *data)
+{
+    assert(obj != NULL);
+    assert(n > 0);
+    assert(data != NULL);
+    return zylib_private_dequeue_pop_n_last((zylib_private_dequeue_t *)obj, n, data);
+}
+
 void zylib_dequeue_discard_first(zylib_dequeue_t *obj)
 {
     assert(obj != NULL);
@@ -65,6 +178,22 @@ void zylib_dequeue_discard_last(zylib_dequeue_t *obj)
     zylib_private_dequeue_discard_last((zylib_private_dequeue_t *)obj);
 }
 
+_Bool zylib_dequeue_release_first(zylib_dequeue_t *obj, uint64_t *size, void **data)
+{
+    assert(obj != NULL);
+    assert(size != NULL);
+    assert(data != NULL);
+    return zylib_private_dequeue_release_first((zylib_private_dequeue_t *)obj, size, data);
+}
+
+_Bool zylib_dequeue_release_last(zylib_dequeue_t *obj, uint64_t *size, void **data)
+{
+    assert(obj != NULL);
+    assert(size != NULL);
+    assert(data != NULL);
+    return zylib_private_dequeue_release_last((zylib_private_dequeue_t *)obj, size, data);
+}
+
 _Bool zylib_dequeue_peek_first(const zylib_dequeue_t *obj, uint64_t *size, const void **data)
 {
     assert(obj != NULL);
@@ -81,6 +210,67 @@ _Bool zylib_dequeue_peek_last(const zylib_dequeue_t *obj, uint64_t *size, const
     return zylib_private_dequeue_peek_last((const zylib_private_dequeue_t *)obj, size, data);
 }
 
+_Bool zylib_dequeue_at(const zylib_dequeue_t *obj, uint64_t index, uint64_t *size, const void **data)
+{
+    assert(obj != NULL);
+    assert(size != NULL);
+    assert(data != NULL);
+    return zylib_private_dequeue_at((const zylib_private_dequeue_t *)obj, index, size, data);
+}
+
+_Bool zylib_dequeue_peek_rope_first(const zylib_dequeue_t *obj, const zylib_rope_t **rope)
+{
+    assert(obj != NULL);
+    assert(rope != NULL);
+    return zylib_private_dequeue_peek_rope_first((const zylib_private_dequeue_t *)obj,
+                                                 (const zylib_private_rope_t **)rope);
+}
+
+_Bool zylib_dequeue_peek_rope_last(const zylib_dequeue_t *obj, const zylib_rope_t **rope)
+{
+    assert(obj != NULL);
+    assert(rope != NULL);
+    return zylib_private_dequeue_peek_rope_last((const zylib_private_dequeue_t *)obj,
+                                                (const zylib_private_rope_t **)rope);
+}
+
+_Bool zylib_dequeue_cursor_first(const zylib_dequeue_t *obj, zylib_dequeue_cursor_t *cursor)
+{
+    assert(obj != NULL);
+    assert(cursor != NULL);
+    return zylib_private_dequeue_cursor_first((const zylib_private_dequeue_t *)obj, cursor);
+}
+
+_Bool zylib_dequeue_cursor_last(const zylib_dequeue_t *obj, zylib_dequeue_cursor_t *cursor)
+{
+    assert(obj != NULL);
+    assert(cursor != NULL);
+    return zylib_private_dequeue_cursor_last((const zylib_private_dequeue_t *)obj, cursor);
+}
+
+_Bool zylib_dequeue_cursor_next(zylib_dequeue_cursor_t *cursor)
+{
+    assert(cursor != NULL);
+    assert(cursor->dequeue != NULL);
+    return zylib_private_dequeue_cursor_next(cursor);
+}
+
+_Bool zylib_dequeue_cursor_prev(zylib_dequeue_cursor_t *cursor)
+{
+    assert(cursor != NULL);
+    assert(cursor->dequeue != NULL);
+    return zylib_private_dequeue_cursor_prev(cursor);
+}
+
+_Bool zylib_dequeue_cursor_get(const zylib_dequeue_cursor_t *cursor, uint64_t *size, const void **data)
+{
+    assert(cursor != NULL);
+    assert(cursor->dequeue != NULL);
+    assert(size != NULL);
+    assert(data != NULL);
+    return zylib_private_dequeue_cursor_get(cursor, size, data);
+}
+
 uint64_t zylib_dequeue_size(const zylib_dequeue_t *obj)
 {
     assert(obj != NULL);
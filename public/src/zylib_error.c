@@ -56,6 +56,30 @@ _Bool zylib_error_push_last(zylib_error_t *obj, int64_t error_code, const char *
                                          function_name, auxiliary_size, auxiliary_data);
 }
 
+_Bool zylib_error_push_rope_first(zylib_error_t *obj, int64_t error_code, const char *file_name, uint64_t line_number,
+                                  const char *function_name, zylib_rope_t **auxiliary)
+{
+    assert(obj != NULL);
+    assert(file_name != NULL);
+    assert(function_name != NULL);
+    assert(auxiliary != NULL);
+    assert(*auxiliary != NULL);
+    return zylib_private_error_push_rope_first((zylib_private_error_t *)obj, error_code, file_name, line_number,
+                                               function_name, (zylib_private_rope_t **)auxiliary);
+}
+
+_Bool zylib_error_push_rope_last(zylib_error_t *obj, int64_t error_code, const char *file_name, uint64_t line_number,
+                                 const char *function_name, zylib_rope_t **auxiliary)
+{
+    assert(obj != NULL);
+    assert(file_name != NULL);
+    assert(function_name != NULL);
+    assert(auxiliary != NULL);
+    assert(*auxiliary != NULL);
+    return zylib_private_error_push_rope_last((zylib_private_error_t *)obj, error_code, file_name, line_number,
+                                              function_name, (zylib_private_rope_t **)auxiliary);
+}
+
 void zylib_error_discard_first(zylib_error_t *obj)
 {
     assert(obj != NULL);
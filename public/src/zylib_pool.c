@@ -0,0 +1,72 @@
+/*
+ * Copyright 2023 Alexandre Fernandez <alex@fernandezfamily.email>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "zylib_pool.h"
+#include "zylib_private_pool.h"
+#include <assert.h>
+
+_Bool zylib_pool_construct(zylib_pool_t **obj, const zylib_allocator_t *allocator, size_t size)
+{
+    assert(obj != NULL);
+    assert(allocator != NULL);
+    assert(size > 0);
+    return zylib_private_pool_construct((zylib_private_pool_t **)obj, (const zylib_private_allocator_t *)allocator,
+                                        size);
+}
+
+void zylib_pool_destruct(zylib_pool_t **obj)
+{
+    assert(obj != NULL);
+    zylib_private_pool_destruct((zylib_private_pool_t **)obj);
+}
+
+_Bool zylib_pool_malloc(zylib_pool_t *obj, void **ptr)
+{
+    assert(obj != NULL);
+    assert(ptr != NULL);
+    return zylib_private_pool_malloc((zylib_private_pool_t *)obj, ptr);
+}
+
+void zylib_pool_free(zylib_pool_t *obj, void **ptr)
+{
+    assert(obj != NULL);
+    assert(ptr != NULL);
+    zylib_private_pool_free((zylib_private_pool_t *)obj, ptr);
+}
+
+void zylib_pool_free_remote(zylib_pool_t *obj, void **ptr)
+{
+    assert(obj != NULL);
+    assert(ptr != NULL);
+    zylib_private_pool_free_remote((zylib_private_pool_t *)obj, ptr);
+}
+
+size_t zylib_pool_size(const zylib_pool_t *obj)
+{
+    assert(obj != NULL);
+    return zylib_private_pool_peek_size((const zylib_private_pool_t *)obj);
+}
+
+_Bool zylib_pool_trim(zylib_pool_t *obj)
+{
+    assert(obj != NULL);
+    return zylib_private_pool_trim((zylib_private_pool_t *)obj);
+}
+
+void zylib_pool_set_decay(zylib_pool_t *obj, uint64_t milliseconds)
+{
+    assert(obj != NULL);
+    zylib_private_pool_set_decay((zylib_private_pool_t *)obj, milliseconds);
+}
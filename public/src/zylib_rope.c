@@ -0,0 +1,61 @@
+/*
+ * Copyright 2023 Alexandre Fernandez <alex@fernandezfamily.email>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "zylib_rope.h"
+#include "zylib_private_rope.h"
+#include <assert.h>
+
+_Bool zylib_rope_construct(zylib_rope_t **obj, const zylib_allocator_t *allocator, size_t chunk_size)
+{
+    assert(obj != NULL);
+    assert(allocator != NULL);
+    return zylib_private_rope_construct((zylib_private_rope_t **)obj, (const zylib_private_allocator_t *)allocator,
+                                        chunk_size);
+}
+
+void zylib_rope_destruct(zylib_rope_t **obj)
+{
+    assert(obj != NULL);
+    zylib_private_rope_destruct((zylib_private_rope_t **)obj);
+}
+
+_Bool zylib_rope_append(zylib_rope_t *obj, uint64_t size, const void *data)
+{
+    assert(obj != NULL);
+    assert(data != NULL);
+    return zylib_private_rope_append((zylib_private_rope_t *)obj, size, data);
+}
+
+_Bool zylib_rope_next(const zylib_rope_t *obj, const void **iterator, uint64_t *size, const void **data)
+{
+    assert(obj != NULL);
+    assert(iterator != NULL);
+    assert(size != NULL);
+    assert(data != NULL);
+    return zylib_private_rope_next((const zylib_private_rope_t *)obj, iterator, size, data);
+}
+
+_Bool zylib_rope_flatten(zylib_rope_t *obj, const void **data)
+{
+    assert(obj != NULL);
+    assert(data != NULL);
+    return zylib_private_rope_flatten((zylib_private_rope_t *)obj, data);
+}
+
+uint64_t zylib_rope_size(const zylib_rope_t *obj)
+{
+    assert(obj != NULL);
+    return zylib_private_rope_peek_size((const zylib_private_rope_t *)obj);
+}
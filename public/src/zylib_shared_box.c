@@ -0,0 +1,62 @@
+/*
+ * Copyright 2023 Alexandre Fernandez <alex@fernandezfamily.email>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "zylib_shared_box.h"
+#include "zylib_private_shared_box.h"
+#include <assert.h>
+
+_Bool zylib_shared_box_construct(zylib_shared_box_t **obj, const zylib_allocator_t *allocator, uint64_t size,
+                                 const void *data)
+{
+    assert(obj != NULL);
+    assert(allocator != NULL);
+    assert(size > 0);
+    assert(data != NULL);
+    return zylib_private_shared_box_construct((zylib_private_shared_box_t **)obj,
+                                              (const zylib_private_allocator_t *)allocator, size, data);
+}
+
+_Bool zylib_shared_box_slice(zylib_shared_box_t **obj, zylib_shared_box_t *box, uint64_t offset, uint64_t size)
+{
+    assert(obj != NULL);
+    assert(box != NULL);
+    assert(size > 0);
+    return zylib_private_shared_box_slice((zylib_private_shared_box_t **)obj, (zylib_private_shared_box_t *)box,
+                                          offset, size);
+}
+
+void zylib_shared_box_acquire(zylib_shared_box_t *obj)
+{
+    assert(obj != NULL);
+    zylib_private_shared_box_acquire((zylib_private_shared_box_t *)obj);
+}
+
+void zylib_shared_box_destruct(zylib_shared_box_t **obj)
+{
+    assert(obj != NULL);
+    zylib_private_shared_box_destruct((zylib_private_shared_box_t **)obj);
+}
+
+uint64_t zylib_shared_box_size(const zylib_shared_box_t *obj)
+{
+    assert(obj != NULL);
+    return zylib_private_shared_box_peek_size((const zylib_private_shared_box_t *)obj);
+}
+
+const void *zylib_shared_box_data(const zylib_shared_box_t *obj)
+{
+    assert(obj != NULL);
+    return zylib_private_shared_box_peek_data((const zylib_private_shared_box_t *)obj);
+}
@@ -14,13 +14,34 @@
  * limitations under the License.
  */
 #include "zylib_allocator.h"
+#include "zylib_dequeue.h"
 #include "zylib_logger.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <threads.h>
 
 #define PRINT_ERROR(format) ZYLIB_LOGGER_ERROR(log, format)
 
+#define THREAD_N (4U)
+#define THREAD_ALLOCATION_N (1000U)
+
+typedef struct accounting_s
+{
+    size_t live;
+    size_t calloc_count;
+    _Bool destructed;
+} accounting_t;
+
+typedef struct thread_test_s
+{
+    const zylib_allocator_t *allocator;
+    void *ptr[THREAD_ALLOCATION_N];
+    _Bool r;
+} thread_test_t;
+
+typedef _Bool (*zylib_allocator_construct_decorator_t)(zylib_allocator_t **, const zylib_allocator_t *);
+
 static zylib_allocator_t *allocator = NULL;
 static zylib_logger_t *log = NULL;
 
@@ -30,9 +51,49 @@ static inline _Bool logger_filter(zylib_logger_severity_t severity)
     return 1;
 }
 
+static void *accounting_malloc(void *context, size_t size)
+{
+    ((accounting_t *)context)->live += size;
+    return malloc(size);
+}
+
+static void *accounting_calloc(void *context, size_t size)
+{
+    ++((accounting_t *)context)->calloc_count;
+    ((accounting_t *)context)->live += size;
+    return calloc(1, size);
+}
+
+static void *accounting_realloc(void *context, void *ptr, size_t old_size, size_t size)
+{
+    ((accounting_t *)context)->live += size - old_size;
+    return realloc(ptr, size);
+}
+
+static void accounting_free(void *context, void *ptr, size_t size)
+{
+    ((accounting_t *)context)->live -= size;
+    free(ptr);
+}
+
+static void accounting_destruct(void *context)
+{
+    ((accounting_t *)context)->destructed = 1;
+}
+
 static inline _Bool test_region(void *ptr, size_t size, int chr);
 static inline _Bool test_malloc_free(size_t m_size);
 static inline _Bool test_malloc_realloc_free(size_t m_size, size_t r_size);
+static inline _Bool test_arena(size_t block_size);
+static inline _Bool test_context(size_t size);
+static inline _Bool test_aligned_malloc_free(const zylib_allocator_t *obj, size_t size);
+static inline _Bool test_thread_cache(zylib_allocator_construct_decorator_t construct);
+static inline _Bool test_stats();
+static inline _Bool test_mmap(unsigned flags);
+static inline _Bool test_size_class();
+static inline _Bool test_profiler();
+static inline _Bool test_budget();
+static inline _Bool test_trim();
 
 int main()
 {
@@ -72,6 +133,69 @@ int main()
         goto error;
     }
 
+    if (!test_arena((size_t)(rand() % 100 + 100)))
+    {
+        PRINT_ERROR("test_arena() failed");
+        goto error;
+    }
+
+    if (!test_context((size_t)(rand() % 100 + 100)))
+    {
+        PRINT_ERROR("test_context() failed");
+        goto error;
+    }
+
+    if (!test_aligned_malloc_free(allocator, (size_t)(rand() % 100 + 100)))
+    {
+        PRINT_ERROR("test_aligned_malloc_free() failed");
+        goto error;
+    }
+
+    if (!test_thread_cache(zylib_allocator_construct_thread_cache) ||
+        !test_thread_cache(zylib_allocator_construct_per_cpu))
+    {
+        PRINT_ERROR("test_thread_cache() failed");
+        goto error;
+    }
+
+    if (!test_stats())
+    {
+        PRINT_ERROR("test_stats() failed");
+        goto error;
+    }
+
+    if (!test_mmap(0) || !test_mmap(ZYLIB_ALLOCATOR_MMAP_HUGETLB | ZYLIB_ALLOCATOR_MMAP_POPULATE) ||
+        !test_mmap(ZYLIB_ALLOCATOR_MMAP_TRANSPARENT_HUGEPAGE | ZYLIB_ALLOCATOR_MMAP_POPULATE) ||
+        !test_mmap(ZYLIB_ALLOCATOR_MMAP_REMAP) || !test_mmap(ZYLIB_ALLOCATOR_MMAP_HUGETLB | ZYLIB_ALLOCATOR_MMAP_REMAP))
+    {
+        PRINT_ERROR("test_mmap() failed");
+        goto error;
+    }
+
+    if (!test_size_class())
+    {
+        PRINT_ERROR("test_size_class() failed");
+        goto error;
+    }
+
+    if (!test_profiler())
+    {
+        PRINT_ERROR("test_profiler() failed");
+        goto error;
+    }
+
+    if (!test_budget())
+    {
+        PRINT_ERROR("test_budget() failed");
+        goto error;
+    }
+
+    if (!test_trim())
+    {
+        PRINT_ERROR("test_trim() failed");
+        goto error;
+    }
+
     r = EXIT_SUCCESS;
 error:
     if (log != NULL)
@@ -149,22 +273,929 @@ error:
     return r;
 }
 
-_Bool test_region(void *ptr, size_t size, int chr)
+_Bool test_arena(size_t block_size)
 {
     _Bool r = 0;
+    zylib_allocator_t *arena = NULL;
+    void *ptr[8] = {NULL};
+    void *first = NULL;
 
-    memset(ptr, chr, size);
+    if (!zylib_allocator_construct_arena(&arena, block_size, allocator))
+    {
+        PRINT_ERROR("zylib_allocator_construct_arena() failed");
+        goto error;
+    }
+
+    for (size_t i = 0; i < sizeof(ptr) / sizeof(void *); ++i)
+    {
+        /* Every other request exceeds the block size */
+        size_t size = i % 2 == 0 ? i + 1 : block_size * 2;
+
+        if (!zylib_allocator_malloc(arena, size, &ptr[i]))
+        {
+            PRINT_ERROR("zylib_allocator_malloc() failed");
+            goto error;
+        }
+
+        if ((uintptr_t)ptr[i] % _Alignof(max_align_t) != 0)
+        {
+            PRINT_ERROR("zylib_allocator_malloc() failed");
+            goto error;
+        }
+
+        if (!test_region(ptr[i], size, (int)i))
+        {
+            PRINT_ERROR("test_region() failed");
+            goto error;
+        }
+    }
+    first = ptr[0];
+
+    for (size_t i = 0; i < sizeof(ptr) / sizeof(void *); i += 2)
+    {
+        if (((uint8_t *)ptr[i])[0] != i)
+        {
+            PRINT_ERROR("zylib_allocator_malloc() failed");
+            goto error;
+        }
+    }
+
+    if (!zylib_allocator_realloc(arena, block_size * 3, &ptr[0]) || ((uint8_t *)ptr[0])[0] != 0)
+    {
+        PRINT_ERROR("zylib_allocator_realloc() failed");
+        goto error;
+    }
+
+    zylib_allocator_free(arena, &ptr[0]);
+
+    if (!test_aligned_malloc_free(arena, block_size))
+    {
+        PRINT_ERROR("test_aligned_malloc_free() failed");
+        goto error;
+    }
+
+    if (!zylib_allocator_arena_reset(arena) || zylib_allocator_arena_reset(allocator))
+    {
+        PRINT_ERROR("zylib_allocator_arena_reset() failed");
+        goto error;
+    }
+
+    if (!zylib_allocator_malloc(arena, 1, &ptr[0]) || ptr[0] != first ||
+        !zylib_allocator_malloc(arena, block_size * 3, &ptr[1]) || !test_region(ptr[1], block_size * 3, 0))
+    {
+        PRINT_ERROR("zylib_allocator_malloc() failed");
+        goto error;
+    }
+
+    /* Growing an allocation that is not the most recent one copies it within its block, leaving its neighbour intact */
+    if (!zylib_allocator_arena_reset(arena) || !zylib_allocator_malloc(arena, block_size / 4, &ptr[0]) ||
+        !test_region(ptr[0], block_size / 4, 1) || !zylib_allocator_malloc(arena, 16, &ptr[1]) ||
+        !test_region(ptr[1], 16, 2) || !zylib_allocator_realloc(arena, block_size / 2, &ptr[0]))
+    {
+        PRINT_ERROR("zylib_allocator_realloc() failed");
+        goto error;
+    }
+    for (size_t i = 0; i < block_size / 4; ++i)
+    {
+        if (((uint8_t *)ptr[0])[i] != 1 || (i < 16 && ((uint8_t *)ptr[1])[i] != 2))
+        {
+            PRINT_ERROR("zylib_allocator_realloc() failed");
+            goto error;
+        }
+    }
+
+    r = 1;
+error:
+    if (arena != NULL)
+    {
+        zylib_allocator_destruct(&arena);
+    }
+    return r;
+}
+
+_Bool test_context(size_t size)
+{
+    _Bool r = 0;
+    const zylib_allocator_vtable_t vtable = {.malloc = accounting_malloc,
+                                             .calloc = accounting_calloc,
+                                             .realloc = accounting_realloc,
+                                             .free = accounting_free,
+                                             .destruct = accounting_destruct};
+    accounting_t accounting = {0};
+    zylib_allocator_t *context_allocator = NULL;
+    zylib_dequeue_t *context_dequeue = NULL;
+    void *ptr = NULL;
+
+    if (!zylib_allocator_construct_context(&context_allocator, &vtable, &accounting))
+    {
+        PRINT_ERROR("zylib_allocator_construct_context() failed");
+        goto error;
+    }
+
+    if (!zylib_allocator_calloc(context_allocator, size, &ptr) || accounting.calloc_count != 1)
+    {
+        PRINT_ERROR("zylib_allocator_calloc() failed");
+        goto error;
+    }
 
     for (size_t i = 0; i < size; ++i)
     {
-        if (((uint8_t *)ptr)[i] != chr)
+        if (((uint8_t *)ptr)[i] != 0)
         {
-            PRINT_ERROR("memset() failed");
+            PRINT_ERROR("zylib_allocator_calloc() failed");
+            goto error;
+        }
+    }
+
+    if (!zylib_allocator_realloc_sized(context_allocator, size, size * 2, &ptr) ||
+        !test_region(ptr, size * 2, rand() % 255))
+    {
+        PRINT_ERROR("zylib_allocator_realloc_sized() failed");
+        goto error;
+    }
+
+    zylib_allocator_free_sized(context_allocator, size * 2, &ptr);
+
+    if (!test_aligned_malloc_free(context_allocator, size))
+    {
+        PRINT_ERROR("test_aligned_malloc_free() failed");
+        goto error;
+    }
+
+    if (!zylib_dequeue_construct(&context_dequeue, context_allocator))
+    {
+        PRINT_ERROR("zylib_dequeue_construct() failed");
+        goto error;
+    }
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        if (!zylib_dequeue_push_last(context_dequeue, sizeof(i), &i))
+        {
+            PRINT_ERROR("zylib_dequeue_push_last() failed");
+            goto error;
+        }
+    }
+
+    zylib_dequeue_destruct(&context_dequeue);
+    zylib_allocator_destruct(&context_allocator);
+
+    /* Every sized deallocation must balance its allocation */
+    if (accounting.live != 0 || !accounting.destructed)
+    {
+        PRINT_ERROR("zylib_allocator_destruct() failed");
+        goto error;
+    }
+
+    r = 1;
+error:
+    if (ptr != NULL)
+    {
+        zylib_allocator_free_sized(context_allocator, size * 2, &ptr);
+    }
+    if (context_dequeue != NULL)
+    {
+        zylib_dequeue_destruct(&context_dequeue);
+    }
+    if (context_allocator != NULL)
+    {
+        zylib_allocator_destruct(&context_allocator);
+    }
+    return r;
+}
+
+_Bool test_aligned_malloc_free(const zylib_allocator_t *obj, size_t size)
+{
+    _Bool r = 0;
+    const size_t alignment[] = {1, 8, 64, 4096};
+    void *ptr[sizeof(alignment) / sizeof(size_t)] = {NULL};
+
+    for (size_t i = 0; i < sizeof(alignment) / sizeof(size_t); ++i)
+    {
+        if (!zylib_allocator_aligned_malloc(obj, alignment[i], size, &ptr[i]))
+        {
+            PRINT_ERROR("zylib_allocator_aligned_malloc() failed");
+            goto error;
+        }
+
+        if ((uintptr_t)ptr[i] % alignment[i] != 0)
+        {
+            PRINT_ERROR("zylib_allocator_aligned_malloc() failed");
+            goto error;
+        }
+
+        if (!test_region(ptr[i], size, (int)i))
+        {
+            PRINT_ERROR("test_region() failed");
             goto error;
         }
     }
 
     r = 1;
 error:
+    for (size_t i = 0; i < sizeof(alignment) / sizeof(size_t); ++i)
+    {
+        if (ptr[i] != NULL)
+        {
+            zylib_allocator_aligned_free(obj, alignment[i], size, &ptr[i]);
+        }
+    }
+    return r;
+}
+
+static inline size_t thread_test_size(size_t i)
+{
+    return i * 37 % 2048 + 1;
+}
+
+/*
+ * Allocate every region, and free every other one; the rest are freed by the main thread
+ */
+static int thread_test_worker(void *arg)
+{
+    thread_test_t *const test = arg;
+
+    for (size_t i = 0; i < THREAD_ALLOCATION_N; ++i)
+    {
+        if (!zylib_allocator_malloc(test->allocator, thread_test_size(i), &test->ptr[i]))
+        {
+            return 0;
+        }
+        memset(test->ptr[i], (int)(i % 256), thread_test_size(i));
+    }
+
+    for (size_t i = 0; i < THREAD_ALLOCATION_N; i += 2)
+    {
+        zylib_allocator_free(test->allocator, &test->ptr[i]);
+    }
+
+    test->r = 1;
+    return 0;
+}
+
+_Bool test_thread_cache(zylib_allocator_construct_decorator_t construct)
+{
+    _Bool r = 0;
+    zylib_allocator_t *cache = NULL;
+    thread_test_t *test = NULL;
+    thrd_t thread[THREAD_N];
+    void *ptr = NULL;
+
+    if (!construct(&cache, allocator))
+    {
+        PRINT_ERROR("construct() failed");
+        goto error;
+    }
+
+    if (!zylib_allocator_calloc(allocator, sizeof(thread_test_t) * THREAD_N, (void **)&test))
+    {
+        PRINT_ERROR("zylib_allocator_calloc() failed");
+        goto error;
+    }
+
+    /* The second round adopts the caches left behind by the first */
+    for (size_t round = 0; round < 2; ++round)
+    {
+        for (size_t i = 0; i < THREAD_N; ++i)
+        {
+            test[i].allocator = cache;
+            test[i].r = 0;
+            if (thrd_create(&thread[i], thread_test_worker, &test[i]) != thrd_success)
+            {
+                PRINT_ERROR("thrd_create() failed");
+                goto error;
+            }
+        }
+
+        for (size_t i = 0; i < THREAD_N; ++i)
+        {
+            thrd_join(thread[i], NULL);
+            if (!test[i].r)
+            {
+                PRINT_ERROR("zylib_allocator_malloc() failed");
+                goto error;
+            }
+        }
+
+        for (size_t i = 0; i < THREAD_N; ++i)
+        {
+            for (size_t j = 1; j < THREAD_ALLOCATION_N; j += 2)
+            {
+                if (((const uint8_t *)test[i].ptr[j])[thread_test_size(j) - 1] != j % 256)
+                {
+                    PRINT_ERROR("zylib_allocator_malloc() failed");
+                    goto error;
+                }
+                zylib_allocator_free(cache, &test[i].ptr[j]);
+            }
+        }
+    }
+
+    if (!zylib_allocator_malloc(cache, 10, &ptr) || !test_region(ptr, 10, 1) ||
+        !zylib_allocator_realloc(cache, 16, &ptr) || ((const uint8_t *)ptr)[9] != 1 ||
+        !zylib_allocator_realloc(cache, 4096, &ptr) || ((const uint8_t *)ptr)[9] != 1 ||
+        !zylib_allocator_realloc(cache, 8192, &ptr) || !test_region(ptr, 8192, 2))
+    {
+        PRINT_ERROR("zylib_allocator_realloc() failed");
+        goto error;
+    }
+
+    r = 1;
+error:
+    if (ptr != NULL)
+    {
+        zylib_allocator_free(cache, &ptr);
+    }
+    if (test != NULL)
+    {
+        zylib_allocator_free(allocator, (void **)&test);
+    }
+    if (cache != NULL)
+    {
+        zylib_allocator_destruct(&cache);
+    }
+    return r;
+}
+
+_Bool test_region(void *ptr, size_t size, int chr)
+{
+    _Bool r = 0;
+
+    memset(ptr, chr, size);
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        if (((uint8_t *)ptr)[i] != chr)
+        {
+            PRINT_ERROR("memset() failed");
+            goto error;
+        }
+    }
+
+    r = 1;
+error:
+    return r;
+}
+
+_Bool test_stats()
+{
+    _Bool r = 0;
+    zylib_allocator_t *stats = NULL;
+    zylib_allocator_stats_t snapshot;
+    void *ptr[3] = {NULL, NULL, NULL};
+
+    if (!zylib_allocator_construct_stats(&stats, allocator))
+    {
+        PRINT_ERROR("zylib_allocator_construct_stats() failed");
+        goto error;
+    }
+
+    if (zylib_allocator_stats(allocator, &snapshot))
+    {
+        PRINT_ERROR("zylib_allocator_stats() failed");
+        goto error;
+    }
+
+    if (!zylib_allocator_malloc(stats, 100, &ptr[0]) || !test_region(ptr[0], 100, 1) ||
+        !zylib_allocator_malloc(stats, 3, &ptr[1]) || !zylib_allocator_realloc(stats, 300, &ptr[0]) ||
+        ((const uint8_t *)ptr[0])[99] != 1 || !zylib_allocator_malloc(stats, 128 * 1024, &ptr[2]))
+    {
+        PRINT_ERROR("zylib_allocator_malloc() failed");
+        goto error;
+    }
+    zylib_allocator_free(stats, &ptr[1]);
+    zylib_allocator_free_sized(stats, 128 * 1024, &ptr[2]);
+
+    if (!zylib_allocator_stats(stats, &snapshot) || snapshot.allocation_count != 4 || snapshot.free_count != 3 ||
+        snapshot.live_bytes != 300 || snapshot.peak_bytes < 128 * 1024 || snapshot.histogram[2] != 1 ||
+        snapshot.histogram[7] != 1 || snapshot.histogram[9] != 1 || snapshot.histogram[17] != 1)
+    {
+        PRINT_ERROR("zylib_allocator_stats() failed");
+        goto error;
+    }
+
+    zylib_allocator_free(stats, &ptr[0]);
+    if (!zylib_allocator_stats(stats, &snapshot) || snapshot.live_bytes != 0)
+    {
+        PRINT_ERROR("zylib_allocator_stats() failed");
+        goto error;
+    }
+
+    r = 1;
+error:
+    for (size_t i = 0; i < 3; ++i)
+    {
+        if (ptr[i] != NULL)
+        {
+            zylib_allocator_free(stats, &ptr[i]);
+        }
+    }
+    if (stats != NULL)
+    {
+        zylib_allocator_destruct(&stats);
+    }
+    return r;
+}
+
+_Bool test_mmap(unsigned flags)
+{
+    static const size_t threshold = 64 * 1024;
+    _Bool r = 0;
+    zylib_allocator_t *mapping = NULL;
+    void *ptr = NULL;
+
+    if (!zylib_allocator_construct_mmap(&mapping, threshold, flags, allocator))
+    {
+        PRINT_ERROR("zylib_allocator_construct_mmap() failed");
+        goto error;
+    }
+
+    if (!zylib_allocator_malloc(mapping, 100, &ptr) || !test_region(ptr, 100, 1) ||
+        !zylib_allocator_realloc(mapping, 2 * threshold, &ptr) || ((const uint8_t *)ptr)[99] != 1 ||
+        !test_region(ptr, 2 * threshold, 2) || !zylib_allocator_realloc(mapping, 32 * threshold, &ptr) ||
+        ((const uint8_t *)ptr)[2 * threshold - 1] != 2 || !zylib_allocator_realloc(mapping, 100, &ptr) ||
+        ((const uint8_t *)ptr)[99] != 2)
+    {
+        PRINT_ERROR("zylib_allocator_realloc() failed");
+        goto error;
+    }
+    zylib_allocator_free(mapping, &ptr);
+
+    if (!zylib_allocator_calloc(mapping, 4 * threshold, &ptr))
+    {
+        PRINT_ERROR("zylib_allocator_calloc() failed");
+        goto error;
+    }
+    for (size_t i = 0; i < 4 * threshold; ++i)
+    {
+        if (((const uint8_t *)ptr)[i] != 0)
+        {
+            PRINT_ERROR("zylib_allocator_calloc() failed");
+            goto error;
+        }
+    }
+
+    r = 1;
+error:
+    if (ptr != NULL)
+    {
+        zylib_allocator_free(mapping, &ptr);
+    }
+    if (mapping != NULL)
+    {
+        zylib_allocator_destruct(&mapping);
+    }
+    return r;
+}
+
+#define SIZE_CLASS_ALLOCATION_N (4096U)
+
+static inline size_t size_class_test_size(size_t i)
+{
+    return i * 13 % 10000 + 1;
+}
+
+_Bool test_size_class()
+{
+    _Bool r = 0;
+    zylib_allocator_t *size_class = NULL;
+    zylib_dequeue_t *dequeue = NULL;
+    void **ptr = NULL;
+
+    if (!zylib_allocator_construct_size_class(&size_class, allocator))
+    {
+        PRINT_ERROR("zylib_allocator_construct_size_class() failed");
+        goto error;
+    }
+
+    if (!zylib_allocator_calloc(allocator, sizeof(void *) * SIZE_CLASS_ALLOCATION_N, (void **)&ptr))
+    {
+        PRINT_ERROR("zylib_allocator_calloc() failed");
+        goto error;
+    }
+
+    /* Free every other region and allocate it again, so that regions are reused */
+    for (size_t round = 0; round < 2; ++round)
+    {
+        for (size_t i = round; i < SIZE_CLASS_ALLOCATION_N; i += round + 1)
+        {
+            if (!zylib_allocator_malloc(size_class, size_class_test_size(i), &ptr[i]))
+            {
+                PRINT_ERROR("zylib_allocator_malloc() failed");
+                goto error;
+            }
+            memset(ptr[i], (int)(i % 256), size_class_test_size(i));
+        }
+
+        for (size_t i = 1; round == 0 && i < SIZE_CLASS_ALLOCATION_N; i += 2)
+        {
+            zylib_allocator_free(size_class, &ptr[i]);
+        }
+    }
+
+    for (size_t i = 0; i < SIZE_CLASS_ALLOCATION_N; ++i)
+    {
+        const uint8_t *const region = ptr[i];
+        if (region[0] != i % 256 || region[size_class_test_size(i) - 1] != i % 256)
+        {
+            PRINT_ERROR("zylib_allocator_malloc() failed");
+            goto error;
+        }
+        if (i % 3 == 0 && (!zylib_allocator_realloc(size_class, size_class_test_size(i) * 2, &ptr[i]) ||
+                           ((const uint8_t *)ptr[i])[size_class_test_size(i) - 1] != i % 256))
+        {
+            PRINT_ERROR("zylib_allocator_realloc() failed");
+            goto error;
+        }
+        zylib_allocator_free(size_class, &ptr[i]);
+    }
+
+    if (!zylib_dequeue_construct(&dequeue, size_class))
+    {
+        PRINT_ERROR("zylib_dequeue_construct() failed");
+        goto error;
+    }
+
+    for (size_t i = 0; i < SIZE_CLASS_ALLOCATION_N; ++i)
+    {
+        if (!zylib_dequeue_push_last(dequeue, sizeof(i), &i))
+        {
+            PRINT_ERROR("zylib_dequeue_push_last() failed");
+            goto error;
+        }
+    }
+
+    r = 1;
+error:
+    if (dequeue != NULL)
+    {
+        zylib_dequeue_destruct(&dequeue);
+    }
+    for (size_t i = 0; ptr != NULL && i < SIZE_CLASS_ALLOCATION_N; ++i)
+    {
+        if (ptr[i] != NULL)
+        {
+            zylib_allocator_free(size_class, &ptr[i]);
+        }
+    }
+    if (ptr != NULL)
+    {
+        zylib_allocator_free(allocator, (void **)&ptr);
+    }
+    if (size_class != NULL)
+    {
+        zylib_allocator_destruct(&size_class);
+    }
+    return r;
+}
+
+#define PROFILER_ALLOCATION_N (64U)
+
+/*
+ * Read back a folded stack dump; return the number of stacks and the sum of their bytes
+ */
+static _Bool profiler_test_read(const zylib_allocator_t *profiler, size_t *stacks, size_t *bytes)
+{
+    _Bool r = 0;
+    FILE *stream = tmpfile();
+    char line[4096];
+
+    *stacks = 0;
+    *bytes = 0;
+    if (stream == NULL || !zylib_allocator_profiler_dump(profiler, stream))
+    {
+        goto error;
+    }
+
+    rewind(stream);
+    while (fgets(line, sizeof(line), stream) != NULL)
+    {
+        const char *const count = strrchr(line, ' ');
+        if (count == NULL || strncmp(line, "0x", 2) != 0)
+        {
+            goto error;
+        }
+        ++*stacks;
+        *bytes += (size_t)strtoull(count + 1, NULL, 10);
+    }
+
+    r = 1;
+error:
+    if (stream != NULL)
+    {
+        fclose(stream);
+    }
+    return r;
+}
+
+_Bool test_profiler()
+{
+    _Bool r = 0;
+    zylib_allocator_t *profiler = NULL;
+    void *ptr[PROFILER_ALLOCATION_N] = {NULL};
+    size_t stacks;
+    size_t bytes;
+
+    /* Sampling every allocation accounts every live byte, to the allocation loop and to the reallocation */
+    if (!zylib_allocator_construct_profiler(&profiler, 0, allocator))
+    {
+        PRINT_ERROR("zylib_allocator_construct_profiler() failed");
+        goto error;
+    }
+
+    for (size_t i = 0; i < PROFILER_ALLOCATION_N; ++i)
+    {
+        if (!zylib_allocator_malloc(profiler, 100, &ptr[i]) || !test_region(ptr[i], 100, 1))
+        {
+            PRINT_ERROR("zylib_allocator_malloc() failed");
+            goto error;
+        }
+    }
+
+    if (!zylib_allocator_realloc(profiler, 200, &ptr[0]) || ((const uint8_t *)ptr[0])[99] != 1 ||
+        !profiler_test_read(profiler, &stacks, &bytes) || stacks != 2 || bytes != (PROFILER_ALLOCATION_N + 1) * 100)
+    {
+        PRINT_ERROR("zylib_allocator_profiler_dump() failed");
+        goto error;
+    }
+
+    for (size_t i = 0; i < PROFILER_ALLOCATION_N; ++i)
+    {
+        zylib_allocator_free(profiler, &ptr[i]);
+    }
+
+    if (!profiler_test_read(profiler, &stacks, &bytes) || stacks != 0 ||
+        zylib_allocator_profiler_dump(allocator, stderr))
+    {
+        PRINT_ERROR("zylib_allocator_profiler_dump() failed");
+        goto error;
+    }
+    zylib_allocator_destruct(&profiler);
+
+    /* Sampled estimates stand for at least the sampling rate */
+    if (!zylib_allocator_construct_profiler(&profiler, 1024, allocator))
+    {
+        PRINT_ERROR("zylib_allocator_construct_profiler() failed");
+        goto error;
+    }
+
+    for (size_t i = 0; i < PROFILER_ALLOCATION_N; ++i)
+    {
+        if (!zylib_allocator_malloc(profiler, 100, &ptr[i]))
+        {
+            PRINT_ERROR("zylib_allocator_malloc() failed");
+            goto error;
+        }
+    }
+
+    if (!profiler_test_read(profiler, &stacks, &bytes) || stacks == 0 || bytes % 1024 != 0)
+    {
+        PRINT_ERROR("zylib_allocator_profiler_dump() failed");
+        goto error;
+    }
+
+    r = 1;
+error:
+    for (size_t i = 0; i < PROFILER_ALLOCATION_N; ++i)
+    {
+        if (ptr[i] != NULL)
+        {
+            zylib_allocator_free(profiler, &ptr[i]);
+        }
+    }
+    if (profiler != NULL)
+    {
+        zylib_allocator_destruct(&profiler);
+    }
+    return r;
+}
+
+static void budget_test_pressure(void *context, size_t usage, size_t soft_limit)
+{
+    if (usage >= soft_limit)
+    {
+        ++*(size_t *)context;
+    }
+}
+
+typedef struct budget_test_s
+{
+    const zylib_allocator_t *budget;
+    size_t size;
+    _Bool r;
+} budget_test_t;
+
+static int budget_test_worker(void *arg)
+{
+    budget_test_t *test = arg;
+    void *ptr = NULL;
+
+    test->r = zylib_allocator_malloc(test->budget, test->size, &ptr);
+    if (test->r)
+    {
+        zylib_allocator_free(test->budget, &ptr);
+    }
+    return 0;
+}
+
+_Bool test_budget()
+{
+    _Bool r = 0;
+    zylib_allocator_t *budget = NULL;
+    zylib_dequeue_t *dequeue = NULL;
+    size_t pressure = 0;
+    size_t i = 0;
+    void *ptr[3] = {NULL, NULL, NULL};
+    budget_test_t test = {.size = 880, .r = 0};
+    thrd_t thread;
+
+    if (!zylib_allocator_construct_budget(&budget, 1000, 2000, budget_test_pressure, &pressure, allocator))
+    {
+        PRINT_ERROR("zylib_allocator_construct_budget() failed");
+        goto error;
+    }
+
+    if (!zylib_allocator_malloc(budget, 500, &ptr[0]) || pressure != 0 ||
+        !zylib_allocator_malloc(budget, 600, &ptr[1]) || pressure != 1)
+    {
+        PRINT_ERROR("zylib_allocator_malloc() failed");
+        goto error;
+    }
+
+    /* Past the hard limit, allocations fail until memory is freed */
+    if (zylib_allocator_malloc(budget, 1000, &ptr[2]) || zylib_allocator_realloc(budget, 1600, &ptr[1]))
+    {
+        PRINT_ERROR("zylib_allocator_malloc() failed");
+        goto error;
+    }
+
+    /* Another thread fits in the budget only by taking back the bytes this one reserved */
+    test.budget = budget;
+    if (thrd_create(&thread, budget_test_worker, &test) != thrd_success)
+    {
+        PRINT_ERROR("thrd_create() failed");
+        goto error;
+    }
+    thrd_join(thread, NULL);
+    if (!test.r || pressure != 1)
+    {
+        PRINT_ERROR("zylib_allocator_malloc() failed");
+        goto error;
+    }
+    zylib_allocator_free(budget, &ptr[1]);
+
+    if (!zylib_allocator_malloc(budget, 1000, &ptr[2]) || pressure != 2)
+    {
+        PRINT_ERROR("zylib_allocator_malloc() failed");
+        goto error;
+    }
+    zylib_allocator_free(budget, &ptr[0]);
+    zylib_allocator_free(budget, &ptr[2]);
+
+    /* A dequeue degrades gracefully once the budget is exhausted */
+    if (!zylib_dequeue_construct(&dequeue, budget))
+    {
+        PRINT_ERROR("zylib_dequeue_construct() failed");
+        goto error;
+    }
+    while (zylib_dequeue_push_last(dequeue, sizeof(i), &i))
+    {
+        ++i;
+    }
+    if (i == 0 || i != zylib_dequeue_size(dequeue))
+    {
+        PRINT_ERROR("zylib_dequeue_push_last() failed");
+        goto error;
+    }
+
+    r = 1;
+error:
+    if (dequeue != NULL)
+    {
+        zylib_dequeue_destruct(&dequeue);
+    }
+    for (size_t j = 0; j < 3; ++j)
+    {
+        if (ptr[j] != NULL)
+        {
+            zylib_allocator_free(budget, &ptr[j]);
+        }
+    }
+    if (budget != NULL)
+    {
+        zylib_allocator_destruct(&budget);
+    }
+    return r;
+}
+
+#define TRIM_ALLOCATION_N (16U)
+
+static inline uint64_t trim_test_live_bytes(const zylib_allocator_t *stats)
+{
+    zylib_allocator_stats_t snapshot;
+    return zylib_allocator_stats(stats, &snapshot) ? snapshot.live_bytes : 0;
+}
+
+/*
+ * Fill an arena with blocks, then reset it
+ */
+static _Bool trim_test_fill(zylib_allocator_t *arena)
+{
+    for (size_t i = 0; i < TRIM_ALLOCATION_N; ++i)
+    {
+        void *ptr = NULL;
+        if (!zylib_allocator_malloc(arena, 4000, &ptr) || !test_region(ptr, 4000, (int)i))
+        {
+            return 0;
+        }
+    }
+    return zylib_allocator_arena_reset(arena);
+}
+
+_Bool test_trim()
+{
+    static const struct timespec period = {.tv_sec = 0, .tv_nsec = 60000000};
+    _Bool r = 0;
+    zylib_allocator_t *stats = NULL;
+    zylib_allocator_t *arena = NULL;
+    zylib_allocator_t *size_class = NULL;
+    uint64_t live_bytes;
+    void *ptr = NULL;
+
+    if (!zylib_allocator_construct_stats(&stats, allocator) ||
+        !zylib_allocator_construct_arena(&arena, 4096, stats) ||
+        !zylib_allocator_construct_size_class(&size_class, stats))
+    {
+        PRINT_ERROR("zylib_allocator_construct_arena() failed");
+        goto error;
+    }
+
+    if (zylib_allocator_trim(allocator) || zylib_allocator_set_decay(stats, 1))
+    {
+        PRINT_ERROR("zylib_allocator_trim() failed");
+        goto error;
+    }
+
+    /* Trimming releases every block past the current one */
+    if (!trim_test_fill(arena))
+    {
+        PRINT_ERROR("zylib_allocator_malloc() failed");
+        goto error;
+    }
+    live_bytes = trim_test_live_bytes(stats);
+    if (!zylib_allocator_trim(arena) || trim_test_live_bytes(stats) >= live_bytes || !trim_test_fill(arena))
+    {
+        PRINT_ERROR("zylib_allocator_trim() failed");
+        goto error;
+    }
+
+    /* Decay releases the blocks left unused for a whole period */
+    if (!zylib_allocator_set_decay(arena, 50) || !trim_test_fill(arena))
+    {
+        PRINT_ERROR("zylib_allocator_set_decay() failed");
+        goto error;
+    }
+    live_bytes = trim_test_live_bytes(stats);
+    if (thrd_sleep(&period, NULL) != 0 ||
+        !zylib_allocator_arena_reset(arena) || trim_test_live_bytes(stats) != live_bytes ||
+        thrd_sleep(&period, NULL) != 0 || !zylib_allocator_arena_reset(arena) ||
+        trim_test_live_bytes(stats) >= live_bytes)
+    {
+        PRINT_ERROR("zylib_allocator_set_decay() failed");
+        goto error;
+    }
+
+    /* Trimmed pages remain usable */
+    if (!zylib_allocator_malloc(size_class, 100, &ptr) || !zylib_allocator_set_decay(size_class, 1))
+    {
+        PRINT_ERROR("zylib_allocator_malloc() failed");
+        goto error;
+    }
+    zylib_allocator_free(size_class, &ptr);
+    if (!zylib_allocator_trim(size_class) || !zylib_allocator_malloc(size_class, 100, &ptr) ||
+        !test_region(ptr, 100, 1))
+    {
+        PRINT_ERROR("zylib_allocator_trim() failed");
+        goto error;
+    }
+
+    r = 1;
+error:
+    if (ptr != NULL)
+    {
+        zylib_allocator_free(size_class, &ptr);
+    }
+    if (size_class != NULL)
+    {
+        zylib_allocator_destruct(&size_class);
+    }
+    if (arena != NULL)
+    {
+        zylib_allocator_destruct(&arena);
+    }
+    if (stats != NULL)
+    {
+        zylib_allocator_destruct(&stats);
+    }
     return r;
 }
@@ -0,0 +1,199 @@
+/*
+ * Copyright 2023 Alexandre Fernandez <alex@fernandezfamily.email>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "zylib_buffer.h"
+#include "zylib_dequeue.h"
+#include "zylib_logger.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PRINT_ERROR(format) ZYLIB_LOGGER_ERROR(log, format)
+
+#define APPEND_N (10000U)
+
+static zylib_allocator_t *allocator = NULL;
+static zylib_logger_t *log = NULL;
+
+static inline _Bool logger_filter(zylib_logger_severity_t severity)
+{
+    (void)(severity);
+    return 1;
+}
+
+static inline _Bool test_buffer();
+
+int main()
+{
+    int r = EXIT_FAILURE;
+
+    if (!zylib_allocator_construct(&allocator, malloc, realloc, free))
+    {
+        fprintf(stderr, "zylib_allocator_construct() failed\n");
+        goto error;
+    }
+
+    if (!zylib_logger_construct(&log, allocator, stderr, ZYLIB_LOGGER_FORMAT_PLAINTEXT, logger_filter))
+    {
+        fprintf(stderr, "zylib_logger_construct() failed\n");
+        goto error;
+    }
+
+    /*
+     * TESTS
+     */
+
+    if (!test_buffer())
+    {
+        PRINT_ERROR("test_buffer() failed");
+        goto error;
+    }
+
+    r = EXIT_SUCCESS;
+error:
+    if (log != NULL)
+    {
+        zylib_logger_destruct(&log);
+    }
+    if (allocator != NULL)
+    {
+        zylib_allocator_destruct(&allocator);
+    }
+    return r;
+}
+
+_Bool test_buffer()
+{
+    _Bool r = 0;
+
+    size_t size = 0;
+    size_t capacity = 0;
+    size_t growth_n = 0;
+    void *data = NULL;
+    const void *detached = NULL;
+    const void *managed_data = NULL;
+    uint64_t managed_size = 0;
+
+    zylib_buffer_t *buffer = NULL;
+    zylib_dequeue_t *dequeue = NULL;
+
+    if (!zylib_buffer_construct(&buffer, allocator, 0) || zylib_buffer_size(buffer) != 0 ||
+        zylib_buffer_capacity(buffer) != 0 || zylib_buffer_data(buffer) != NULL)
+    {
+        PRINT_ERROR("zylib_buffer_construct() failed");
+        goto error;
+    }
+
+    /* The capacity grows geometrically, so it changes a logarithmic number of times */
+    for (uint32_t i = 0; i < APPEND_N; ++i)
+    {
+        if (!zylib_buffer_append(buffer, sizeof(i), &i))
+        {
+            PRINT_ERROR("zylib_buffer_append() failed");
+            goto error;
+        }
+        if (zylib_buffer_capacity(buffer) != capacity)
+        {
+            capacity = zylib_buffer_capacity(buffer);
+            ++growth_n;
+        }
+    }
+
+    if (zylib_buffer_size(buffer) != APPEND_N * sizeof(uint32_t) || growth_n > 16)
+    {
+        PRINT_ERROR("zylib_buffer_append() failed");
+        goto error;
+    }
+
+    for (uint32_t i = 0; i < APPEND_N; ++i)
+    {
+        uint32_t j;
+        memcpy(&j, &((const uint8_t *)zylib_buffer_data(buffer))[i * sizeof(j)], sizeof(j));
+        if (i != j)
+        {
+            PRINT_ERROR("zylib_buffer_data() failed");
+            goto error;
+        }
+    }
+
+    zylib_buffer_clear(buffer);
+    if (zylib_buffer_size(buffer) != 0 || zylib_buffer_capacity(buffer) != capacity)
+    {
+        PRINT_ERROR("zylib_buffer_clear() failed");
+        goto error;
+    }
+
+    if (!zylib_buffer_shrink_to_fit(buffer) || zylib_buffer_capacity(buffer) != 0)
+    {
+        PRINT_ERROR("zylib_buffer_shrink_to_fit() failed");
+        goto error;
+    }
+
+    if (!zylib_buffer_reserve(buffer, 10) || zylib_buffer_capacity(buffer) != 10 ||
+        !zylib_buffer_reserve(buffer, 5) || zylib_buffer_capacity(buffer) != 10)
+    {
+        PRINT_ERROR("zylib_buffer_reserve() failed");
+        goto error;
+    }
+
+    /* The first line fits in the reserved capacity and the second does not */
+    if (!zylib_buffer_append_format(buffer, "%s=%d;", "a", 1) ||
+        !zylib_buffer_append_format(buffer, "%s=%d;", "longer key", 12345) ||
+        strcmp(zylib_buffer_data(buffer), "a=1;longer key=12345;") != 0 ||
+        zylib_buffer_size(buffer) != strlen("a=1;longer key=12345;"))
+    {
+        PRINT_ERROR("zylib_buffer_append_format() failed");
+        goto error;
+    }
+
+    /* The finished memory region moves into a dequeue without being copied */
+    if (!zylib_buffer_detach(buffer, &size, &data) || size != strlen("a=1;longer key=12345;") ||
+        zylib_buffer_size(buffer) != 0 || zylib_buffer_capacity(buffer) != 0)
+    {
+        PRINT_ERROR("zylib_buffer_detach() failed");
+        goto error;
+    }
+
+    if (zylib_buffer_detach(buffer, &size, &data))
+    {
+        PRINT_ERROR("zylib_buffer_detach() failed");
+        goto error;
+    }
+
+    detached = data;
+    if (!zylib_dequeue_construct(&dequeue, allocator) || !zylib_dequeue_adopt_last(dequeue, size, &data) ||
+        !zylib_dequeue_peek_last(dequeue, &managed_size, &managed_data) || managed_data != detached ||
+        managed_size != size)
+    {
+        PRINT_ERROR("zylib_dequeue_adopt_last() failed");
+        goto error;
+    }
+
+    r = 1;
+error:
+    if (data != NULL)
+    {
+        zylib_allocator_free(allocator, &data);
+    }
+    if (dequeue != NULL)
+    {
+        zylib_dequeue_destruct(&dequeue);
+    }
+    if (buffer != NULL)
+    {
+        zylib_buffer_destruct(&buffer);
+    }
+    return r;
+}
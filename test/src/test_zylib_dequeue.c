@@ -26,6 +26,7 @@
 typedef _Bool (*zylib_dequeue_push_t)(zylib_dequeue_t *, uint64_t, const void *);
 typedef _Bool (*zylib_dequeue_peek_t)(const zylib_dequeue_t *, uint64_t *, const void **);
 typedef void (*zylib_dequeue_discard_t)(zylib_dequeue_t *);
+typedef _Bool (*zylib_dequeue_construct_t)(zylib_dequeue_t **, const zylib_allocator_t *);
 
 /*
  * Macros
@@ -40,6 +41,7 @@ typedef void (*zylib_dequeue_discard_t)(zylib_dequeue_t *);
 static zylib_logger_t *log = NULL;
 static zylib_allocator_t *allocator = NULL;
 static zylib_dequeue_t *dequeue = NULL;
+static size_t malloc_n = 0;
 
 /*
  * Static Function Declarations
@@ -51,6 +53,12 @@ static inline _Bool logger_filter(zylib_logger_severity_t severity)
     return 1;
 }
 
+static void *counting_malloc(size_t size)
+{
+    ++malloc_n;
+    return malloc(size);
+}
+
 /* Push, Peek */
 static inline _Bool test_push_peek(uint64_t before_size, zylib_dequeue_push_t push, zylib_dequeue_peek_t peek);
 
@@ -73,6 +81,27 @@ static inline _Bool test_loop_push_peek_clear_first();
 /* Loop: Push Last, Peek Last; Clear */
 static inline _Bool test_loop_push_peek_clear_last();
 
+/* Adopt First, Push Last; Release First, Release Last */
+static inline _Bool test_adopt_release();
+
+/* Loop: Push First, Push Last; At; Discard First; At; Clear */
+static inline _Bool test_push_at();
+
+/* Loop: Push First, Push Last; Cursor First, Next, Get; Cursor Last, Prev, Get; Clear */
+static inline _Bool test_cursor();
+
+/* Loop: Push First, Push Last; Loop: Discard First, Discard Last; Adopt */
+static inline _Bool test_packed();
+
+/* Push N Last, Push N First; At; Pop N First, Pop N Last; Push, Release, Discard */
+static inline _Bool test_fixed();
+
+/* Loop: Push Last, counting allocations; Discard First */
+static inline _Bool test_push_allocation_n();
+
+/* Construct; All Tests; Destruct */
+static inline _Bool test_dequeue(zylib_dequeue_construct_t construct);
+
 /*
  * Main
  */
@@ -93,49 +122,49 @@ int main()
         goto error;
     }
 
-    if (!zylib_dequeue_construct(&dequeue, allocator))
-    {
-        PRINT_ERROR("zylib_dequeue_construct() failed");
-        goto error;
-    }
-
     /*
      * TESTS
      */
 
-    if (!zylib_dequeue_is_empty(dequeue))
+    if (!test_dequeue(zylib_dequeue_construct))
     {
-        PRINT_ERROR("zylib_dequeue_is_empty() failed");
+        PRINT_ERROR("test_dequeue() failed");
         goto error;
     }
 
-    if (!test_push_peek_discard_first())
+    if (!test_dequeue(zylib_dequeue_construct_pooled))
     {
-        PRINT_ERROR("test_push_peek_discard_first() failed");
+        PRINT_ERROR("test_dequeue() failed");
         goto error;
     }
 
-    if (!test_push_peek_discard_last())
+    if (!test_dequeue(zylib_dequeue_construct_blocked))
     {
-        PRINT_ERROR("test_push_peek_discard_last() failed");
+        PRINT_ERROR("test_dequeue() failed");
         goto error;
     }
 
-    if (!test_loop_push_peek_clear_first())
+    if (!test_dequeue(zylib_dequeue_construct_packed))
     {
-        PRINT_ERROR("test_loop_push_peek_clear_first() failed");
+        PRINT_ERROR("test_dequeue() failed");
         goto error;
     }
 
-    if (!test_loop_push_peek_clear_last())
+    if (!test_packed())
     {
-        PRINT_ERROR("test_loop_push_peek_clear_last() failed");
+        PRINT_ERROR("test_packed() failed");
         goto error;
     }
 
-    if (!zylib_dequeue_is_empty(dequeue))
+    if (!test_fixed())
     {
-        PRINT_ERROR("zylib_dequeue_is_empty() failed");
+        PRINT_ERROR("test_fixed() failed");
+        goto error;
+    }
+
+    if (!test_push_allocation_n())
+    {
+        PRINT_ERROR("test_push_allocation_n() failed");
         goto error;
     }
 
@@ -165,7 +194,8 @@ _Bool test_push_peek(uint64_t before_size, zylib_dequeue_push_t push, zylib_dequ
     _Bool r = 0;
 
     void *ptr = NULL;
-    uint64_t ptr_size = 1;
+    /* Sizes grow with the dequeue so that both inline and boxed memory regions are covered */
+    uint64_t ptr_size = before_size + 1;
 
     const void *managed_ptr = NULL;
     uint64_t managed_ptr_size = 0;
@@ -176,7 +206,7 @@ _Bool test_push_peek(uint64_t before_size, zylib_dequeue_push_t push, zylib_dequ
         goto error;
     }
 
-    memset(ptr, 0, ptr_size);
+    memset(ptr, (int)before_size, ptr_size);
 
     if (!push(dequeue, ptr_size, ptr))
     {
@@ -273,3 +303,522 @@ _Bool test_loop_push_peek_clear_last()
 {
     return test_loop_push_peek_clear(zylib_dequeue_push_last, zylib_dequeue_peek_last);
 }
+
+_Bool test_adopt_release()
+{
+    _Bool r = 0;
+
+    void *ptr = NULL;
+    const void *adopted = NULL;
+    const uint8_t small[2] = {2, 2};
+    uint64_t size = 0;
+
+    if (!zylib_allocator_malloc(allocator, 100, &ptr))
+    {
+        PRINT_ERROR("zylib_allocator_malloc() failed");
+        goto error;
+    }
+
+    memset(ptr, 1, 100);
+    adopted = ptr;
+
+    if (!zylib_dequeue_adopt_first(dequeue, 100, &ptr) || ptr != NULL)
+    {
+        PRINT_ERROR("zylib_dequeue_adopt_first() failed");
+        goto error;
+    }
+
+    if (!zylib_dequeue_push_last(dequeue, sizeof(small), small))
+    {
+        PRINT_ERROR("zylib_dequeue_push_last() failed");
+        goto error;
+    }
+
+    /* The adopted memory region is handed back as is */
+    if (!zylib_dequeue_release_first(dequeue, &size, &ptr) || ptr != adopted || size != 100 ||
+        ((const uint8_t *)ptr)[99] != 1)
+    {
+        PRINT_ERROR("zylib_dequeue_release_first() failed");
+        goto error;
+    }
+    zylib_allocator_free(allocator, &ptr);
+
+    if (!zylib_dequeue_release_last(dequeue, &size, &ptr) || size != sizeof(small) ||
+        memcmp(ptr, small, sizeof(small)) != 0)
+    {
+        PRINT_ERROR("zylib_dequeue_release_last() failed");
+        goto error;
+    }
+    zylib_allocator_free(allocator, &ptr);
+
+    if (zylib_dequeue_release_first(dequeue, &size, &ptr) || !zylib_dequeue_is_empty(dequeue))
+    {
+        PRINT_ERROR("zylib_dequeue_release_first() failed");
+        goto error;
+    }
+
+    r = 1;
+error:
+    if (ptr != NULL)
+    {
+        zylib_allocator_free(allocator, &ptr);
+    }
+    return r;
+}
+
+_Bool test_push_at()
+{
+    _Bool r = 0;
+
+    uint8_t data[64];
+    /* Even values are pushed first and odd values last, so the order is 198, 196, ..., 0, 1, 3, ..., 199 */
+    uint8_t expected[200];
+    const void *managed_ptr = NULL;
+    uint64_t managed_ptr_size = 0;
+
+    for (uint8_t i = 0; i < sizeof(expected); ++i)
+    {
+        memset(data, i, sizeof(data));
+        if (!(i % 2 == 0 ? zylib_dequeue_push_first : zylib_dequeue_push_last)(dequeue, 1 + i % sizeof(data), data))
+        {
+            PRINT_ERROR("push() failed");
+            goto error;
+        }
+        expected[i % 2 == 0 ? 99 - i / 2 : 100 + i / 2] = i;
+    }
+
+    for (uint8_t discarded = 0; discarded <= 10; discarded += 10)
+    {
+        for (uint64_t i = 0; i < sizeof(expected) - discarded; ++i)
+        {
+            const uint8_t value = expected[discarded + i];
+            if (!zylib_dequeue_at(dequeue, i, &managed_ptr_size, &managed_ptr) ||
+                managed_ptr_size != 1 + value % sizeof(data) ||
+                ((const uint8_t *)managed_ptr)[value % sizeof(data)] != value)
+            {
+                PRINT_ERROR("zylib_dequeue_at() failed");
+                goto error;
+            }
+        }
+
+        if (zylib_dequeue_at(dequeue, sizeof(expected) - discarded, &managed_ptr_size, &managed_ptr) ||
+            managed_ptr != NULL)
+        {
+            PRINT_ERROR("zylib_dequeue_at() failed");
+            goto error;
+        }
+
+        for (uint8_t i = 0; i < 10; ++i)
+        {
+            zylib_dequeue_discard_first(dequeue);
+        }
+    }
+
+    zylib_dequeue_clear(dequeue);
+
+    r = 1;
+error:
+    return r;
+}
+
+_Bool test_cursor()
+{
+    _Bool r = 0;
+
+    uint8_t data[64];
+    zylib_dequeue_cursor_t cursor;
+    const void *managed_ptr = NULL;
+    uint64_t managed_ptr_size = 0;
+    uint64_t n = 0;
+
+    if (zylib_dequeue_cursor_first(dequeue, &cursor))
+    {
+        PRINT_ERROR("zylib_dequeue_cursor_first() failed");
+        goto error;
+    }
+
+    /* Even values are pushed first and odd values last, so the order is 198, 196, ..., 0, 1, 3, ..., 199 */
+    for (uint8_t i = 0; i < 200; ++i)
+    {
+        memset(data, i, sizeof(data));
+        if (!(i % 2 == 0 ? zylib_dequeue_push_first : zylib_dequeue_push_last)(dequeue, 1 + i % sizeof(data), data))
+        {
+            PRINT_ERROR("push() failed");
+            goto error;
+        }
+    }
+
+    if (!zylib_dequeue_cursor_first(dequeue, &cursor))
+    {
+        PRINT_ERROR("zylib_dequeue_cursor_first() failed");
+        goto error;
+    }
+    do
+    {
+        const uint8_t value = n < 100 ? 198 - 2 * n : 2 * (n - 100) + 1;
+        if (!zylib_dequeue_cursor_get(&cursor, &managed_ptr_size, &managed_ptr) ||
+            managed_ptr_size != 1 + value % sizeof(data) || ((const uint8_t *)managed_ptr)[0] != value)
+        {
+            PRINT_ERROR("zylib_dequeue_cursor_get() failed");
+            goto error;
+        }
+        ++n;
+    } while (zylib_dequeue_cursor_next(&cursor));
+
+    if (n != 200 || !zylib_dequeue_cursor_last(dequeue, &cursor))
+    {
+        PRINT_ERROR("zylib_dequeue_cursor_next() failed");
+        goto error;
+    }
+    do
+    {
+        const uint8_t value = --n < 100 ? 198 - 2 * n : 2 * (n - 100) + 1;
+        if (!zylib_dequeue_cursor_get(&cursor, &managed_ptr_size, &managed_ptr) ||
+            managed_ptr_size != 1 + value % sizeof(data) || ((const uint8_t *)managed_ptr)[0] != value)
+        {
+            PRINT_ERROR("zylib_dequeue_cursor_get() failed");
+            goto error;
+        }
+    } while (zylib_dequeue_cursor_prev(&cursor));
+
+    if (n != 0)
+    {
+        PRINT_ERROR("zylib_dequeue_cursor_prev() failed");
+        goto error;
+    }
+
+    zylib_dequeue_clear(dequeue);
+
+    r = 1;
+error:
+    return r;
+}
+
+_Bool test_packed()
+{
+    _Bool r = 0;
+
+    /* Enough records to span several chunks, including one larger than a chunk */
+    const uint32_t n = 10000;
+    uint8_t large[5000];
+    zylib_dequeue_cursor_t cursor;
+    void *ptr = NULL;
+    const void *managed_ptr = NULL;
+    uint64_t managed_ptr_size = 0;
+
+    if (!zylib_dequeue_construct_packed(&dequeue, allocator))
+    {
+        PRINT_ERROR("zylib_dequeue_construct_packed() failed");
+        goto error;
+    }
+
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        if (!(i % 2 == 0 ? zylib_dequeue_push_first : zylib_dequeue_push_last)(dequeue, sizeof(i), &i))
+        {
+            PRINT_ERROR("push() failed");
+            goto error;
+        }
+    }
+
+    memset(large, 1, sizeof(large));
+    if (!zylib_dequeue_push_last(dequeue, sizeof(large), large) ||
+        !zylib_dequeue_peek_last(dequeue, &managed_ptr_size, &managed_ptr) || managed_ptr_size != sizeof(large) ||
+        memcmp(managed_ptr, large, sizeof(large)) != 0)
+    {
+        PRINT_ERROR("zylib_dequeue_push_last() failed");
+        goto error;
+    }
+    zylib_dequeue_discard_last(dequeue);
+
+    /* Walking backwards looks up records in every chunk; even values were pushed first, so they come first */
+    if (!zylib_dequeue_cursor_last(dequeue, &cursor))
+    {
+        PRINT_ERROR("zylib_dequeue_cursor_last() failed");
+        goto error;
+    }
+    for (uint32_t i = n; i > 0; --i)
+    {
+        uint32_t value;
+        const uint32_t expected = i - 1 < n / 2 ? n - 2 - 2 * (i - 1) : 2 * (i - 1 - n / 2) + 1;
+        if (!zylib_dequeue_cursor_get(&cursor, &managed_ptr_size, &managed_ptr) || managed_ptr_size != sizeof(value))
+        {
+            PRINT_ERROR("zylib_dequeue_cursor_get() failed");
+            goto error;
+        }
+        memcpy(&value, managed_ptr, sizeof(value));
+        if (value != expected || zylib_dequeue_cursor_prev(&cursor) != (i > 1))
+        {
+            PRINT_ERROR("zylib_dequeue_cursor_prev() failed");
+            goto error;
+        }
+    }
+
+    /* Even values were pushed first and odd values last, so both ends are popped in decreasing order */
+    for (uint32_t i = n; i > 0; --i)
+    {
+        uint32_t value;
+        uint64_t size = 0;
+        if (!(i % 2 == 0 ? zylib_dequeue_release_last : zylib_dequeue_release_first)(dequeue, &size, &ptr) ||
+            size != sizeof(value))
+        {
+            PRINT_ERROR("release() failed");
+            goto error;
+        }
+        memcpy(&value, ptr, sizeof(value));
+        zylib_allocator_free(allocator, &ptr);
+        if (value != i - 1)
+        {
+            PRINT_ERROR("release() failed");
+            goto error;
+        }
+    }
+
+    if (!zylib_dequeue_is_empty(dequeue) || zylib_dequeue_peek_first(dequeue, &managed_ptr_size, &managed_ptr))
+    {
+        PRINT_ERROR("zylib_dequeue_is_empty() failed");
+        goto error;
+    }
+
+    ptr = large;
+    if (zylib_dequeue_adopt_last(dequeue, sizeof(large), &ptr) || ptr != large)
+    {
+        PRINT_ERROR("zylib_dequeue_adopt_last() failed");
+        goto error;
+    }
+    ptr = NULL;
+
+    r = 1;
+error:
+    if (ptr != NULL)
+    {
+        zylib_allocator_free(allocator, &ptr);
+    }
+    if (dequeue != NULL)
+    {
+        zylib_dequeue_destruct(&dequeue);
+    }
+    return r;
+}
+
+_Bool test_fixed()
+{
+    _Bool r = 0;
+
+    /* Elements are 16-byte handles, filled with their value */
+    uint8_t handles[100][16];
+    uint8_t popped[100][16];
+    zylib_dequeue_cursor_t cursor;
+    void *ptr = NULL;
+    const void *managed_ptr = NULL;
+    uint64_t managed_ptr_size = 0;
+
+    for (uint8_t i = 0; i < 100; ++i)
+    {
+        memset(handles[i], i, sizeof(handles[i]));
+    }
+
+    if (!zylib_dequeue_construct_fixed(&dequeue, allocator, sizeof(handles[0])))
+    {
+        PRINT_ERROR("zylib_dequeue_construct_fixed() failed");
+        goto error;
+    }
+
+    /* The dequeue holds handles 60 to 99, then 0 to 59, which wraps around its ring */
+    if (!zylib_dequeue_push_n_last(dequeue, 60, handles[0]) || !zylib_dequeue_push_n_first(dequeue, 40, handles[60]) ||
+        zylib_dequeue_size(dequeue) != 100)
+    {
+        PRINT_ERROR("push_n() failed");
+        goto error;
+    }
+
+    for (uint64_t i = 0; i < 100; ++i)
+    {
+        if (!zylib_dequeue_at(dequeue, i, &managed_ptr_size, &managed_ptr) || managed_ptr_size != sizeof(handles[0]) ||
+            memcmp(managed_ptr, handles[(i + 60) % 100], sizeof(handles[0])) != 0)
+        {
+            PRINT_ERROR("zylib_dequeue_at() failed");
+            goto error;
+        }
+    }
+
+    if (!zylib_dequeue_cursor_last(dequeue, &cursor) || !zylib_dequeue_cursor_prev(&cursor) ||
+        !zylib_dequeue_cursor_get(&cursor, &managed_ptr_size, &managed_ptr) ||
+        memcmp(managed_ptr, handles[58], sizeof(handles[0])) != 0)
+    {
+        PRINT_ERROR("zylib_dequeue_cursor_prev() failed");
+        goto error;
+    }
+
+    if (!zylib_dequeue_pop_n_first(dequeue, 50, popped[0]) ||
+        memcmp(popped[0], handles[60], 40 * sizeof(handles[0])) != 0 ||
+        memcmp(popped[40], handles[0], 10 * sizeof(handles[0])) != 0)
+    {
+        PRINT_ERROR("zylib_dequeue_pop_n_first() failed");
+        goto error;
+    }
+
+    if (zylib_dequeue_pop_n_last(dequeue, 51, popped[0]) || !zylib_dequeue_pop_n_last(dequeue, 50, popped[0]) ||
+        memcmp(popped[0], handles[10], 50 * sizeof(handles[0])) != 0 || !zylib_dequeue_is_empty(dequeue))
+    {
+        PRINT_ERROR("zylib_dequeue_pop_n_last() failed");
+        goto error;
+    }
+
+    /* Single elements must have the element size */
+    if (zylib_dequeue_push_last(dequeue, sizeof(handles[0]) - 1, handles[1]) ||
+        !zylib_dequeue_push_last(dequeue, sizeof(handles[0]), handles[1]) ||
+        !zylib_dequeue_push_first(dequeue, sizeof(handles[0]), handles[2]))
+    {
+        PRINT_ERROR("push() failed");
+        goto error;
+    }
+
+    if (!zylib_dequeue_release_last(dequeue, &managed_ptr_size, &ptr) || managed_ptr_size != sizeof(handles[0]) ||
+        memcmp(ptr, handles[1], sizeof(handles[0])) != 0)
+    {
+        PRINT_ERROR("zylib_dequeue_release_last() failed");
+        goto error;
+    }
+
+    zylib_dequeue_discard_first(dequeue);
+    if (!zylib_dequeue_is_empty(dequeue))
+    {
+        PRINT_ERROR("zylib_dequeue_discard_first() failed");
+        goto error;
+    }
+
+    r = 1;
+error:
+    if (ptr != NULL)
+    {
+        zylib_allocator_free(allocator, &ptr);
+    }
+    if (dequeue != NULL)
+    {
+        zylib_dequeue_destruct(&dequeue);
+    }
+    return r;
+}
+
+_Bool test_push_allocation_n()
+{
+    _Bool r = 0;
+
+    zylib_allocator_t *counting_allocator = NULL;
+    uint8_t data[1000] = {0};
+
+    if (!zylib_allocator_construct(&counting_allocator, counting_malloc, realloc, free))
+    {
+        PRINT_ERROR("zylib_allocator_construct() failed");
+        goto error;
+    }
+
+    if (!zylib_dequeue_construct(&dequeue, counting_allocator))
+    {
+        PRINT_ERROR("zylib_dequeue_construct() failed");
+        goto error;
+    }
+
+    /* Every node is allocated together with its memory region, whether it is stored inline or not */
+    for (uint64_t size = 1; size <= sizeof(data); size *= 2)
+    {
+        const size_t before_malloc_n = malloc_n;
+        if (!zylib_dequeue_push_last(dequeue, size, data) || malloc_n != before_malloc_n + 1)
+        {
+            PRINT_ERROR("zylib_dequeue_push_last() failed");
+            goto error;
+        }
+    }
+
+    while (!zylib_dequeue_is_empty(dequeue))
+    {
+        zylib_dequeue_discard_first(dequeue);
+    }
+
+    r = 1;
+error:
+    if (dequeue != NULL)
+    {
+        zylib_dequeue_destruct(&dequeue);
+    }
+    if (counting_allocator != NULL)
+    {
+        zylib_allocator_destruct(&counting_allocator);
+    }
+    return r;
+}
+
+_Bool test_dequeue(zylib_dequeue_construct_t construct)
+{
+    _Bool r = 0;
+
+    if (!construct(&dequeue, allocator))
+    {
+        PRINT_ERROR("construct() failed");
+        goto error;
+    }
+
+    if (!zylib_dequeue_is_empty(dequeue))
+    {
+        PRINT_ERROR("zylib_dequeue_is_empty() failed");
+        goto error;
+    }
+
+    if (!test_push_peek_discard_first())
+    {
+        PRINT_ERROR("test_push_peek_discard_first() failed");
+        goto error;
+    }
+
+    if (!test_push_peek_discard_last())
+    {
+        PRINT_ERROR("test_push_peek_discard_last() failed");
+        goto error;
+    }
+
+    if (!test_loop_push_peek_clear_first())
+    {
+        PRINT_ERROR("test_loop_push_peek_clear_first() failed");
+        goto error;
+    }
+
+    if (!test_loop_push_peek_clear_last())
+    {
+        PRINT_ERROR("test_loop_push_peek_clear_last() failed");
+        goto error;
+    }
+
+    /* Packed dequeues only hold copies of memory regions */
+    if (construct != zylib_dequeue_construct_packed && !test_adopt_release())
+    {
+        PRINT_ERROR("test_adopt_release() failed");
+        goto error;
+    }
+
+    if (!test_push_at())
+    {
+        PRINT_ERROR("test_push_at() failed");
+        goto error;
+    }
+
+    if (!test_cursor())
+    {
+        PRINT_ERROR("test_cursor() failed");
+        goto error;
+    }
+
+    if (!zylib_dequeue_is_empty(dequeue))
+    {
+        PRINT_ERROR("zylib_dequeue_is_empty() failed");
+        goto error;
+    }
+
+    r = 1;
+error:
+    if (dequeue != NULL)
+    {
+        zylib_dequeue_destruct(&dequeue);
+    }
+    return r;
+}
@@ -70,6 +70,8 @@ static inline _Bool test_loop_push_peek_clear_first();
 
 static inline _Bool test_loop_push_peek_clear_last();
 
+static inline _Bool test_push_rope();
+
 /*
  * Main
  */
@@ -130,6 +132,12 @@ int main()
         goto error;
     }
 
+    if (!test_push_rope())
+    {
+        PRINT_ERROR("test_push_rope() failed");
+        goto error;
+    }
+
     if (!zylib_error_is_empty(error))
     {
         PRINT_ERROR("zylib_dequeue_is_empty() failed");
@@ -302,3 +310,47 @@ _Bool test_loop_push_peek_clear_last()
 {
     return test_loop_push_peek_clear(zylib_error_push_first, zylib_error_peek_first);
 }
+
+_Bool test_push_rope()
+{
+    _Bool r = 0;
+
+    char auxiliary_data[1000];
+    zylib_rope_t *auxiliary = NULL;
+    const zylib_error_box_t *error_box = NULL;
+
+    memset(auxiliary_data, 'a', sizeof(auxiliary_data));
+
+    if (!zylib_rope_construct(&auxiliary, allocator, 64) ||
+        !zylib_rope_append(auxiliary, sizeof(auxiliary_data), auxiliary_data))
+    {
+        PRINT_ERROR("zylib_rope_append() failed");
+        goto error;
+    }
+
+    if (!zylib_error_push_rope_last(error, 1, __FILE__, __LINE__, __func__, &auxiliary) || auxiliary != NULL)
+    {
+        PRINT_ERROR("zylib_error_push_rope_last() failed");
+        goto error;
+    }
+
+    error_box = zylib_error_peek_last(error);
+    if (error_box == NULL || zylib_error_box_peek_error_code(error_box) != 1 ||
+        strcmp(zylib_error_box_peek_function_name(error_box), __func__) != 0 ||
+        zylib_error_box_peek_auxiliary_size(error_box) != sizeof(auxiliary_data) ||
+        memcmp(zylib_error_box_peek_auxiliary_data(error_box), auxiliary_data, sizeof(auxiliary_data)) != 0)
+    {
+        PRINT_ERROR("zylib_error_peek_last() failed");
+        goto error;
+    }
+
+    zylib_error_discard_last(error);
+
+    r = 1;
+error:
+    if (auxiliary != NULL)
+    {
+        zylib_rope_destruct(&auxiliary);
+    }
+    return r;
+}
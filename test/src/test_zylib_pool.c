@@ -0,0 +1,410 @@
+/*
+ * Copyright 2023 Alexandre Fernandez <alex@fernandezfamily.email>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "zylib_logger.h"
+#include "zylib_pool.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <threads.h>
+
+#define PRINT_ERROR(format) ZYLIB_LOGGER_ERROR(log, format)
+
+#define OBJECT_N (1000U)
+#define THREAD_N (4U)
+
+typedef struct remote_test_s
+{
+    zylib_pool_t *pool;
+    void **ptr;
+    size_t n;
+} remote_test_t;
+
+static zylib_allocator_t *allocator = NULL;
+static zylib_logger_t *log = NULL;
+
+static inline _Bool logger_filter(zylib_logger_severity_t severity)
+{
+    (void)(severity);
+    return 1;
+}
+
+static inline _Bool test_pool(size_t size);
+static inline _Bool test_pool_free_remote(size_t size);
+static inline _Bool test_pool_trim();
+
+int main()
+{
+    int r = EXIT_FAILURE;
+
+    if (!zylib_allocator_construct(&allocator, malloc, realloc, free))
+    {
+        fprintf(stderr, "zylib_allocator_construct() failed\n");
+        goto error;
+    }
+
+    if (!zylib_logger_construct(&log, allocator, stderr, ZYLIB_LOGGER_FORMAT_PLAINTEXT, logger_filter))
+    {
+        fprintf(stderr, "zylib_logger_construct() failed\n");
+        goto error;
+    }
+
+    /*
+     * TESTS
+     */
+
+    if (!test_pool(1))
+    {
+        PRINT_ERROR("test_pool() failed");
+        goto error;
+    }
+
+    if (!test_pool((size_t)(rand() % 100 + 1)))
+    {
+        PRINT_ERROR("test_pool() failed");
+        goto error;
+    }
+
+    if (!test_pool(5000))
+    {
+        PRINT_ERROR("test_pool() failed");
+        goto error;
+    }
+
+    if (!test_pool_free_remote(sizeof(uint64_t)))
+    {
+        PRINT_ERROR("test_pool_free_remote() failed");
+        goto error;
+    }
+
+    if (!test_pool_trim())
+    {
+        PRINT_ERROR("test_pool_trim() failed");
+        goto error;
+    }
+
+    r = EXIT_SUCCESS;
+error:
+    if (log != NULL)
+    {
+        zylib_logger_destruct(&log);
+    }
+    if (allocator != NULL)
+    {
+        zylib_allocator_destruct(&allocator);
+    }
+    return r;
+}
+
+_Bool test_pool(size_t size)
+{
+    _Bool r = 0;
+    zylib_pool_t *pool = NULL;
+    void *ptr[OBJECT_N] = {NULL};
+    void *freed;
+
+    if (!zylib_pool_construct(&pool, allocator, size))
+    {
+        PRINT_ERROR("zylib_pool_construct() failed");
+        goto error;
+    }
+
+    if (zylib_pool_size(pool) < size || zylib_pool_size(pool) % _Alignof(max_align_t) != 0)
+    {
+        PRINT_ERROR("zylib_pool_size() failed");
+        goto error;
+    }
+
+    for (size_t i = 0; i < OBJECT_N; ++i)
+    {
+        if (!zylib_pool_malloc(pool, &ptr[i]) || (uintptr_t)ptr[i] % _Alignof(max_align_t) != 0)
+        {
+            PRINT_ERROR("zylib_pool_malloc() failed");
+            goto error;
+        }
+        memset(ptr[i], (int)(i % 256), size);
+    }
+
+    /* Objects must not overlap */
+    for (size_t i = 0; i < OBJECT_N; ++i)
+    {
+        for (size_t j = 0; j < size; ++j)
+        {
+            if (((const uint8_t *)ptr[i])[j] != i % 256)
+            {
+                PRINT_ERROR("zylib_pool_malloc() failed");
+                goto error;
+            }
+        }
+    }
+
+    /* The most recently freed object is reused first */
+    freed = ptr[OBJECT_N / 2];
+    zylib_pool_free(pool, &ptr[OBJECT_N / 2]);
+
+    if (ptr[OBJECT_N / 2] != NULL || !zylib_pool_malloc(pool, &ptr[OBJECT_N / 2]) || ptr[OBJECT_N / 2] != freed)
+    {
+        PRINT_ERROR("zylib_pool_free() failed");
+        goto error;
+    }
+
+    for (size_t i = 0; i < OBJECT_N; i += 2)
+    {
+        zylib_pool_free(pool, &ptr[i]);
+    }
+
+    /* Trimming keeps the slabs that still hold an object */
+    if (zylib_pool_trim(pool))
+    {
+        PRINT_ERROR("zylib_pool_trim() failed");
+        goto error;
+    }
+    for (size_t i = 1; i < OBJECT_N; i += 2)
+    {
+        for (size_t j = 0; j < size; ++j)
+        {
+            if (((const uint8_t *)ptr[i])[j] != i % 256)
+            {
+                PRINT_ERROR("zylib_pool_trim() failed");
+                goto error;
+            }
+        }
+    }
+
+    for (size_t i = 1; i < OBJECT_N; i += 2)
+    {
+        zylib_pool_free(pool, &ptr[i]);
+    }
+
+    if (!zylib_pool_trim(pool) || !zylib_pool_malloc(pool, &ptr[0]))
+    {
+        PRINT_ERROR("zylib_pool_trim() failed");
+        goto error;
+    }
+    memset(ptr[0], 1, size);
+
+    r = 1;
+error:
+    if (pool != NULL)
+    {
+        zylib_pool_destruct(&pool);
+    }
+    return r;
+}
+
+static int remote_test_worker(void *arg)
+{
+    const remote_test_t *const test = arg;
+
+    for (size_t i = 0; i < test->n; ++i)
+    {
+        zylib_pool_free_remote(test->pool, &test->ptr[i]);
+    }
+    return 0;
+}
+
+_Bool test_pool_free_remote(size_t size)
+{
+    _Bool r = 0;
+    zylib_pool_t *pool = NULL;
+    void *ptr[OBJECT_N] = {NULL};
+    remote_test_t test[THREAD_N];
+    thrd_t thread[THREAD_N];
+
+    if (!zylib_pool_construct(&pool, allocator, size))
+    {
+        PRINT_ERROR("zylib_pool_construct() failed");
+        goto error;
+    }
+
+    /* Objects allocated by the owner are freed concurrently by other threads, then reclaimed by the owner */
+    for (size_t round = 0; round < 2; ++round)
+    {
+        for (size_t i = 0; i < OBJECT_N; ++i)
+        {
+            if (!zylib_pool_malloc(pool, &ptr[i]))
+            {
+                PRINT_ERROR("zylib_pool_malloc() failed");
+                goto error;
+            }
+            memset(ptr[i], (int)(i % 256), size);
+        }
+
+        for (size_t i = 0; i < THREAD_N; ++i)
+        {
+            test[i].pool = pool;
+            test[i].ptr = &ptr[i * (OBJECT_N / THREAD_N)];
+            test[i].n = OBJECT_N / THREAD_N;
+            if (thrd_create(&thread[i], remote_test_worker, &test[i]) != thrd_success)
+            {
+                PRINT_ERROR("thrd_create() failed");
+                goto error;
+            }
+        }
+
+        for (size_t i = 0; i < THREAD_N; ++i)
+        {
+            thrd_join(thread[i], NULL);
+        }
+
+        for (size_t i = 0; i < OBJECT_N; ++i)
+        {
+            if (ptr[i] != NULL)
+            {
+                PRINT_ERROR("zylib_pool_free_remote() failed");
+                goto error;
+            }
+        }
+    }
+
+    if (!zylib_pool_trim(pool))
+    {
+        PRINT_ERROR("zylib_pool_trim() failed");
+        goto error;
+    }
+
+    r = 1;
+error:
+    if (pool != NULL)
+    {
+        zylib_pool_destruct(&pool);
+    }
+    return r;
+}
+
+static inline uint64_t trim_test_live_bytes(const zylib_allocator_t *stats)
+{
+    zylib_allocator_stats_t snapshot;
+    return zylib_allocator_stats(stats, &snapshot) ? snapshot.live_bytes : 0;
+}
+
+_Bool test_pool_trim()
+{
+    static const struct timespec period = {.tv_sec = 0, .tv_nsec = 60000000};
+    _Bool r = 0;
+    zylib_allocator_t *stats = NULL;
+    zylib_allocator_t *size_class = NULL;
+    zylib_pool_t *pool = NULL;
+    zylib_pool_t *large_pool = NULL;
+    void *ptr[OBJECT_N] = {NULL};
+    void *large_ptr[3] = {NULL, NULL, NULL};
+    uint64_t live_bytes;
+
+    /* Slabs larger than a size class are allocated straight from the stats allocator object */
+    if (!zylib_allocator_construct_stats(&stats, allocator) ||
+        !zylib_allocator_construct_size_class(&size_class, stats) ||
+        !zylib_pool_construct(&pool, stats, sizeof(uint64_t)) ||
+        !zylib_pool_construct(&large_pool, size_class, 9000))
+    {
+        PRINT_ERROR("zylib_pool_construct() failed");
+        goto error;
+    }
+
+    for (size_t i = 0; i < OBJECT_N; ++i)
+    {
+        if (!zylib_pool_malloc(pool, &ptr[i]))
+        {
+            PRINT_ERROR("zylib_pool_malloc() failed");
+            goto error;
+        }
+    }
+
+    /* Trimming returns the slabs emptied while other slabs are still in use */
+    for (size_t i = 0; i < OBJECT_N / 2; ++i)
+    {
+        zylib_pool_free(pool, &ptr[i]);
+    }
+    live_bytes = trim_test_live_bytes(stats);
+    if (zylib_pool_trim(pool) || trim_test_live_bytes(stats) >= live_bytes)
+    {
+        PRINT_ERROR("zylib_pool_trim() failed");
+        goto error;
+    }
+    for (size_t i = 0; i < OBJECT_N / 2; ++i)
+    {
+        if (!zylib_pool_malloc(pool, &ptr[i]))
+        {
+            PRINT_ERROR("zylib_pool_malloc() failed");
+            goto error;
+        }
+        memset(ptr[i], 1, sizeof(uint64_t));
+    }
+
+    /* Decay follows the allocator object, and returns the slabs left empty for a whole period */
+    if (!zylib_allocator_set_decay(size_class, 50))
+    {
+        PRINT_ERROR("zylib_allocator_set_decay() failed");
+        goto error;
+    }
+    for (size_t i = 0; i < 3; ++i)
+    {
+        if (!zylib_pool_malloc(large_pool, &large_ptr[i]))
+        {
+            PRINT_ERROR("zylib_pool_malloc() failed");
+            goto error;
+        }
+    }
+    zylib_pool_free(large_pool, &large_ptr[0]);
+    live_bytes = trim_test_live_bytes(stats);
+    if (thrd_sleep(&period, NULL) != 0)
+    {
+        PRINT_ERROR("thrd_sleep() failed");
+        goto error;
+    }
+    zylib_pool_free(large_pool, &large_ptr[1]);
+    if (trim_test_live_bytes(stats) >= live_bytes)
+    {
+        PRINT_ERROR("zylib_allocator_set_decay() failed");
+        goto error;
+    }
+
+    /* Without decay, slabs are retained until trimmed */
+    zylib_pool_set_decay(large_pool, 0);
+    live_bytes = trim_test_live_bytes(stats);
+    zylib_pool_free(large_pool, &large_ptr[2]);
+    if (trim_test_live_bytes(stats) != live_bytes || !zylib_pool_trim(large_pool) ||
+        trim_test_live_bytes(stats) >= live_bytes)
+    {
+        PRINT_ERROR("zylib_pool_set_decay() failed");
+        goto error;
+    }
+
+    r = 1;
+error:
+    for (size_t i = 0; i < 3; ++i)
+    {
+        if (large_ptr[i] != NULL)
+        {
+            zylib_pool_free(large_pool, &large_ptr[i]);
+        }
+    }
+    if (large_pool != NULL)
+    {
+        zylib_pool_destruct(&large_pool);
+    }
+    if (pool != NULL)
+    {
+        zylib_pool_destruct(&pool);
+    }
+    if (size_class != NULL)
+    {
+        zylib_allocator_destruct(&size_class);
+    }
+    if (stats != NULL)
+    {
+        zylib_allocator_destruct(&stats);
+    }
+    return r;
+}
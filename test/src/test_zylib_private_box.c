@@ -24,6 +24,7 @@ static zylib_allocator_t *allocator = NULL;
 static zylib_logger_t *log = NULL;
 
 static inline _Bool test_box();
+static inline _Bool test_box_pooled();
 
 static inline _Bool logger_filter(zylib_logger_severity_t severity)
 {
@@ -57,6 +58,12 @@ int main()
         goto error;
     }
 
+    if (!test_box_pooled())
+    {
+        PRINT_ERROR("test_box_pooled() failed");
+        goto error;
+    }
+
     r = EXIT_SUCCESS;
 error:
     if (log != NULL)
@@ -118,7 +125,7 @@ _Bool test_box()
         goto error;
     }
 
-    if (!zylib_private_box_append(box, size_2, data_2))
+    if (!zylib_private_box_append(&box, size_2, data_2))
     {
         PRINT_ERROR("zylib_private_box_append() failed");
         goto error;
@@ -160,3 +167,84 @@ error:
     }
     return r;
 }
+
+_Bool test_box_pooled()
+{
+    _Bool r = 0;
+
+    const uint64_t step = ZYLIB_PRIVATE_BOX_POOL_CAPACITY / 2;
+    uint8_t data[2 * ZYLIB_PRIVATE_BOX_POOL_CAPACITY];
+    uint64_t size = 0;
+    const uint8_t *managed_data = NULL;
+
+    zylib_private_pool_t *pool = NULL;
+    zylib_private_box_t *box = NULL;
+
+    for (size_t i = 0; i < sizeof(data); ++i)
+    {
+        data[i] = (uint8_t)i;
+    }
+
+    if (!zylib_private_box_construct_pool(&pool, (const zylib_private_allocator_t *)allocator))
+    {
+        PRINT_ERROR("zylib_private_box_construct_pool() failed");
+        goto error;
+    }
+
+    if (!zylib_private_box_construct_pooled(&box, pool, (const zylib_private_allocator_t *)allocator, 1, data))
+    {
+        PRINT_ERROR("zylib_private_box_construct_pooled() failed");
+        goto error;
+    }
+
+    /* The box stays in its pool object until it is full, then moves to the allocator object */
+    for (size = 1; size < 3 * ZYLIB_PRIVATE_BOX_POOL_CAPACITY; size += step)
+    {
+        if (!zylib_private_box_append(&box, step, &data[size % ZYLIB_PRIVATE_BOX_POOL_CAPACITY]))
+        {
+            PRINT_ERROR("zylib_private_box_append() failed");
+            goto error;
+        }
+    }
+
+    if (zylib_private_box_peek_size(box) != size)
+    {
+        PRINT_ERROR("zylib_private_box_peek_size() failed");
+        goto error;
+    }
+
+    managed_data = zylib_private_box_peek_data(box);
+    if (managed_data[0] != data[0])
+    {
+        PRINT_ERROR("zylib_private_box_peek_data() failed");
+        goto error;
+    }
+    for (uint64_t i = 1; i < size; i += step)
+    {
+        if (memcmp(&managed_data[i], &data[i % ZYLIB_PRIVATE_BOX_POOL_CAPACITY], step) != 0)
+        {
+            PRINT_ERROR("zylib_private_box_peek_data() failed");
+            goto error;
+        }
+    }
+
+    zylib_private_box_destruct(&box);
+    if (!zylib_private_box_construct_pooled(&box, pool, (const zylib_private_allocator_t *)allocator,
+                                            ZYLIB_PRIVATE_BOX_POOL_CAPACITY + 1, data))
+    {
+        PRINT_ERROR("zylib_private_box_construct_pooled() failed");
+        goto error;
+    }
+
+    r = 1;
+error:
+    if (box != NULL)
+    {
+        zylib_private_box_destruct(&box);
+    }
+    if (pool != NULL)
+    {
+        zylib_private_pool_destruct(&pool);
+    }
+    return r;
+}
@@ -0,0 +1,192 @@
+/*
+ * Copyright 2023 Alexandre Fernandez <alex@fernandezfamily.email>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "zylib_dequeue.h"
+#include "zylib_logger.h"
+#include "zylib_rope.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PRINT_ERROR(format) ZYLIB_LOGGER_ERROR(log, format)
+
+#define CHUNK_SIZE (100U)
+#define DATA_SIZE (1000U)
+
+static zylib_allocator_t *allocator = NULL;
+static zylib_logger_t *log = NULL;
+
+static inline _Bool logger_filter(zylib_logger_severity_t severity)
+{
+    (void)(severity);
+    return 1;
+}
+
+static inline _Bool test_rope();
+
+int main()
+{
+    int r = EXIT_FAILURE;
+
+    if (!zylib_allocator_construct(&allocator, malloc, realloc, free))
+    {
+        fprintf(stderr, "zylib_allocator_construct() failed\n");
+        goto error;
+    }
+
+    if (!zylib_logger_construct(&log, allocator, stderr, ZYLIB_LOGGER_FORMAT_PLAINTEXT, logger_filter))
+    {
+        fprintf(stderr, "zylib_logger_construct() failed\n");
+        goto error;
+    }
+
+    /*
+     * TESTS
+     */
+
+    if (!test_rope())
+    {
+        PRINT_ERROR("test_rope() failed");
+        goto error;
+    }
+
+    r = EXIT_SUCCESS;
+error:
+    if (log != NULL)
+    {
+        zylib_logger_destruct(&log);
+    }
+    if (allocator != NULL)
+    {
+        zylib_allocator_destruct(&allocator);
+    }
+    return r;
+}
+
+_Bool test_rope()
+{
+    _Bool r = 0;
+
+    uint8_t data[DATA_SIZE];
+    uint64_t size = 0;
+    uint64_t offset = 0;
+    size_t segment_n = 0;
+    const void *iterator = NULL;
+    const void *segment = NULL;
+    void *released = NULL;
+    const void *flattened = NULL;
+
+    zylib_rope_t *rope = NULL;
+    const zylib_rope_t *managed_rope = NULL;
+    zylib_dequeue_t *dequeue = NULL;
+
+    for (size_t i = 0; i < sizeof(data); ++i)
+    {
+        data[i] = (uint8_t)(i * 3);
+    }
+
+    if (!zylib_rope_construct(&rope, allocator, CHUNK_SIZE) || zylib_rope_size(rope) != 0 ||
+        zylib_rope_next(rope, &iterator, &size, &segment))
+    {
+        PRINT_ERROR("zylib_rope_construct() failed");
+        goto error;
+    }
+
+    /* Appends that straddle chunk boundaries */
+    for (size_t i = 0; i < sizeof(data); i += 30)
+    {
+        const size_t n = sizeof(data) - i < 30 ? sizeof(data) - i : 30;
+        if (!zylib_rope_append(rope, n, &data[i]))
+        {
+            PRINT_ERROR("zylib_rope_append() failed");
+            goto error;
+        }
+    }
+
+    if (zylib_rope_size(rope) != sizeof(data))
+    {
+        PRINT_ERROR("zylib_rope_size() failed");
+        goto error;
+    }
+
+    while (zylib_rope_next(rope, &iterator, &size, &segment))
+    {
+        if (size > CHUNK_SIZE || memcmp(segment, &data[offset], size) != 0)
+        {
+            PRINT_ERROR("zylib_rope_next() failed");
+            goto error;
+        }
+        offset += size;
+        ++segment_n;
+    }
+
+    if (offset != sizeof(data) || segment_n != DATA_SIZE / CHUNK_SIZE)
+    {
+        PRINT_ERROR("zylib_rope_next() failed");
+        goto error;
+    }
+
+    if (!zylib_dequeue_construct(&dequeue, allocator) || !zylib_dequeue_push_rope_last(dequeue, &rope) ||
+        rope != NULL)
+    {
+        PRINT_ERROR("zylib_dequeue_push_rope_last() failed");
+        goto error;
+    }
+
+    if (!zylib_dequeue_peek_rope_last(dequeue, &managed_rope) || zylib_rope_size(managed_rope) != sizeof(data))
+    {
+        PRINT_ERROR("zylib_dequeue_peek_rope_last() failed");
+        goto error;
+    }
+
+    /* The rope is flattened on insertion, so retrieving it returns its only segment */
+    iterator = NULL;
+    if (!zylib_rope_next(managed_rope, &iterator, &size, &flattened) || size != sizeof(data) ||
+        zylib_rope_next(managed_rope, &iterator, &size, &segment))
+    {
+        PRINT_ERROR("zylib_rope_next() failed");
+        goto error;
+    }
+
+    if (!zylib_dequeue_peek_first(dequeue, &size, &segment) || size != sizeof(data) || segment != flattened ||
+        memcmp(segment, data, sizeof(data)) != 0)
+    {
+        PRINT_ERROR("zylib_dequeue_peek_first() failed");
+        goto error;
+    }
+
+    if (!zylib_dequeue_release_last(dequeue, &size, &released) || size != sizeof(data) ||
+        memcmp(released, data, sizeof(data)) != 0 || !zylib_dequeue_is_empty(dequeue))
+    {
+        PRINT_ERROR("zylib_dequeue_release_last() failed");
+        goto error;
+    }
+
+    r = 1;
+error:
+    if (released != NULL)
+    {
+        zylib_allocator_free(allocator, &released);
+    }
+    if (dequeue != NULL)
+    {
+        zylib_dequeue_destruct(&dequeue);
+    }
+    if (rope != NULL)
+    {
+        zylib_rope_destruct(&rope);
+    }
+    return r;
+}
@@ -0,0 +1,220 @@
+/*
+ * Copyright 2023 Alexandre Fernandez <alex@fernandezfamily.email>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "zylib_dequeue.h"
+#include "zylib_logger.h"
+#include "zylib_shared_box.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <threads.h>
+
+#define PRINT_ERROR(format) ZYLIB_LOGGER_ERROR(log, format)
+
+#define DATA_SIZE (1000U)
+#define DEQUEUE_N (4U)
+
+static zylib_allocator_t *allocator = NULL;
+static zylib_logger_t *log = NULL;
+
+static inline _Bool logger_filter(zylib_logger_severity_t severity)
+{
+    (void)(severity);
+    return 1;
+}
+
+static inline _Bool test_shared_box();
+
+int main()
+{
+    int r = EXIT_FAILURE;
+
+    if (!zylib_allocator_construct(&allocator, malloc, realloc, free))
+    {
+        fprintf(stderr, "zylib_allocator_construct() failed\n");
+        goto error;
+    }
+
+    if (!zylib_logger_construct(&log, allocator, stderr, ZYLIB_LOGGER_FORMAT_PLAINTEXT, logger_filter))
+    {
+        fprintf(stderr, "zylib_logger_construct() failed\n");
+        goto error;
+    }
+
+    /*
+     * TESTS
+     */
+
+    if (!test_shared_box())
+    {
+        PRINT_ERROR("test_shared_box() failed");
+        goto error;
+    }
+
+    r = EXIT_SUCCESS;
+error:
+    if (log != NULL)
+    {
+        zylib_logger_destruct(&log);
+    }
+    if (allocator != NULL)
+    {
+        zylib_allocator_destruct(&allocator);
+    }
+    return r;
+}
+
+static int shared_box_destruct(void *arg)
+{
+    zylib_dequeue_destruct((zylib_dequeue_t **)arg);
+    return 0;
+}
+
+_Bool test_shared_box()
+{
+    _Bool r = 0;
+
+    uint8_t data[DATA_SIZE];
+    uint64_t size = 0;
+    const void *managed_data = NULL;
+
+    zylib_shared_box_t *box = NULL;
+    zylib_shared_box_t *slice = NULL;
+    zylib_shared_box_t *subslice = NULL;
+    zylib_dequeue_t *dequeues[DEQUEUE_N] = {NULL};
+    thrd_t threads[DEQUEUE_N];
+    size_t thread_n = 0;
+
+    for (size_t i = 0; i < sizeof(data); ++i)
+    {
+        data[i] = (uint8_t)(i * 7);
+    }
+
+    if (!zylib_shared_box_construct(&box, allocator, sizeof(data), data))
+    {
+        PRINT_ERROR("zylib_shared_box_construct() failed");
+        goto error;
+    }
+
+    if (zylib_shared_box_size(box) != sizeof(data) || memcmp(zylib_shared_box_data(box), data, sizeof(data)) != 0)
+    {
+        PRINT_ERROR("zylib_shared_box_data() failed");
+        goto error;
+    }
+
+    if (zylib_shared_box_slice(&slice, box, sizeof(data) - 1, 2))
+    {
+        PRINT_ERROR("zylib_shared_box_slice() failed");
+        goto error;
+    }
+
+    if (!zylib_shared_box_slice(&slice, box, 100, 500) || zylib_shared_box_size(slice) != 500 ||
+        zylib_shared_box_data(slice) != &((const uint8_t *)zylib_shared_box_data(box))[100])
+    {
+        PRINT_ERROR("zylib_shared_box_slice() failed");
+        goto error;
+    }
+
+    if (!zylib_shared_box_slice(&subslice, slice, 50, 10) ||
+        memcmp(zylib_shared_box_data(subslice), &data[150], 10) != 0)
+    {
+        PRINT_ERROR("zylib_shared_box_slice() failed");
+        goto error;
+    }
+
+    /* Fan the box and its views out to every dequeue, then drop the references held by the test */
+    for (size_t i = 0; i < DEQUEUE_N; ++i)
+    {
+        if (!zylib_dequeue_construct(&dequeues[i], allocator) || !zylib_dequeue_push_shared_last(dequeues[i], box) ||
+            !zylib_dequeue_push_shared_last(dequeues[i], slice) ||
+            !zylib_dequeue_push_shared_first(dequeues[i], subslice))
+        {
+            PRINT_ERROR("zylib_dequeue_push_shared_last() failed");
+            goto error;
+        }
+    }
+
+    zylib_shared_box_destruct(&box);
+    zylib_shared_box_destruct(&slice);
+    zylib_shared_box_destruct(&subslice);
+    if (box != NULL || slice != NULL || subslice != NULL)
+    {
+        PRINT_ERROR("zylib_shared_box_destruct() failed");
+        goto error;
+    }
+
+    for (size_t i = 0; i < DEQUEUE_N; ++i)
+    {
+        if (!zylib_dequeue_peek_first(dequeues[i], &size, &managed_data) || size != 10 ||
+            memcmp(managed_data, &data[150], 10) != 0)
+        {
+            PRINT_ERROR("zylib_dequeue_peek_first() failed");
+            goto error;
+        }
+
+        if (!zylib_dequeue_peek_last(dequeues[i], &size, &managed_data) || size != 500 ||
+            memcmp(managed_data, &data[100], 500) != 0)
+        {
+            PRINT_ERROR("zylib_dequeue_peek_last() failed");
+            goto error;
+        }
+    }
+
+    /* A shared memory region is copied out on release */
+    if (!zylib_dequeue_release_first(dequeues[0], &size, (void **)&managed_data) || size != 10 ||
+        memcmp(managed_data, &data[150], 10) != 0)
+    {
+        PRINT_ERROR("zylib_dequeue_release_first() failed");
+        goto error;
+    }
+    zylib_allocator_free(allocator, (void **)&managed_data);
+
+    /* The last references are released concurrently */
+    for (; thread_n < DEQUEUE_N; ++thread_n)
+    {
+        if (thrd_create(&threads[thread_n], shared_box_destruct, &dequeues[thread_n]) != thrd_success)
+        {
+            PRINT_ERROR("thrd_create() failed");
+            goto error;
+        }
+    }
+
+    r = 1;
+error:
+    for (size_t i = 0; i < thread_n; ++i)
+    {
+        thrd_join(threads[i], NULL);
+    }
+    for (size_t i = 0; i < DEQUEUE_N; ++i)
+    {
+        if (dequeues[i] != NULL)
+        {
+            zylib_dequeue_destruct(&dequeues[i]);
+        }
+    }
+    if (subslice != NULL)
+    {
+        zylib_shared_box_destruct(&subslice);
+    }
+    if (slice != NULL)
+    {
+        zylib_shared_box_destruct(&slice);
+    }
+    if (box != NULL)
+    {
+        zylib_shared_box_destruct(&box);
+    }
+    return r;
+}